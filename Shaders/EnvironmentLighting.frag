@@ -0,0 +1,49 @@
+#version 330 core
+
+in vec3 position;
+in vec3 normal;
+in vec2 texCoords;
+
+uniform sampler2D diffuseTexture1;
+// Prefiltered by EnvironmentMap, level i has roughness i / environmentMaxLod.
+uniform samplerCube environmentMap;
+uniform float environmentMaxLod;
+// Diffuse irradiance(already divided by pi) in SH9, see EnvironmentMap.h.
+uniform vec3 environmentSH[9];
+uniform vec3 cameraPos;
+uniform float roughness;
+
+out vec4 FragColor;
+
+vec3 EvaluateSH(vec3 n)
+{
+    return environmentSH[0] * 0.282095 +
+           environmentSH[1] * 0.488603 * n.y +
+           environmentSH[2] * 0.488603 * n.z +
+           environmentSH[3] * 0.488603 * n.x +
+           environmentSH[4] * 1.092548 * n.x * n.y +
+           environmentSH[5] * 1.092548 * n.y * n.z +
+           environmentSH[6] * 0.315392 * (3.0 * n.z * n.z - 1.0) +
+           environmentSH[7] * 1.092548 * n.x * n.z +
+           environmentSH[8] * 0.546274 * (n.x * n.x - n.y * n.y);
+}
+
+void main()
+{
+    vec3 N = normalize(normal);
+    vec3 V = normalize(cameraPos - position);
+    vec3 R = reflect(-V, N);
+
+    vec3 albedo = texture(diffuseTexture1, texCoords).rgb;
+    vec3 diffuse = albedo * max(EvaluateSH(N), vec3(0.0));
+    vec3 specular = textureLod(environmentMap, R, 
+        roughness * environmentMaxLod).rgb;
+
+    // Schlick fresnel with F0 of common dielectric.
+    float fresnel = 0.04 + 0.96 * pow(1.0 - max(dot(N, V), 0.0), 5.0);
+    vec3 color = mix(diffuse, specular, fresnel);
+
+    // Reinhard tone mapping since environment is HDR.
+    FragColor = vec4(color / (color + vec3(1.0)), 1.0);
+    return;
+}
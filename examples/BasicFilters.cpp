@@ -54,19 +54,25 @@ int main()
 		.wrapS = Core::TextureParamConfig::WrapType::ClampToEdge,
 		.wrapT = Core::TextureParamConfig::WrapType::ClampToEdge
 	};	// To eliminate top grey shadow in filter.
-	Core::Framebuffer buffer{ width, height, depthConfig };
 
-	auto quadOnScreen = Core::Quad::GetBasicTriRenderModel();
-	mainWindow.Register(
-		[&normalShader, &sucroseModel, &floor, &buffer, &frontCamera, &mainWindow,
-		 &depthConfig, near, far]() {
-			buffer.Clear();
+	// The scene buffer is transient and sized by the screen, so the graph
+	// reallocates it when the window is resized.
+	Core::RenderGraph renderGraph;
+	auto screen = renderGraph.Import("screen");
+	Core::RenderGraph::ResourceHandle sceneBuffer;
+	renderGraph.AddPass("scene",
+		[&sceneBuffer, &depthConfig](Core::RenderGraph::PassBuilder& builder) {
+			sceneBuffer = builder.Create("scene buffer", { .depthConfig = depthConfig });
+		},
+		[&sceneBuffer, &normalShader, &sucroseModel, &floor, &frontCamera,
+		 near, far](const Core::RenderGraph::PassContext& context) {
+			using enum Core::Framebuffer::LoadAction;
+			auto& buffer = *context.GetFramebuffer(sceneBuffer);
+			context.UseAsRenderTarget(sceneBuffer);
+			buffer.BeginPass({ .depth = { .load = Clear }, .colors = { { .load = Clear } } });
 
 			normalShader.Activate();
-			const auto [width, height] = mainWindow.GetWidthAndHeight();
-			if (width != buffer.GetWidth() || height != buffer.GetHeight())
-				buffer = Core::Framebuffer{ width, height, depthConfig };
-
+			const auto [width, height] = context.GetSize(sceneBuffer);
 			SetMVP(static_cast<float>(width), static_cast<float>(height),
 				near, far, sucroseModel, frontCamera, normalShader);
 
@@ -77,6 +83,7 @@ int main()
 			floor.Draw(normalShader, buffer);
 		});
 
+	auto quadOnScreen = Core::Quad::GetBasicTriRenderModel();
 	int option = 0;
 	float pixelSigma = sqrt(0.5f), depthSigma = pixelSigma, colorSigma = pixelSigma;
 	mainWindow.Register(
@@ -114,24 +121,37 @@ int main()
 		pathsSection("quad_vertex_shader_dir"),
         pathsSection("quad_fragment_shader_dir")
 	};
-	mainWindow.Register([&quadOnScreen, &buffer, &basicQuadShader, &option,
-		&pixelSigma, &depthSigma, &colorSigma]() {
-		glDepthMask(0);
-		basicQuadShader.Activate();
-		basicQuadShader.SetInt("filterOption", option);
-		basicQuadShader.SetFloat("xOffset", 1.0f / buffer.GetWidth());
-		basicQuadShader.SetFloat("yOffset", 1.0f / buffer.GetHeight());
-		basicQuadShader.SetFloat("pixelSigmaSqr", pixelSigma * pixelSigma);
-		basicQuadShader.SetFloat("depthSigmaSqr", depthSigma * depthSigma);
-		basicQuadShader.SetFloat("colorSigmaSqr", colorSigma * colorSigma);
-		quadOnScreen.Draw(basicQuadShader,
-			[&buffer](int textureBeginID, const Core::Shader& shader) {
-				Core::Texture::BindTextureOnShader(textureBeginID, "colorTexture",
-					shader, buffer.GetColorBuffer());
-				Core::Texture::BindTextureOnShader(textureBeginID + 1, "depthTexture",
-					shader, buffer.GetDepthBuffer());
-			}, nullptr);
-		glDepthMask(0xFF);
+	renderGraph.AddPass("filter",
+		[&sceneBuffer, &screen](Core::RenderGraph::PassBuilder& builder) {
+			builder.Read(sceneBuffer);
+			builder.Write(screen);
+		},
+		[&sceneBuffer, &screen, &quadOnScreen, &basicQuadShader, &option,
+		 &pixelSigma, &depthSigma, &colorSigma](const Core::RenderGraph::PassContext& context) {
+			context.UseAsRenderTarget(screen);
+			auto& buffer = *context.GetFramebuffer(sceneBuffer);
+			glDepthMask(0);
+			basicQuadShader.Activate();
+			basicQuadShader.SetInt("filterOption", option);
+			basicQuadShader.SetFloat("xOffset", 1.0f / buffer.GetWidth());
+			basicQuadShader.SetFloat("yOffset", 1.0f / buffer.GetHeight());
+			basicQuadShader.SetFloat("pixelSigmaSqr", pixelSigma * pixelSigma);
+			basicQuadShader.SetFloat("depthSigmaSqr", depthSigma * depthSigma);
+			basicQuadShader.SetFloat("colorSigmaSqr", colorSigma * colorSigma);
+			quadOnScreen.Draw(basicQuadShader,
+				[&buffer](int textureBeginID, const Core::Shader& shader) {
+					Core::Texture::BindTextureOnShader(textureBeginID, "colorTexture",
+						shader, buffer.GetColorBuffer());
+					Core::Texture::BindTextureOnShader(textureBeginID + 1, "depthTexture",
+						shader, buffer.GetDepthBuffer());
+				}, nullptr);
+			glDepthMask(0xFF);
+		});
+
+	mainWindow.Register([&renderGraph, &mainWindow]() {
+		const auto [width, height] = mainWindow.GetWidthAndHeight();
+		renderGraph.SetScreenSize(width, height);
+		renderGraph.Execute();
 	});
 	mainWindow.MainLoop({ 0.0, 0.0, 0.0, 0.0 });
 	return 0;
@@ -26,15 +26,25 @@ int main()
 	};
 
 	Core::Camera frontCamera{ { 0, 10, 35}, {0, 1, 0}, {0, 0, -1} };
-	std::vector<Core::Framebuffer::ConfigType> vec(4,
-		Core::Framebuffer::GetColorRenderBufferDefaultConfig());
+	// Half floats are enough for the G-buffer and halve the bandwidth.
+	const Core::RenderBufferConfig gBufferConfig{
+		.bufferType = Core::RenderBufferConfig::RenderBufferType::RGBA16F,
+		.attachmentType = Core::RenderBufferConfig::AttachmentType::Color
+	};
+	std::vector<Core::Framebuffer::ConfigType> vec(4, gBufferConfig);
 
 	Core::Framebuffer buffer{ width, height,
 		Core::Framebuffer::GetDepthRenderBufferDefaultConfig(), vec	};
 
+	// Depth is only needed when drawing the G-buffer, so it's never stored.
+	using enum Core::Framebuffer::LoadAction;
+	const Core::Framebuffer::PassAction gBufferPass{
+		.depth = { .load = Clear, .store = Core::Framebuffer::StoreAction::DontCare },
+		.colors = std::vector<Core::Framebuffer::AttachmentAction>(4, { .load = Clear })
+	};
+
 	mainWindow.Register([&]() {
-		using enum Core::Framebuffer::BasicClearMode;
-		buffer.Clear();
+		buffer.BeginPass(gBufferPass);
 
 		MRTShader.Activate();
 
@@ -47,11 +57,13 @@ int main()
 		SetMVP(static_cast<float>(width), static_cast<float>(height),
 			near, far, floorModel, frontCamera, MRTShader);
 		floorModel.Draw(MRTShader, buffer);
+		buffer.EndPass(gBufferPass);
 	});
 
 	mainWindow.Register([&]() {
-		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
-		glBindFramebuffer(GL_READ_FRAMEBUFFER, buffer.GetFramebuffer());
+		auto& stateCache = Core::GLStateCache::GetInstance();
+		stateCache.BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+		stateCache.BindFramebuffer(GL_READ_FRAMEBUFFER, buffer.GetFramebuffer());
 		const auto [width, height] = mainWindow.GetWidthAndHeight();
 		const auto bufferWidth = buffer.GetWidth(), 
 			bufferHeight = buffer.GetHeight();
@@ -74,7 +86,8 @@ int main()
 				beginCoords[i].first + width / 2, beginCoords[i].second + height / 2,
 				GL_COLOR_BUFFER_BIT, GL_LINEAR);
 		}
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		// The G-buffer is cleared in the next frame anyway.
+		buffer.Invalidate();
 	});
 
 	mainWindow.MainLoop({ 0.0, 0.0, 0.0, 0.0 });
@@ -141,8 +141,7 @@ Generator<int> ShowBasicInfo(Core::MainWindow& mainWindow)
 
 void RenderShadowMap(Core::Framebuffer& buffer, Core::Camera& lightSpaceCamera)
 {
-	using enum Core::Framebuffer::BasicClearMode;
-	buffer.Clear({ DepthClear }, false);
+	buffer.BeginPass({ .depth = { .load = Core::Framebuffer::LoadAction::Clear } });
 
 	auto& shadowMapShader = shaders.find("shadow map")->second;
 	float near = 0.1f, far = 100.0f;
@@ -178,13 +177,16 @@ Core::TextureParamConfig depthConfig = {
 	}
 };
 
+// The old buffer is given back to the pool, so resizing back to a size
+// used recently doesn't create a new one.
 void ResizeBufferToScreen(Core::MainWindow& mainWindow,
-	Core::Framebuffer& buffer)
+	Core::PooledFramebuffer& buffer)
 {
 	const auto [width, height] = mainWindow.GetWidthAndHeight();
-	if (width == buffer.GetWidth() && height == buffer.GetHeight())
+	if (width == buffer->GetWidth() && height == buffer->GetHeight())
 		return;
-	buffer = Core::Framebuffer{ width, height, depthConfig, {} };
+	buffer = Core::FramebufferPool::GetInstance().Acquire(
+		{ width, height, depthConfig, {} });
 	return;
 };
 
@@ -237,7 +239,8 @@ int main()
 	InitializeAssets(file);
 
 	const auto [width, height] = mainWindow.GetWidthAndHeight();
-	Core::Framebuffer buffer{ width, height, depthConfig, {} };
+	auto buffer = Core::FramebufferPool::GetInstance().Acquire(
+		{ width, height, depthConfig, {} });
 
 	using IterType = Generator<int>::Iter;
 
@@ -264,13 +267,12 @@ int main()
 		Increment<IterType>, basicInfoShow.begin())
 	);
 
-	mainWindow.Register(std::bind(RenderShadowMap, 
-		std::ref(buffer), std::ref(lightSpaceCamera))
-	);
-	mainWindow.Register(std::bind(RenderScreen, 
-		std::ref(buffer), std::ref(normalCamera), 
-		std::ref(lightSpaceCamera), std::ref(option))
-	);
+	mainWindow.Register([&buffer, &lightSpaceCamera]() {
+		RenderShadowMap(*buffer, lightSpaceCamera);
+	});
+	mainWindow.Register([&buffer, &normalCamera, &lightSpaceCamera, &option]() {
+		RenderScreen(*buffer, normalCamera, lightSpaceCamera, option);
+	});
 	mainWindow.MainLoop({ 1.0, 1.0, 1.0, 0.0 });
 	return 0;
 }
\ No newline at end of file
@@ -1,5 +1,9 @@
 #include "AssetLoader.h"
 #include "Utility/IO/IOExtension.h"
+#include "FrameworkCore/ShaderBatch.h"
+#include "FrameworkCore/ShaderPreprocessor.h"
+
+#include <vector>
 
 using namespace OpenGLFramework;
 
@@ -60,25 +64,43 @@ void AssetLoader::LoadModels_(IOExtension::IniFile<std::unordered_map>& file,
 void AssetLoader::LoadShaders_(IOExtension::IniFile<std::unordered_map>& file,
 	const std::filesystem::path& shaderRootPath)
 {
+	// All programs are submitted first so that the driver compiles them
+	// concurrently, and then collected.
+	Core::ShaderBatch batch;
+	Core::ShaderPreprocessor preprocessor;
+	std::vector<std::pair<std::string, size_t>> names;
 	auto& shaderPaths = file.rootSection.GetSubsection("paths.shaders")->get();
 	for (const auto& [_, section] : shaderPaths.GetRawSubsections())
 	{
-		auto geometryShader = section.GetEntry("geometry_shader");
-		if (!geometryShader.has_value())
+		std::vector<Core::ShaderSource> sources;
+		bool failed = false;
+		auto addStage = [&](GLenum type, const std::string& path) {
+			auto source = preprocessor.Process(shaderRootPath / path);
+			if (!source.has_value()) [[unlikely]]
+			{
+				failed = true;
+				return;
+			}
+			sources.push_back({ type, std::move(*source) });
+		};
+
+		addStage(GL_VERTEX_SHADER, section.GetEntry("vertex_shader")->get());
+		if (auto geometryShader = section.GetEntry("geometry_shader");
+			geometryShader.has_value())
+			addStage(GL_GEOMETRY_SHADER, geometryShader->get());
+		addStage(GL_FRAGMENT_SHADER, section.GetEntry("fragment_shader")->get());
+		if (failed) [[unlikely]]
 		{
-			shaders_.emplace(section.GetEntry("name")->get(), Core::Shader{
-				shaderRootPath / section.GetEntry("vertex_shader")->get(),
-				shaderRootPath / section.GetEntry("fragment_shader")->get()
-			});
-		}
-		else {
-			shaders_.emplace(section.GetEntry("name")->get(), Core::Shader{
-				shaderRootPath / section.GetEntry("vertex_shader")->get(),
-				shaderRootPath / geometryShader->get(),
-				shaderRootPath / section.GetEntry("fragment_shader")->get()
-			});
+			IOExtension::LogError("Skip shader " + section.GetEntry("name")->get() +
+				" that fails to be preprocessed.");
+			continue;
 		}
+		names.emplace_back(section.GetEntry("name")->get(), batch.Add(sources));
 	}
+
+	batch.WaitAll();
+	for (auto& [name, index] : names)
+		shaders_.emplace(std::move(name), std::move(batch.Get(index)));
 	return;
 }
 
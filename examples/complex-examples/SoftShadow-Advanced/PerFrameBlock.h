@@ -0,0 +1,25 @@
+#pragma once
+#include "FrameworkCore/UniformBuffer.h"
+
+#include <cstddef>
+
+// Shared by all shaders as "uniform PerFrame" in std140, updated once a frame.
+struct PerFrameBlock
+{
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 lightSpaceMat;
+    glm::vec3 viewPos;
+    float padding0_ = 0;
+    glm::vec3 lightPos;
+    float padding1_ = 0;
+};
+
+static_assert(OpenGLFramework::Core::IsStd140Member<glm::mat4>(
+    offsetof(PerFrameBlock, lightSpaceMat)));
+static_assert(OpenGLFramework::Core::IsStd140Member<glm::vec3>(
+    offsetof(PerFrameBlock, viewPos)));
+static_assert(OpenGLFramework::Core::IsStd140Member<glm::vec3>(
+    offsetof(PerFrameBlock, lightPos)));
+
+using PerFrameBuffer = OpenGLFramework::Core::UniformBuffer<PerFrameBlock>;
@@ -1,25 +1,47 @@
 #include "ScreenShader.h"
 #include "FrameworkCore/Texture.h"
 
+#include <string>
+
+ScreenShader::ScreenShader() : 
+	screenShaders_{ std::filesystem::path{ SHADER_DIR } / "DrawWithShadow.vert",
+		std::filesystem::path{ SHADER_DIR } / "DrawWithShadow.frag" },
+	camera_{ {-30, 10, 18}, {0, 1, 0}, {30, 0, -18} }
+{}
+
+OpenGLFramework::Core::Shader& ScreenShader::GetShader(int shadowOption)
+{
+	return screenShaders_.Get({ { "SHADOW_OPTION", std::to_string(shadowOption) } });
+}
+
 void ScreenShader::Render(ScreenShader& screenShader, ShadowMap& shadowMap,
 	const int& shadowOption, ExampleBase::AssetLoader::ModelContainer& scene)
 {
-	screenShader.SetShaderParams_(shadowMap, shadowOption);
+	screenShader.SetShaderParams_(shadowOption);
 	screenShader.Render_(shadowMap, scene);
 }
 
-void ScreenShader::SetShaderParams_(ShadowMap& shadowMap, int shadowOption)
+void ScreenShader::UpdatePerFrame(ScreenShader& screenShader, 
+	ShadowMap& shadowMap, PerFrameBuffer& perFrameBuffer)
 {
 	float near = 0.1f, far = 100.0f;
-	screenShader_.Activate();
-	screenShader_.SetMat4("lightSpaceMat", shadowMap.GetLightSpaceMat());
-	screenShader_.SetVec3("lightPos", 
-		shadowMap.GetLightSpaceCamera().GetPosition());
-	screenShader_.SetVec3("viewPos", camera_.GetPosition());
-	screenShader_.SetMat4("view", camera_.GetViewMatrix());
-	screenShader_.SetMat4("projection", glm::perspective(camera_.fov,
-		shadowMap.GetAspect(), near, far));
-	screenShader_.SetInt("shadowOption", shadowOption);
+	auto& camera = screenShader.camera_;
+	shadowMap.UpdateLightSpaceMat();
+	perFrameBuffer.Update({
+		.view = camera.GetViewMatrix(),
+		.projection = glm::perspective(camera.fov, shadowMap.GetAspect(), 
+			near, far),
+		.lightSpaceMat = shadowMap.GetLightSpaceMat(),
+		.viewPos = camera.GetPosition(),
+		.lightPos = shadowMap.GetLightSpaceCamera().GetPosition()
+	});
+}
+
+void ScreenShader::SetShaderParams_(int shadowOption)
+{
+	// Swap to the specialized program instead of branching in the shader.
+	screenShader_ = &GetShader(shadowOption);
+	screenShader_->Activate();
 }
 
 void ScreenShader::BindShadowMap_(ShadowMap& shadowMap, int textureBeginID,
@@ -34,10 +56,11 @@ void ScreenShader::BindShadowMap_(ShadowMap& shadowMap, int textureBeginID,
 void ScreenShader::Render_(ShadowMap& shadowMap, 
 	ExampleBase::AssetLoader::ModelContainer& models)
 {
+	renderQueue_.Clear();
+	const auto view = camera_.GetViewMatrix();
 	for (auto& [name, model] : models)
-	{
-		screenShader_.SetMat4("model", model.transform.GetModelMatrix());
-		model.Draw(screenShader_, 
-			std::bind_front(BindShadowMap_, std::ref(shadowMap)), nullptr);
-	}
+		renderQueue_.Push(*screenShader_, model, view);
+	renderQueue_.Sort();
+	renderQueue_.Submit(OpenGLFramework::Core::UniformID{ "model" },
+		std::bind_front(BindShadowMap_, std::ref(shadowMap)));
 };
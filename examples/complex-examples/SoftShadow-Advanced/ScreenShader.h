@@ -1,25 +1,32 @@
 #pragma once
 #include "../Base/AssetLoader.h"
 #include "FrameworkCore/Camera.h"
+#include "FrameworkCore/ShaderVariants.h"
+#include "FrameworkCore/RenderQueue.h"
 #include "ShadowMap.h"
+#include "PerFrameBlock.h"
 
 class ScreenShader
 {
 public:
-    ScreenShader(ExampleBase::AssetLoader& loader) :
-        screenShader_{ loader.GetShader("screen") },
-        camera_{ {-30, 10, 18}, {0, 1, 0}, {30, 0, -18} }
-    {}
+    ScreenShader();
 
     static void Render(ScreenShader& screenShader, ShadowMap& shadowMap, 
        const int& shadowOption, ExampleBase::AssetLoader::ModelContainer&);
+    // Matrices and positions shared by all shaders are uploaded once here.
+    static void UpdatePerFrame(ScreenShader& screenShader, ShadowMap& shadowMap,
+        PerFrameBuffer& perFrameBuffer);
     auto& GetCamera() { return camera_; }
+    // Program specialized for the option, compiled on first use.
+    OpenGLFramework::Core::Shader& GetShader(int shadowOption);
 private:
-    void SetShaderParams_(ShadowMap& shadowMap, int shadowOption);
+    void SetShaderParams_(int shadowOption);
     static void BindShadowMap_(ShadowMap& shadowMap, int textureBeginID, 
         const OpenGLFramework::Core::Shader&);
     void Render_(ShadowMap&, ExampleBase::AssetLoader::ModelContainer&);
 
-    OpenGLFramework::Core::Shader& screenShader_;
+    OpenGLFramework::Core::ShaderVariants screenShaders_;
+    OpenGLFramework::Core::Shader* screenShader_ = nullptr;
     OpenGLFramework::Core::Camera camera_;
+    OpenGLFramework::Core::RenderQueue renderQueue_;
 };
\ No newline at end of file
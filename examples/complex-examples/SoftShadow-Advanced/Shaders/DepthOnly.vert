@@ -1,8 +1,7 @@
 #version 330 core
 
-// lightProjectionMat * lightViewMat
-uniform mat4 lightSpaceMat;
 uniform mat4 modelMat;
+#include "PerFrame.glsl"
 
 layout(location = 0) in vec3 aPosition;
 
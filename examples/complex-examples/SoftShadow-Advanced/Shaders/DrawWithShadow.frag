@@ -9,9 +9,12 @@ in vec4 FragPosInLightSpace;
 
 uniform sampler2D diffuseTexture1;
 uniform sampler2D shadowMap;
-uniform vec3 lightPos;
-uniform vec3 viewPos;
-uniform int shadowOption;
+#include "PerFrame.glsl"
+
+// Specialized by ShaderVariants, see ScreenShader::SetShaderParams_.
+#ifndef SHADOW_OPTION
+#define SHADOW_OPTION 4
+#endif
 
 vec3 lightColor = vec3(1.0, 1.0, 1.0);
 float ambientCoeff = 0.15;
@@ -163,16 +166,17 @@ void main()
 {
     SetProjCoords();
     vec3 resultColor = vec3(0.0);
-    if(shadowOption == 0)
-        resultColor = GetColorWithHardShadow(false);
-    else if(shadowOption == 1)
-        resultColor = GetColorWithHardShadow(true);
-    else if(shadowOption == 2)
-        resultColor = GetColorWithPCFShadow(3); // sampleWidth = 3 * 2 + 1
-    else if(shadowOption == 3)
-        resultColor = GetColorWithPCSS();
-    else if(shadowOption == 4)
-        resultColor = GetColorWithVSSM();
+#if SHADOW_OPTION == 0
+    resultColor = GetColorWithHardShadow(false);
+#elif SHADOW_OPTION == 1
+    resultColor = GetColorWithHardShadow(true);
+#elif SHADOW_OPTION == 2
+    resultColor = GetColorWithPCFShadow(3); // sampleWidth = 3 * 2 + 1
+#elif SHADOW_OPTION == 3
+    resultColor = GetColorWithPCSS();
+#elif SHADOW_OPTION == 4
+    resultColor = GetColorWithVSSM();
+#endif
 
     FragColor = vec4(resultColor, 1.0);
     return;
@@ -9,9 +9,7 @@ out vec3 FragPos;
 out vec4 FragPosInLightSpace;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform mat4 lightSpaceMat;
+#include "PerFrame.glsl"
 
 void main()
 {
@@ -0,0 +1,12 @@
+#pragma once
+
+// Matches PerFrameBlock in PerFrameBlock.h.
+layout(std140) uniform PerFrame
+{
+    mat4 view;
+    mat4 projection;
+    // lightProjectionMat * lightViewMat
+    mat4 lightSpaceMat;
+    vec3 viewPos;
+    vec3 lightPos;
+};
@@ -1,6 +1,8 @@
 #pragma once
 #include "FrameworkCore/Framebuffer.h"
+#include "FrameworkCore/FramebufferPool.h"
 #include "FrameworkCore/Camera.h"
+#include "FrameworkCore/RenderQueue.h"
 #include "../Base/AssetLoader.h"
 
 class ShadowMap
@@ -12,39 +14,49 @@ protected:
     });
 
     using FrameBuffer = OpenGLFramework::Core::Framebuffer;
+    using PooledFrameBuffer = OpenGLFramework::Core::PooledFramebuffer;
     using TextureParamConfig = OpenGLFramework::Core::TextureParamConfig;
+    using TextureGenConfig = OpenGLFramework::Core::TextureGenConfig;
 private:
     inline static const TextureParamConfig c_config_ = {
         .minFilter = TextureParamConfig::MinFilterType::Linear,
         .wrapS = TextureParamConfig::WrapType::ClampToBorder,
         .wrapT = TextureParamConfig::WrapType::ClampToBorder,
         .wrapR = TextureParamConfig::WrapType::ClampToBorder,
-        .auxHandle = Handle_{}
+        .auxHandle = Handle_{},
+        .genConfig = TextureGenConfig{
+            .sizedPixelFormat = TextureGenConfig::SizedPixelFormat::Depth24
+        }
     };
 public:
     ShadowMap(unsigned int init_width, unsigned int init_height,
         ExampleBase::AssetLoader& loader) : ShadowMap{ 
-            { init_width, init_height, c_config_, {} }, loader 
+            OpenGLFramework::Core::FramebufferPool::GetInstance().Acquire(
+                { init_width, init_height, c_config_, {} }), loader
     } {}
 
     static void Render(ShadowMap& shadowMap, 
         ExampleBase::AssetLoader::ModelContainer&);
+    // Should be called before rendering, so that the per-frame block is valid.
+    void UpdateLightSpaceMat();
     const glm::mat4& GetLightSpaceMat() { return lightSpaceMat_; }
     auto& GetLightSpaceCamera() { return lightSpaceCamera_; }
     const auto& GetLightSpaceCamera() const { return lightSpaceCamera_; }
+    // The old buffer is given back to the pool instead of being deleted.
     virtual void ResizeBuffer(unsigned int width, unsigned int height)
     { 
-        buffer_ = FrameBuffer{ width, height, c_config_, {} };
+        buffer_ = OpenGLFramework::Core::FramebufferPool::GetInstance().Acquire(
+            { width, height, c_config_, {} });
     }
 
-    auto GetAspect() const { return buffer_.GetAspect(); }
-    virtual unsigned int GetShadowBuffer() const { return buffer_.GetDepthBuffer(); }
+    auto GetAspect() const { return buffer_->GetAspect(); }
+    virtual unsigned int GetShadowBuffer() const { return buffer_->GetDepthBuffer(); }
     std::pair<unsigned int, unsigned int> GetWidthAndHeight() const { 
-        return { buffer_.GetWidth(), buffer_.GetHeight() };
+        return { buffer_->GetWidth(), buffer_->GetHeight() };
     }
     virtual bool NeedMIPMAP() const { return false; }
 protected:
-    ShadowMap(FrameBuffer frameBuffer, ExampleBase::AssetLoader& loader,
+    ShadowMap(PooledFrameBuffer frameBuffer, ExampleBase::AssetLoader& loader,
         std::string_view shaderName = "shadow map") :
         buffer_{ std::move(frameBuffer) },
         shadowMapShader_{ loader.GetShader(shaderName) },
@@ -54,15 +66,17 @@ protected:
         lightSpaceCamera_.fov = 90;
     }
 
-    FrameBuffer buffer_;
+    PooledFrameBuffer buffer_;
+    FrameBuffer::PassAction passAction_{
+        .depth = { .load = FrameBuffer::LoadAction::Clear }
+    };
 private:
-    void SetShaderParams_();
-    void UpdateLightSpaceMat_();
     void Render_(ExampleBase::AssetLoader::ModelContainer&);
 
     OpenGLFramework::Core::Shader& shadowMapShader_;
     OpenGLFramework::Core::Camera lightSpaceCamera_;
     glm::mat4 lightSpaceMat_;
+    OpenGLFramework::Core::RenderQueue renderQueue_;
 };
 
 class ShadowMapForVSSM : public ShadowMap
@@ -74,24 +88,32 @@ class ShadowMapForVSSM : public ShadowMap
         .wrapS = TextureParamConfig::WrapType::ClampToBorder,
         .wrapT = TextureParamConfig::WrapType::ClampToBorder,
         .wrapR = TextureParamConfig::WrapType::ClampToBorder,
-        .auxHandle = Handle_{}
+        .auxHandle = Handle_{},
+        // Only depth and its square are stored.
+        .genConfig = TextureGenConfig{
+            .sizedPixelFormat = TextureGenConfig::SizedPixelFormat::RG16F
+        }
     };
 
 public:
     ShadowMapForVSSM(unsigned int init_width, unsigned int init_height,
         ExampleBase::AssetLoader& loader) : ShadowMap{
-            { init_width, init_height,
-              FrameBuffer::GetDepthRenderBufferDefaultConfig(), { c_config }
-            }, loader, "shadow map for vssm"
-    } {}
+            OpenGLFramework::Core::FramebufferPool::GetInstance().Acquire(
+                { init_width, init_height,
+                  FrameBuffer::GetDepthRenderBufferDefaultConfig(), { c_config } }),
+            loader, "shadow map for vssm"
+    } {
+        // Depth is only used for depth testing, while moments are sampled.
+        passAction_.depth.store = FrameBuffer::StoreAction::DontCare;
+    }
 
     void ResizeBuffer(unsigned int width, unsigned int height) override
     {
-        buffer_ = OpenGLFramework::Core::Framebuffer{ width, height,
-            FrameBuffer::GetDepthRenderBufferDefaultConfig(), { c_config }
-        };
+        buffer_ = OpenGLFramework::Core::FramebufferPool::GetInstance().Acquire(
+            { width, height, FrameBuffer::GetDepthRenderBufferDefaultConfig(),
+              { c_config } });
     }
 
-    unsigned int GetShadowBuffer() const override { return buffer_.GetColorBuffer(); }
+    unsigned int GetShadowBuffer() const override { return buffer_->GetColorBuffer(); }
     bool NeedMIPMAP() const override { return true; }
 };
\ No newline at end of file
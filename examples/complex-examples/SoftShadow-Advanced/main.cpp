@@ -101,14 +101,23 @@ int main()
 	basicInfoShow.RegisterOnMainWindow(mainWindow);
 
 	ShadowMapForVSSM shadowMap{ width, height, loader };
+	ScreenShader screen;
+	PerFrameBuffer perFrameBuffer{ "PerFrame" };
+	perFrameBuffer.CheckLayout(
+		screen.GetShader(shadowOptionSetter.GetData().option), {
+		{ "lightSpaceMat", offsetof(PerFrameBlock, lightSpaceMat) },
+		{ "lightPos", offsetof(PerFrameBlock, lightPos) }
+	});
+
 	mainWindow.Register([&mainWindow, &shadowMap] {
 		ResizeBufferToScreen(mainWindow, shadowMap);
 	});
+	mainWindow.Register(std::bind_front(ScreenShader::UpdatePerFrame,
+		std::ref(screen), std::ref(shadowMap), std::ref(perFrameBuffer)));
 	mainWindow.Register([&shadowMap, &models = loader.GetModelContainer()]{
 		ShadowMap::Render(shadowMap, models);
 	});
 
-	ScreenShader screen{ loader };
 	mainWindow.Register(std::bind_front(ScreenShader::Render,
 		std::ref(screen), std::ref(shadowMap),
 		std::cref(shadowOptionSetter.GetData().option), 
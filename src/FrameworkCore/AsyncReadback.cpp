@@ -0,0 +1,199 @@
+#include "AsyncReadback.h"
+#include "GLStateCache.h"
+#include "Texture.h"
+#include "Utility/IO/IOExtension.h"
+
+#include <cstring>
+#include <limits>
+
+namespace OpenGLFramework::Core
+{
+
+std::optional<std::vector<unsigned char>> ReadbackHandle::TryGet()
+{
+    if (state_ == nullptr) [[unlikely]]
+        return std::nullopt;
+
+    if (!state_->ready)
+        AsyncReadback::GetInstance().Poll();
+    if (!state_->ready)
+        return std::nullopt;
+    return std::move(state_->data);
+}
+
+std::vector<unsigned char> ReadbackHandle::Get()
+{
+    if (state_ == nullptr) [[unlikely]]
+        return {};
+
+    if (!state_->ready)
+        AsyncReadback::GetInstance().Finish_(state_.get());
+    return std::move(state_->data);
+}
+
+AsyncReadback& AsyncReadback::GetInstance()
+{
+    static AsyncReadback readback{};
+    return readback;
+}
+
+ReadbackHandle AsyncReadback::RequestFramebuffer(unsigned int framebuffer,
+    GLenum readBuffer, int width, int height, int channelNum)
+{
+    auto& slot = slots_[nextSlot_];
+    nextSlot_ = (nextSlot_ + 1) % c_slotNum_;
+    if (slot.state != nullptr) [[unlikely]]
+    {
+        // All PBOs are in flight, so the oldest one has to be finished.
+        stallCount_++;
+        TryComplete_(slot, true);
+    }
+
+    const size_t size = static_cast<size_t>(width) * height * channelNum;
+    if (slot.pixelBuffer == 0)
+        glGenBuffers(1, &slot.pixelBuffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pixelBuffer);
+    if (size > slot.capacity)
+    {
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+        slot.capacity = size;
+    }
+
+    auto& stateCache = GLStateCache::GetInstance();
+    int initialAlignment, initialBuffer;
+    glGetIntegerv(GL_PACK_ALIGNMENT, &initialAlignment);
+    stateCache.BindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glGetIntegerv(GL_READ_BUFFER, &initialBuffer);
+    if (readBuffer != 0)
+        glReadBuffer(readBuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+    // With a pack buffer bound, the last parameter is offset in the buffer.
+    glReadPixels(0, 0, width, height, GetGPUChannelFromCPUChannel(channelNum),
+        GL_UNSIGNED_BYTE, nullptr);
+
+    glPixelStorei(GL_PACK_ALIGNMENT, initialAlignment);
+    glReadBuffer(initialBuffer);
+    stateCache.BindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot.state = std::make_shared<ReadbackHandle::State_>();
+    slot.state->width = width, slot.state->height = height;
+    slot.state->channelNum = channelNum;
+    return ReadbackHandle{ slot.state };
+}
+
+ReadbackHandle AsyncReadback::RequestTexture(int width, int height,
+    int channelNum, unsigned int textureID, int gpuSubTextureType)
+{
+    BindTextureAsReadFramebuffer(textureID, gpuSubTextureType);
+    auto handle = RequestFramebuffer(readFramebuffer_, GL_COLOR_ATTACHMENT0,
+        width, height, channelNum);
+    UnbindReadFramebuffer();
+    return handle;
+}
+
+void AsyncReadback::Poll()
+{
+    for (auto& slot : slots_)
+    {
+        if (slot.state != nullptr)
+            TryComplete_(slot, false);
+    }
+    return;
+}
+
+void AsyncReadback::BindTextureAsReadFramebuffer(unsigned int textureID,
+    int gpuSubTextureType)
+{
+    if (readFramebuffer_ == 0)
+        glGenFramebuffers(1, &readFramebuffer_);
+    GLStateCache::GetInstance().BindFramebuffer(GL_READ_FRAMEBUFFER,
+        readFramebuffer_);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+        gpuSubTextureType, textureID, 0);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    return;
+}
+
+void AsyncReadback::UnbindReadFramebuffer()
+{
+    // Detach so that the cached framebuffer doesn't keep textures alive.
+    auto& stateCache = GLStateCache::GetInstance();
+    stateCache.BindFramebuffer(GL_READ_FRAMEBUFFER, readFramebuffer_);
+    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+        GL_TEXTURE_2D, 0, 0);
+    stateCache.BindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    return;
+}
+
+void AsyncReadback::ReleaseResources()
+{
+    for (auto& slot : slots_)
+    {
+        // Unfinished handles are just abandoned, with empty data.
+        if (slot.fence != nullptr)
+            glDeleteSync(slot.fence);
+        glDeleteBuffers(1, &slot.pixelBuffer);
+        slot = Slot_{};
+    }
+    GLStateCache::GetInstance().OnFramebufferDeleted(readFramebuffer_);
+    glDeleteFramebuffers(1, &readFramebuffer_);
+    readFramebuffer_ = 0;
+    nextSlot_ = 0;
+    return;
+}
+
+bool AsyncReadback::TryComplete_(Slot_& slot, bool wait)
+{
+    GLenum result = glClientWaitSync(slot.fence, 0, 0);
+    // Flush only once when waiting, otherwise the fence may never be signaled.
+    if (wait && result == GL_TIMEOUT_EXPIRED)
+    {
+        result = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+            std::numeric_limits<GLuint64>::max());
+    }
+
+    if (result == GL_TIMEOUT_EXPIRED)
+        return false;
+    if (result == GL_WAIT_FAILED) [[unlikely]]
+        IOExtension::LogError("Fail to wait for readback fence.");
+
+    auto& state = *slot.state;
+    const size_t size = static_cast<size_t>(state.width) * state.height
+        * state.channelNum;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pixelBuffer);
+    auto mappedPtr = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size,
+        GL_MAP_READ_BIT);
+    if (mappedPtr != nullptr) [[likely]]
+    {
+        state.data.resize(size);
+        std::memcpy(state.data.data(), mappedPtr, size);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    else
+        IOExtension::LogError("Fail to map pixel buffer for readback.");
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+    state.ready = true;
+    slot.state.reset();
+    return true;
+}
+
+void AsyncReadback::Finish_(const ReadbackHandle::State_* state)
+{
+    for (auto& slot : slots_)
+    {
+        if (slot.state.get() == state)
+        {
+            TryComplete_(slot, true);
+            return;
+        }
+    }
+    return;
+}
+
+} // namespace OpenGLFramework::Core
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace OpenGLFramework::Core
+{
+
+// Future-like handle of an asynchronous readback. Pixels are copied out of
+// the pixel pack buffer once the fence is signaled, which is checked by
+// AsyncReadback::Poll every frame(see MainWindow::MainLoop), so usually
+// they're ready one or two frames later.
+class ReadbackHandle
+{
+    friend class AsyncReadback;
+    struct State_
+    {
+        std::vector<unsigned char> data;
+        int width = 0, height = 0, channelNum = 0;
+        bool ready = false;
+    };
+
+public:
+    ReadbackHandle() = default;
+    bool IsValid() const { return state_ != nullptr; }
+    bool IsReady() const { return state_ != nullptr && state_->ready; }
+    int GetWidth() const { return state_ ? state_->width : 0; }
+    int GetHeight() const { return state_ ? state_->height : 0; }
+    int GetChannelNum() const { return state_ ? state_->channelNum : 0; }
+
+    // NOTICE: data is moved out, so only the first successful TryGet / Get
+    // returns pixels. These should only be called on the context thread.
+    std::optional<std::vector<unsigned char>> TryGet();
+    // Block until the GPU finishes, which stalls just like glReadPixels.
+    std::vector<unsigned char> Get();
+
+private:
+    std::shared_ptr<State_> state_;
+    explicit ReadbackHandle(std::shared_ptr<State_> state) :
+        state_{ std::move(state) } {};
+};
+
+// Reads pixels into a ring of PBOs, so that glReadPixels returns immediately
+// and the pipeline isn't stalled. The read framebuffer for textures is also
+// cached here instead of being created on every readback.
+class AsyncReadback
+{
+    static constexpr int c_slotNum_ = 3;
+public:
+    static AsyncReadback& GetInstance();
+    AsyncReadback(const AsyncReadback&) = delete;
+    AsyncReadback& operator=(const AsyncReadback&) = delete;
+
+    // readBuffer = 0 keeps the current read buffer of the framebuffer.
+    ReadbackHandle RequestFramebuffer(unsigned int framebuffer,
+        GLenum readBuffer, int width, int height, int channelNum);
+    ReadbackHandle RequestTexture(int width, int height, int channelNum,
+        unsigned int textureID, int gpuSubTextureType);
+    // Copy out all finished readbacks without waiting.
+    void Poll();
+
+    void BindTextureAsReadFramebuffer(unsigned int textureID,
+        int gpuSubTextureType);
+    void UnbindReadFramebuffer();
+
+    // Times that a request has to wait since all PBOs are in flight.
+    size_t GetStallCount() const { return stallCount_; }
+    // Should be called before the context is destroyed.
+    void ReleaseResources();
+
+private:
+    struct Slot_
+    {
+        unsigned int pixelBuffer = 0;
+        size_t capacity = 0;
+        GLsync fence = nullptr;
+        std::shared_ptr<ReadbackHandle::State_> state;
+    };
+    std::array<Slot_, c_slotNum_> slots_;
+    int nextSlot_ = 0;
+    unsigned int readFramebuffer_ = 0;
+    size_t stallCount_ = 0;
+
+    friend class ReadbackHandle;
+    AsyncReadback() = default;
+    ~AsyncReadback() = default;
+    bool TryComplete_(Slot_& slot, bool wait);
+    void Finish_(const ReadbackHandle::State_* state);
+};
+
+} // namespace OpenGLFramework::Core
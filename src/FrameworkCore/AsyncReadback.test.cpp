@@ -0,0 +1,77 @@
+#include "AsyncReadback.h"
+#include "ContextManager.h"
+#include "MainWindow.h"
+#include "Framebuffer.h"
+#include "Texture.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+
+#include <cstring>
+
+using namespace OpenGLFramework::Core;
+
+TEST_CASE("Framebuffer-Readback")
+{
+    Framebuffer frameBuffer{ 30, 20 };
+    frameBuffer.backgroundColor = { 1.0f, 0.0f, 0.0f, 1.0f };
+    frameBuffer.Clear();
+
+    auto syncResult = Framebuffer::SaveFrameBufferInCPU(
+        frameBuffer.GetFramebuffer(), 30, 20, 3);
+    auto handle = Framebuffer::SaveFrameBufferInCPUAsync(
+        frameBuffer.GetFramebuffer(), 30, 20, 3);
+    REQUIRE(handle.IsValid());
+    REQUIRE(handle.GetWidth() == 30);
+
+    auto asyncResult = handle.Get();
+    REQUIRE(handle.IsReady());
+    REQUIRE(asyncResult == syncResult);
+    REQUIRE(asyncResult[0] == 255);
+    REQUIRE(asyncResult[1] == 0);
+    // Data has been moved out.
+    REQUIRE(handle.Get().empty());
+}
+
+TEST_CASE("Texture-Readback")
+{
+    Framebuffer frameBuffer{ 17, 9 };
+    frameBuffer.backgroundColor = { 0.0f, 1.0f, 0.0f, 1.0f };
+    frameBuffer.Clear();
+
+    auto syncResult = GetCPUDataFromAnyTexture(17, 9, 3, GL_TEXTURE_2D,
+        frameBuffer.GetColorBuffer(), GL_TEXTURE_2D);
+    auto handle = AsyncReadback::GetInstance().RequestTexture(17, 9, 3,
+        frameBuffer.GetColorBuffer(), GL_TEXTURE_2D);
+    auto asyncResult = handle.Get();
+    REQUIRE(asyncResult.size() == 17 * 9 * 3);
+    REQUIRE(std::memcmp(asyncResult.data(), syncResult.texturePtr,
+        asyncResult.size()) == 0);
+}
+
+TEST_CASE("Ring-Overflow")
+{
+    Framebuffer frameBuffer{ 8, 8 };
+    frameBuffer.Clear();
+
+    // More requests than PBOs will wait for the oldest one.
+    std::vector<ReadbackHandle> handles;
+    auto initialStall = AsyncReadback::GetInstance().GetStallCount();
+    for (int i = 0; i < 5; i++)
+    {
+        handles.push_back(Framebuffer::SaveFrameBufferInCPUAsync(
+            frameBuffer.GetFramebuffer(), 8, 8, 3));
+    }
+    REQUIRE(AsyncReadback::GetInstance().GetStallCount() > initialStall);
+    REQUIRE(handles[0].IsReady());
+    for (auto& handle : handles)
+        REQUIRE(handle.Get().size() == 8 * 8 * 3);
+}
+
+int main()
+{
+    [[maybe_unused]] ContextManager& manager = ContextManager::GetInstance();
+    MainWindow useForContextWindow{ 50, 50, "test", false };
+    auto result = Catch::Session().run();
+    return result;
+}
@@ -81,6 +81,20 @@ public:
     const glm::vec3& GetPosition() const { return position_; };
     const glm::vec3& GetGaze() const { return gaze_; }
     const glm::vec3& GetUp() const { return up_; }
+
+    // Interpolate the pose and fov, e.g. between fixed update steps; other
+    // settings are from camera2.
+    friend Camera Interpolate(const Camera& camera1, const Camera& camera2,
+        float factor)
+    {
+        Camera result = camera2;
+        result.position_ = glm::mix(camera1.position_, camera2.position_, factor);
+        result.gaze_ = glm::normalize(glm::mix(camera1.gaze_, camera2.gaze_, factor));
+        const auto up = glm::mix(camera1.up_, camera2.up_, factor);
+        result.up_ = glm::normalize(up - result.gaze_ * glm::dot(result.gaze_, up));
+        result.fov = glm::mix(camera1.fov, camera2.fov, factor);
+        return result;
+    }
 private:
     // Note that this sequence is deliberate, so that up will be initialized after front.
     glm::vec3 position_;
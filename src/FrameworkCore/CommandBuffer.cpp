@@ -0,0 +1,103 @@
+#include "CommandBuffer.h"
+#include "GLStateCache.h"
+#include "Mesh.h"
+#include "Utility/IO/IOExtension.h"
+
+#include <type_traits>
+
+namespace OpenGLFramework::Core
+{
+
+static GLenum GetGLCapability(Commands::Capability capability)
+{
+    switch (capability)
+    {
+    case Commands::Capability::DepthTest: return GL_DEPTH_TEST;
+    case Commands::Capability::StencilTest: return GL_STENCIL_TEST;
+    case Commands::Capability::Blend: return GL_BLEND;
+    case Commands::Capability::CullFace: return GL_CULL_FACE;
+    default: return GL_SCISSOR_TEST;
+    }
+}
+
+void CommandBuffer::Execute() const
+{
+    auto& stateCache = GLStateCache::GetInstance();
+    const Shader* currShader = nullptr;
+    auto execute = [&stateCache, &currShader](const auto& command) {
+        using T = std::decay_t<decltype(command)>;
+        if constexpr (std::is_same_v<T, Commands::SetRenderTarget>)
+        {
+            if (command.framebuffer != nullptr)
+                command.framebuffer->UseAsRenderTarget();
+            else
+                stateCache.BindFramebuffer(GL_FRAMEBUFFER, 0);
+        }
+        else if constexpr (std::is_same_v<T, Commands::SetViewport>)
+            glViewport(command.x, command.y, command.width, command.height);
+        else if constexpr (std::is_same_v<T, Commands::Clear>)
+        {
+            GLbitfield mask = 0;
+            if (command.color)
+            {
+                glClearColor(command.clearColor.r, command.clearColor.g,
+                    command.clearColor.b, command.clearColor.a);
+                mask |= GL_COLOR_BUFFER_BIT;
+            }
+            if (command.depth)
+                mask |= GL_DEPTH_BUFFER_BIT;
+            if (command.stencil)
+                mask |= GL_STENCIL_BUFFER_BIT;
+            glClear(mask);
+        }
+        else if constexpr (std::is_same_v<T, Commands::SetEnabled>)
+            stateCache.SetEnabled(GetGLCapability(command.capability), command.enabled);
+        else if constexpr (std::is_same_v<T, Commands::UseShader>)
+        {
+            currShader = command.shader;
+            currShader->Activate();
+        }
+        else if constexpr (std::is_same_v<T, Commands::Callback>)
+            command.func();
+        else if (currShader == nullptr) [[unlikely]]
+            IOExtension::LogError("Shader is needed before uniforms and draws.");
+        else if constexpr (std::is_same_v<T, Commands::ApplyMaterial>)
+        {
+            int textureCnt = command.material->Apply(*currShader);
+            if (command.preprocess != nullptr && *command.preprocess)
+                (*command.preprocess)(textureCnt, *currShader);
+        }
+        else if constexpr (std::is_same_v<T, Commands::SetInt>)
+            currShader->SetInt(command.id, command.value);
+        else if constexpr (std::is_same_v<T, Commands::SetFloat>)
+            currShader->SetFloat(command.id, command.value);
+        else if constexpr (std::is_same_v<T, Commands::SetVec3>)
+            currShader->SetVec3(command.id, command.value);
+        else if constexpr (std::is_same_v<T, Commands::SetVec4>)
+            currShader->SetVec4(command.id, command.value);
+        else if constexpr (std::is_same_v<T, Commands::SetMat4>)
+            currShader->SetMat4(command.id, command.value);
+        else if constexpr (std::is_same_v<T, Commands::DrawIndexed>)
+        {
+            stateCache.BindVertexArray(command.vertexArray);
+            glDrawElements(GL_TRIANGLES, command.indexNum, GL_UNSIGNED_INT, 0);
+        }
+        else if constexpr (std::is_same_v<T, Commands::DrawMesh>)
+            command.mesh->Draw(*currShader);
+        else
+            static_assert(!sizeof(T), "Unhandled command.");
+    };
+
+    for (const auto& command : commands_)
+        std::visit(execute, command);
+    return;
+}
+
+void CommandBuffer::Execute(std::span<const CommandBuffer> buffers)
+{
+    for (const auto& buffer : buffers)
+        buffer.Execute();
+    return;
+}
+
+} // namespace OpenGLFramework::Core
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Shader.h"
+#include "Material.h"
+#include "Framebuffer.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <functional>
+#include <memory>
+#include <span>
+#include <variant>
+#include <vector>
+
+namespace OpenGLFramework::Core
+{
+
+class BasicTriRenderMesh;
+
+namespace Commands
+{
+// Engine-level states, which are mapped to the backend when executing.
+enum class Capability { DepthTest, StencilTest, Blend, CullFace, ScissorTest };
+
+// nullptr means the default framebuffer.
+struct SetRenderTarget { const Framebuffer* framebuffer; };
+struct SetViewport { int x, y, width, height; };
+struct Clear
+{
+    bool color = true, depth = true, stencil = false;
+    glm::vec4 clearColor{ 0.0f, 0.0f, 0.0f, 1.0f };
+};
+struct SetEnabled { Capability capability; bool enabled; };
+struct UseShader { const Shader* shader; };
+// preprocess is called after the material is applied, with the next free
+// texture unit, e.g. to bind shadow maps.
+struct ApplyMaterial
+{
+    // Shared, since materials of meshes may be replaced before execution.
+    std::shared_ptr<const Material> material;
+    const std::function<void(int, const Shader&)>* preprocess;
+};
+struct SetInt { UniformID id; int value; };
+struct SetFloat { UniformID id; float value; };
+struct SetVec3 { UniformID id; glm::vec3 value; };
+struct SetVec4 { UniformID id; glm::vec4 value; };
+struct SetMat4 { UniformID id; glm::mat4 value; };
+struct DrawIndexed { GLuint vertexArray; GLsizei indexNum; };
+// Material of the mesh for the current shader is resolved when executing.
+struct DrawMesh { const BasicTriRenderMesh* mesh; };
+// Escape hatch to run arbitrary code on the context thread.
+struct Callback { std::function<void(void)> func; };
+} // namespace Commands
+
+// Commands are only recorded without any GL call, so that worker threads can
+// fill their own buffers in parallel, e.g. one per pass or per scene chunk.
+// The context thread then executes them in order. Objects referred to should
+// be alive until execution.
+class CommandBuffer
+{
+public:
+    using Command = std::variant<Commands::SetRenderTarget, Commands::SetViewport,
+        Commands::Clear, Commands::SetEnabled, Commands::UseShader,
+        Commands::ApplyMaterial, Commands::SetInt, Commands::SetFloat,
+        Commands::SetVec3, Commands::SetVec4, Commands::SetMat4,
+        Commands::DrawIndexed, Commands::DrawMesh, Commands::Callback>;
+
+    CommandBuffer() = default;
+    CommandBuffer(const CommandBuffer&) = delete;
+    CommandBuffer& operator=(const CommandBuffer&) = delete;
+    CommandBuffer(CommandBuffer&&) noexcept = default;
+    CommandBuffer& operator=(CommandBuffer&&) noexcept = default;
+
+    template<typename T>
+    void Record(T&& command) {
+        commands_.emplace_back(std::in_place_type<std::remove_cvref_t<T>>,
+            std::forward<T>(command));
+    }
+
+    // Should be called on the context thread.
+    void Execute() const;
+    static void Execute(std::span<const CommandBuffer> buffers);
+    // Keep the capacity, so that the next frame needn't allocate.
+    void Clear() { commands_.clear(); }
+    size_t GetSize() const { return commands_.size(); }
+    const Command& operator[](size_t index) const { return commands_[index]; }
+
+private:
+    std::vector<Command> commands_;
+};
+
+} // namespace OpenGLFramework::Core
@@ -0,0 +1,127 @@
+#include "CommandBuffer.h"
+#include "RenderQueue.h"
+#include "ContextManager.h"
+#include "MainWindow.h"
+#include "SpecialModels/SpecialModel.h"
+#include "TestShader.test.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+
+#include <array>
+#include <thread>
+
+using namespace OpenGLFramework::Core;
+
+static const char* c_vertShader = R"(#version 330 core
+layout(location = 0) in vec3 position;
+uniform mat4 model;
+void main() { gl_Position = model * vec4(position, 1.0); }
+)";
+
+static const char* c_fragShader = R"(#version 330 core
+out vec4 FragColor;
+uniform vec4 color;
+void main() { FragColor = color; }
+)";
+
+static std::array<unsigned char, 3> GetCenterPixel(const Framebuffer& buffer)
+{
+    auto pixels = Framebuffer::SaveFrameBufferInCPU(buffer.GetFramebuffer(),
+        buffer.GetWidth(), buffer.GetHeight(), 3);
+    const size_t center = (buffer.GetHeight() / 2 * buffer.GetWidth() +
+        buffer.GetWidth() / 2) * 3;
+    return { pixels[center], pixels[center + 1], pixels[center + 2] };
+}
+
+TEST_CASE("Command-Buffer")
+{
+    Shader shader = CreateShader(c_vertShader, c_fragShader);
+    auto quad = Quad::GetBasicTriRenderMesh();
+    Framebuffer framebuffer{ 16, 16 };
+
+    CommandBuffer buffer;
+    buffer.Record(Commands::SetRenderTarget{ &framebuffer });
+    buffer.Record(Commands::SetViewport{ 0, 0, 16, 16 });
+    buffer.Record(Commands::SetEnabled{ Commands::Capability::DepthTest, false });
+    buffer.Record(Commands::Clear{ .depth = false, .clearColor = { 1, 0, 0, 1 } });
+    REQUIRE(buffer.GetSize() == 4);
+
+    SECTION("Clear")
+    {
+        buffer.Execute();
+        REQUIRE(GetCenterPixel(framebuffer) == std::array<unsigned char, 3>{ 255, 0, 0 });
+    }
+
+    SECTION("Draw")
+    {
+        buffer.Record(Commands::UseShader{ &shader });
+        buffer.Record(Commands::SetVec4{ "color"_uniform, { 0, 1, 0, 1 } });
+        buffer.Record(Commands::SetMat4{ "model"_uniform, glm::mat4{ 1.0f } });
+        buffer.Record(Commands::DrawMesh{ &quad });
+        buffer.Execute();
+        REQUIRE(GetCenterPixel(framebuffer) == std::array<unsigned char, 3>{ 0, 255, 0 });
+    }
+
+    SECTION("Callback")
+    {
+        bool called = false;
+        buffer.Record(Commands::Callback{ [&called]() { called = true; } });
+        buffer.Execute();
+        REQUIRE(called);
+    }
+
+    Framebuffer::RestoreDefaultRenderTarget();
+    REQUIRE(glGetError() == GL_NO_ERROR);
+}
+
+TEST_CASE("Parallel-Recording")
+{
+    constexpr int c_threadNum = 4, c_drawNumPerThread = 256;
+    Shader shader = CreateShader(c_vertShader, c_fragShader);
+    auto quad = Quad::GetBasicTriRenderMesh();
+    Framebuffer framebuffer{ 16, 16 };
+
+    // All threads share the mesh, so its material is created concurrently.
+    std::array<CommandBuffer, c_threadNum> buffers;
+    std::array<RenderQueue, c_threadNum> queues;
+    {
+        std::array<std::jthread, c_threadNum> threads;
+        for (int i = 0; i < c_threadNum; i++)
+        {
+            threads[i] = std::jthread{ [&, i]() {
+                if (i == 0)
+                {
+                    buffers[i].Record(Commands::SetRenderTarget{ &framebuffer });
+                    buffers[i].Record(Commands::SetViewport{ 0, 0, 16, 16 });
+                    buffers[i].Record(Commands::SetEnabled{
+                        Commands::Capability::DepthTest, false });
+                }
+                const glm::mat4 view{ 1.0f };
+                for (int j = 0; j < c_drawNumPerThread; j++)
+                    queues[i].Push(shader, quad, glm::mat4{ 1.0f }, view);
+                queues[i].Sort();
+                buffers[i].Record(Commands::UseShader{ &shader });
+                buffers[i].Record(Commands::SetVec4{ "color"_uniform,
+                    { 0, 0, (i + 1) / 4.0f, 1 } });
+                queues[i].Record(buffers[i]);
+            } };
+        }
+    }
+
+    for (auto& queue : queues)
+        REQUIRE(queue.GetSortedPacket(0).material == queues[0].GetSortedPacket(0).material);
+    CommandBuffer::Execute(buffers);
+    // Buffers are executed in order, so the last one is visible.
+    REQUIRE(GetCenterPixel(framebuffer) == std::array<unsigned char, 3>{ 0, 0, 255 });
+    Framebuffer::RestoreDefaultRenderTarget();
+    REQUIRE(glGetError() == GL_NO_ERROR);
+}
+
+int main()
+{
+    [[maybe_unused]] ContextManager& manager = ContextManager::GetInstance();
+    MainWindow useForContextWindow{ 50, 50, "test", false };
+    auto result = Catch::Session().run();
+    return result;
+}
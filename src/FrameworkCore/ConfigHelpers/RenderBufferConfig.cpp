@@ -15,7 +15,11 @@ unsigned int RenderBufferConfig::Apply(unsigned int width, unsigned int height)
     unsigned int buffer = 0;
     glGenRenderbuffers(1, &buffer);
     glBindRenderbuffer(GL_RENDERBUFFER, buffer);
-    glRenderbufferStorage(GL_RENDERBUFFER, to_underlying(bufferType), width, height);
+    if (samples > 0)
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples,
+            to_underlying(bufferType), width, height);
+    else
+        glRenderbufferStorage(GL_RENDERBUFFER, to_underlying(bufferType), width, height);
     glFramebufferRenderbuffer(GL_FRAMEBUFFER, to_underlying(attachmentType),
         GL_RENDERBUFFER, buffer);
     glBindRenderbuffer(GL_RENDERBUFFER, 0);
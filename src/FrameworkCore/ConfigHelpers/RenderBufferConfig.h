@@ -13,8 +13,12 @@ struct RenderBufferConfig
     // See https://www.khronos.org/opengl/wiki/Image_Format for details.
     enum class RenderBufferType {
         Depth = GL_DEPTH_COMPONENT24,
+        Depth16 = GL_DEPTH_COMPONENT16,
         DepthStencil = GL_DEPTH24_STENCIL8,
-        RGBA = GL_RGBA32F
+        RGBA = GL_RGBA32F,
+        R8 = GL_R8, RGBA8 = GL_RGBA8,
+        RG16F = GL_RG16F, RGBA16F = GL_RGBA16F,
+        R11G11B10F = GL_R11F_G11F_B10F
     } bufferType;
 
     enum class AttachmentType : std::uint32_t {
@@ -23,7 +27,12 @@ struct RenderBufferConfig
         Color = std::numeric_limits<std::uint32_t>::max()
     } attachmentType;
 
+    // 0 means not multisampled; all attachments of a framebuffer should have
+    // the same sample count.
+    int samples = 0;
+
     unsigned int Apply(unsigned int width, unsigned int height) const;
+    bool operator==(const RenderBufferConfig&) const = default;
 };
 
 }
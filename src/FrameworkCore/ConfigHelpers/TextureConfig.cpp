@@ -1,7 +1,9 @@
 #include "TextureConfig.h"
 #include "../Texture.h"
+#include "Utility/GLHelper/GLFeature.h"
 
 #include <type_traits>
+#include <algorithm>
 
 namespace OpenGLFramework::Core
 {
@@ -24,6 +26,73 @@ void TextureGenConfig::Apply(TextureType type, const CPUTextureData& data) const
     Apply(type, data.width, data.height, data.texturePtr);
 };
 
+static bool IsDepthFormat(GLenum sizedFormat)
+{
+    return sizedFormat == GL_DEPTH_COMPONENT16 ||
+        sizedFormat == GL_DEPTH_COMPONENT24 || sizedFormat == GL_DEPTH_COMPONENT32F;
+}
+
+GLenum TextureGenConfig::GetSizedGPUPixelFormat() const
+{
+    if (sizedPixelFormat != SizedPixelFormat::Auto)
+        return to_underlying(sizedPixelFormat);
+
+    const bool isFloat = rawDataType == RawDataType::Float;
+    switch (gpuPixelFormat)
+    {
+    case GPUPixelFormat::R:
+        return isFloat ? GL_R16F : GL_R8;
+    case GPUPixelFormat::RG:
+        return isFloat ? GL_RG16F : GL_RG8;
+    case GPUPixelFormat::RGB:
+        return isFloat ? GL_RGB16F : GL_RGB8;
+    case GPUPixelFormat::RGBA:
+        return isFloat ? GL_RGBA16F : GL_RGBA8;
+    case GPUPixelFormat::Depth:
+        return isFloat ? GL_DEPTH_COMPONENT32F : GL_DEPTH_COMPONENT24;
+    case GPUPixelFormat::DepthStencil:
+        return GL_DEPTH24_STENCIL8;
+    }
+    return to_underlying(gpuPixelFormat);
+}
+
+void TextureGenConfig::AllocateStorage(TextureType textureType, int levels,
+    unsigned int width, unsigned int height) const
+{
+    auto type = to_underlying(textureType);
+    if (GLHelper::SupportTextureStorage())
+    {
+        glTexStorage2D(type, levels, GetSizedGPUPixelFormat(), width, height);
+        return;
+    }
+
+    // Fallback for drivers before 4.2, every level of every face is specified.
+    glTexParameteri(type, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    const GLenum sizedFormat = GetSizedGPUPixelFormat();
+    // Without data, the format only needs to be compatible with sizedFormat.
+    const GLenum cpuFormat = IsDepthFormat(sizedFormat) ?
+        GL_DEPTH_COMPONENT : to_underlying(cpuPixelFormat);
+    const bool isCubeMap = textureType == TextureType::CubeMap;
+    const int faceNum = isCubeMap ? 6 : 1;
+    for (int face = 0; face < faceNum; face++)
+    {
+        GLenum target = isCubeMap ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : type;
+        for (int level = 0; level < levels; level++)
+        {
+            glTexImage2D(target, level, sizedFormat,
+                std::max(width >> level, 1u), std::max(height >> level, 1u), 0,
+                cpuFormat, to_underlying(rawDataType), nullptr);
+        }
+    }
+}
+
+void TextureGenConfig::ApplySubImage(TextureType textureType, unsigned int width,
+    unsigned int height, const void* data, int level) const
+{
+    glTexSubImage2D(to_underlying(textureType), level, 0, 0, width, height,
+        to_underlying(cpuPixelFormat), to_underlying(rawDataType), data);
+}
+
 void TextureParamConfig::Apply() const
 {
     auto type = to_underlying(textureType);
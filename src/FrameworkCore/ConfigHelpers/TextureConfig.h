@@ -1,6 +1,8 @@
 #pragma once
 #include <glad/glad.h>
 
+#include <optional>
+
 namespace OpenGLFramework::Core
 {
 
@@ -19,7 +21,6 @@ enum class TextureType {
 
 struct TextureGenConfig
 {
-    // We may introduce sized pixel format in the future.
     enum class GPUPixelFormat {
         R = GL_RED, RG = GL_RG, RGB = GL_RGB, RGBA = GL_RGBA,
         Depth = GL_DEPTH_COMPONENT, DepthStencil = GL_DEPTH_STENCIL
@@ -36,11 +37,39 @@ struct TextureGenConfig
         UByte = GL_UNSIGNED_BYTE, Float = GL_FLOAT
     } rawDataType = RawDataType::UByte;
 
+    // Used by AllocateStorage; Auto means deducing from the two above, while
+    // others are chosen to fit the data narrowly, e.g. R11G11B10F for HDR
+    // color and Depth16 for shadow maps.
+    enum class SizedPixelFormat {
+        Auto = GL_NONE, R8 = GL_R8, RG8 = GL_RG8, RGBA8 = GL_RGBA8,
+        RG16F = GL_RG16F, RGBA16F = GL_RGBA16F, R11G11B10F = GL_R11F_G11F_B10F,
+        Depth16 = GL_DEPTH_COMPONENT16, Depth24 = GL_DEPTH_COMPONENT24,
+        Depth32F = GL_DEPTH_COMPONENT32F
+    } sizedPixelFormat = SizedPixelFormat::Auto;
+
     void Apply(TextureType type, unsigned int width,
         unsigned int height, void* data) const;
     void Apply(TextureType type, const CPUTextureData& data) const;
+
+    // Allocate all levels(and all faces for cube map) at once; immutable
+    // storage is used if glTexStorage2D is supported. Then fill data by
+    // ApplySubImage.
+    void AllocateStorage(TextureType type, int levels, unsigned int width,
+        unsigned int height) const;
+    void ApplySubImage(TextureType type, unsigned int width,
+        unsigned int height, const void* data, int level = 0) const;
+    GLenum GetSizedGPUPixelFormat() const;
+    bool operator==(const TextureGenConfig&) const = default;
 };
 
+inline int GetMIPMAPLevels(unsigned int width, unsigned int height)
+{
+    int levels = 1;
+    for (auto len = width > height ? width : height; len > 1; len >>= 1)
+        levels++;
+    return levels;
+}
+
 inline TextureGenConfig GetDefaultTextureGenConfig(GLenum gpuChannel)
 {
     // cpuPixelFormat is assigned to gpuChannel since it's passed into OpenGL,
@@ -79,7 +108,11 @@ struct TextureParamConfig
 
     bool needMIPMAP = false;
     void(*auxHandle)() = nullptr;
+    // Storage of the texture when used as a framebuffer attachment, which is
+    // RGB8 for color and 32-bit float for depth by default.
+    std::optional<TextureGenConfig> genConfig = std::nullopt;
     void Apply() const;
+    bool operator==(const TextureParamConfig&) const = default;
 };
 
 }
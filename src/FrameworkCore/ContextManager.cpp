@@ -1,4 +1,5 @@
 #include "ContextManager.h"
+#include "UploadWorker.h"
 #include "Utility/IO/IOExtension.h"
 
 #include <glad/glad.h>
@@ -27,9 +28,28 @@ ContextManager::ContextManager()
 
 ContextManager::~ContextManager()
 {
+    uploadWorker_.reset();
     EndAllContext_();
 }
 
+UploadWorker& ContextManager::GetUploadWorker()
+{
+    if (uploadWorker_ == nullptr)
+        uploadWorker_ = std::make_unique<UploadWorker>();
+    return *uploadWorker_;
+}
+
+size_t ContextManager::PollUploadWorker()
+{
+    return uploadWorker_ != nullptr ? uploadWorker_->Poll() : 0;
+}
+
+void ContextManager::ReleaseUploadWorker()
+{
+    uploadWorker_.reset();
+    return;
+}
+
 void ContextManager::InitGLFWContext_()
 {   
     auto initResult = glfwInit();
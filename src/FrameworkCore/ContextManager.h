@@ -1,13 +1,29 @@
 #pragma once
 
+#include <cstddef>
+#include <memory>
+
 namespace OpenGLFramework::Core
 {
 
+class UploadWorker;
+
 class ContextManager
 {
 public:
     static ContextManager& GetInstance();
+
+    // Created on first use, which should be on the main thread after the
+    // main window is created.
+    UploadWorker& GetUploadWorker();
+    // Both are no-op if the worker isn't created; called every frame and
+    // before the main context is destroyed respectively(see MainWindow).
+    // Return the number of uploads handed over.
+    size_t PollUploadWorker();
+    void ReleaseUploadWorker();
 private:
+    std::unique_ptr<UploadWorker> uploadWorker_;
+
     ContextManager();
     ~ContextManager();
     static void InitImGuiContext_();
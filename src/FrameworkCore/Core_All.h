@@ -3,8 +3,21 @@
 #include "FrameworkCore/ContextManager.h"
 #include "FrameworkCore/MainWindow.h"
 #include "FrameworkCore/Model.h"
+#include "FrameworkCore/GLStateCache.h"
 #include "FrameworkCore/Shader.h"
+#include "FrameworkCore/Material.h"
+#include "FrameworkCore/RenderQueue.h"
+#include "FrameworkCore/CommandBuffer.h"
+#include "FrameworkCore/RenderGraph.h"
+#include "FrameworkCore/ShaderBatch.h"
+#include "FrameworkCore/ShaderVariants.h"
+#include "FrameworkCore/UniformBuffer.h"
 #include "FrameworkCore/Camera.h"
+#include "FrameworkCore/FixedUpdateThread.h"
+#include "FrameworkCore/FrameScheduler.h"
 #include "FrameworkCore/Framebuffer.h"
+#include "FrameworkCore/FramebufferPool.h"
+#include "FrameworkCore/UploadWorker.h"
 #include "FrameworkCore/SkyboxTexture.h"
+#include "FrameworkCore/EnvironmentMap.h"
 #include "FrameworkCore/SpecialModels/SpecialModel.h"
\ No newline at end of file
@@ -0,0 +1,494 @@
+#include "EnvironmentMap.h"
+#include "GLStateCache.h"
+#include "Shader.h"
+#include "Utility/IO/IOExtension.h"
+#include "Utility/Threading/JobSystem.h"
+
+#define STBI_WINDOWS_UTF8
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <numbers>
+#include <string>
+#include <type_traits>
+
+#include <version>
+#ifdef __cpp_lib_format
+#include <format>
+#endif
+
+namespace OpenGLFramework::Core
+{
+extern const char* GetConvertedPath(std::string& buffer,
+    const std::filesystem::path& path);
+
+static constexpr int c_faceNum = 6;
+static constexpr int c_prefilterSampleNum = 128;
+static constexpr float c_pi = std::numbers::pi_v<float>;
+
+// Equirectangular image with a box-filtered pyramid, which is sampled by
+// lower levels when prefiltering with large roughness to reduce aliasing.
+class EquirectImage
+{
+public:
+    struct Level {
+        int width, height;
+        std::vector<glm::vec3> pixels;
+    };
+
+    EquirectImage(const float* data, int width, int height)
+    {
+        Level base{ width, height,
+            std::vector<glm::vec3>(static_cast<size_t>(width) * height) };
+        for (size_t i = 0; i < base.pixels.size(); i++)
+            base.pixels[i] = { data[3 * i], data[3 * i + 1], data[3 * i + 2] };
+        levels_.push_back(std::move(base));
+
+        while (levels_.back().width > 1 && levels_.back().height > 1)
+        {
+            const auto& last = levels_.back();
+            Level next{ last.width / 2, last.height / 2, {} };
+            next.pixels.resize(static_cast<size_t>(next.width) * next.height);
+            for (int row = 0; row < next.height; row++)
+            {
+                for (int col = 0; col < next.width; col++)
+                {
+                    auto at = [&last](int r, int c) {
+                        return last.pixels[static_cast<size_t>(r) * last.width + c];
+                    };
+                    next.pixels[static_cast<size_t>(row) * next.width + col] =
+                        (at(2 * row, 2 * col) + at(2 * row, 2 * col + 1) +
+                         at(2 * row + 1, 2 * col) + at(2 * row + 1, 2 * col + 1))
+                        * 0.25f;
+                }
+            }
+            levels_.push_back(std::move(next));
+        }
+        return;
+    }
+
+    int GetLevelNum() const { return static_cast<int>(levels_.size()); }
+    // Solid angle of a texel in base level, ignoring latitude distortion.
+    float GetTexelSolidAngle() const {
+        return 4 * c_pi / (static_cast<float>(levels_[0].width) * levels_[0].height);
+    }
+
+    glm::vec3 Sample(const glm::vec3& dir, int level = 0) const
+    {
+        const auto& image = levels_[std::clamp(level, 0, GetLevelNum() - 1)];
+        const float phi = std::atan2(dir.z, dir.x),
+            theta = std::acos(std::clamp(dir.y, -1.0f, 1.0f));
+        const float u = (phi / (2 * c_pi) + 0.5f) * image.width - 0.5f,
+            v = theta / c_pi * image.height - 0.5f;
+
+        const int col0 = static_cast<int>(std::floor(u)),
+            row0 = static_cast<int>(std::floor(v));
+        const float fracU = u - col0, fracV = v - row0;
+        auto at = [&image](int row, int col) {
+            // Wrap horizontally and clamp vertically.
+            col = (col % image.width + image.width) % image.width;
+            row = std::clamp(row, 0, image.height - 1);
+            return image.pixels[static_cast<size_t>(row) * image.width + col];
+        };
+        return glm::mix(
+            glm::mix(at(row0, col0), at(row0, col0 + 1), fracU),
+            glm::mix(at(row0 + 1, col0), at(row0 + 1, col0 + 1), fracU), fracV);
+    }
+
+private:
+    std::vector<Level> levels_;
+};
+
+// Direction of texel center; faces are ordered as GL_TEXTURE_CUBE_MAP_POSITIVE_X
+// and so on, and row 0 is the first row passed to OpenGL.
+static glm::vec3 GetCubeMapDirection(int face, float u, float v)
+{
+    switch (face)
+    {
+    case 0: return glm::normalize(glm::vec3{ 1, -v, -u });
+    case 1: return glm::normalize(glm::vec3{ -1, -v, u });
+    case 2: return glm::normalize(glm::vec3{ u, 1, v });
+    case 3: return glm::normalize(glm::vec3{ u, -1, -v });
+    case 4: return glm::normalize(glm::vec3{ u, -v, 1 });
+    default: return glm::normalize(glm::vec3{ -u, -v, -1 });
+    }
+}
+
+static std::array<float, EnvironmentMap::c_shCoeffNum>
+GetSHBasis(const glm::vec3& dir)
+{
+    const float x = dir.x, y = dir.y, z = dir.z;
+    return {
+        0.282095f,
+        0.488603f * y, 0.488603f * z, 0.488603f * x,
+        1.092548f * x * y, 1.092548f * y * z, 0.315392f * (3 * z * z - 1),
+        1.092548f * x * z, 0.546274f * (x * x - y * y)
+    };
+}
+
+static float RadicalInverse(unsigned int bits)
+{
+    bits = (bits << 16u) | (bits >> 16u);
+    bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+    bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+    bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+    bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+    return static_cast<float>(bits) * 2.3283064365386963e-10f;
+}
+
+struct PrefilterSample {
+    glm::vec3 tangentDir;
+    float weight;
+    int sourceLevel;
+};
+
+// GGX importance samples in tangent space with N = V = R assumption; they're
+// shared by all texels of the same roughness.
+static std::vector<PrefilterSample> GetPrefilterSamples(float roughness,
+    const EquirectImage& source)
+{
+    const float alpha = roughness * roughness, alpha2 = alpha * alpha;
+    std::vector<PrefilterSample> samples;
+    samples.reserve(c_prefilterSampleNum);
+    for (int i = 0; i < c_prefilterSampleNum; i++)
+    {
+        const float xi1 = static_cast<float>(i) / c_prefilterSampleNum,
+            xi2 = RadicalInverse(i);
+        const float phi = 2 * c_pi * xi1;
+        const float cosTheta = std::sqrt((1 - xi2) / (1 + (alpha2 - 1) * xi2)),
+            sinTheta = std::sqrt(1 - cosTheta * cosTheta);
+        const glm::vec3 halfway{ sinTheta * std::cos(phi),
+            sinTheta * std::sin(phi), cosTheta };
+        const glm::vec3 dir = 2 * cosTheta * halfway - glm::vec3{ 0, 0, 1 };
+        if (dir.z <= 0)
+            continue;
+
+        // Sample by pdf on lower level, see GPU Gems 3 chapter 20.4.
+        const float denominator = cosTheta * cosTheta * (alpha2 - 1) + 1;
+        const float pdf = alpha2 / (c_pi * denominator * denominator) / 4;
+        const float sampleSolidAngle = 1 / (c_prefilterSampleNum * pdf + 1e-4f);
+        const float lod = roughness == 0 ? 0 : std::max(0.5f *
+            std::log2(sampleSolidAngle / source.GetTexelSolidAngle()) + 1, 0.0f);
+        samples.push_back({ dir, dir.z, static_cast<int>(lod) });
+    }
+    return samples;
+}
+
+EnvironmentMap::EnvironmentMap(const std::filesystem::path& hdrPath,
+    int faceSize, int specularLevels) : specularLevels_{
+        std::clamp(specularLevels, 1, GetMIPMAPLevels(faceSize, faceSize)) }
+{
+    LevelData levelData;
+    if (!LoadCache_(hdrPath, faceSize, levelData))
+    {
+        if (!Precompute_(hdrPath, faceSize, levelData)) [[unlikely]]
+            return;
+        SaveCache_(hdrPath, faceSize, levelData);
+    }
+    Upload_(faceSize, levelData);
+    return;
+}
+
+EnvironmentMap::EnvironmentMap(EnvironmentMap&& another) noexcept :
+    cubeMapID_{ std::exchange(another.cubeMapID_, 0) },
+    specularLevels_{ std::exchange(another.specularLevels_, 0) },
+    shCoeffs_{ another.shCoeffs_ }
+{};
+
+EnvironmentMap& EnvironmentMap::operator=(EnvironmentMap&& another) noexcept
+{
+    if (&another == this) [[unlikely]]
+        return *this;
+
+    ReleaseResources_();
+    cubeMapID_ = std::exchange(another.cubeMapID_, 0);
+    specularLevels_ = std::exchange(another.specularLevels_, 0);
+    shCoeffs_ = another.shCoeffs_;
+    return *this;
+}
+
+EnvironmentMap::~EnvironmentMap()
+{
+    ReleaseResources_();
+    return;
+}
+
+void EnvironmentMap::ReleaseResources_()
+{
+    GLStateCache::GetInstance().OnTextureDeleted(cubeMapID_);
+    glDeleteTextures(1, &cubeMapID_);
+    return;
+}
+
+std::filesystem::path EnvironmentMap::GetCachePath(
+    const std::filesystem::path& hdrPath)
+{
+    return std::filesystem::path{ hdrPath }.concat(".envcache");
+}
+
+// Cache is invalidated once any of these is different.
+struct EnvironmentCacheHeader
+{
+    char magic[4] = { 'O', 'G', 'F', 'E' };
+    std::uint32_t version = 1;
+    std::uint32_t faceSize = 0;
+    std::uint32_t specularLevels = 0;
+    std::uint32_t sampleNum = c_prefilterSampleNum;
+    // Explicit padding, so that no indeterminate byte is written to the file.
+    std::uint32_t reserved = 0;
+    std::uint64_t sourceSize = 0;
+    std::int64_t sourceWriteTime = 0;
+
+    bool operator==(const EnvironmentCacheHeader&) const = default;
+};
+static_assert(std::has_unique_object_representations_v<EnvironmentCacheHeader>,
+    "EnvironmentCacheHeader shouldn't have implicit padding.");
+
+static bool GetCacheHeader(const std::filesystem::path& hdrPath, int faceSize,
+    int specularLevels, EnvironmentCacheHeader& header)
+{
+    std::error_code error;
+    auto size = std::filesystem::file_size(hdrPath, error);
+    if (error) [[unlikely]]
+        return false;
+    auto writeTime = std::filesystem::last_write_time(hdrPath, error);
+    if (error) [[unlikely]]
+        return false;
+
+    header.faceSize = faceSize;
+    header.specularLevels = specularLevels;
+    header.sourceSize = size;
+    header.sourceWriteTime = writeTime.time_since_epoch().count();
+    return true;
+}
+
+bool EnvironmentMap::LoadCache_(const std::filesystem::path& hdrPath,
+    int faceSize, LevelData& levelData)
+{
+    EnvironmentCacheHeader expected, actual;
+    if (!GetCacheHeader(hdrPath, faceSize, specularLevels_, expected))
+        return false;
+
+    std::ifstream fin{ GetCachePath(hdrPath), std::ios::binary };
+    if (!fin.is_open())
+        return false;
+    fin.read(reinterpret_cast<char*>(&actual), sizeof(actual));
+    if (!fin || !(actual == expected))
+        return false;
+
+    fin.read(reinterpret_cast<char*>(shCoeffs_.data()), sizeof(shCoeffs_));
+    levelData.resize(specularLevels_);
+    for (int level = 0; level < specularLevels_; level++)
+    {
+        const size_t levelSize = std::max(faceSize >> level, 1);
+        auto& data = levelData[level];
+        data.resize(levelSize * levelSize * 3 * c_faceNum);
+        fin.read(reinterpret_cast<char*>(data.data()),
+            data.size() * sizeof(float));
+    }
+    return static_cast<bool>(fin);
+}
+
+void EnvironmentMap::SaveCache_(const std::filesystem::path& hdrPath,
+    int faceSize, const LevelData& levelData) const
+{
+    EnvironmentCacheHeader header;
+    if (!GetCacheHeader(hdrPath, faceSize, specularLevels_, header))
+        return;
+
+    auto cachePath = GetCachePath(hdrPath);
+    std::ofstream fout{ cachePath, std::ios::binary };
+    fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    fout.write(reinterpret_cast<const char*>(shCoeffs_.data()), sizeof(shCoeffs_));
+    for (const auto& data : levelData)
+    {
+        fout.write(reinterpret_cast<const char*>(data.data()),
+            data.size() * sizeof(float));
+    }
+
+    if (!fout) [[unlikely]]
+    {
+        // An incomplete cache will be rejected by size mismatch next time.
+        IOExtension::LogError("Fail to write environment map cache at path "
+            + cachePath.string());
+    }
+    return;
+}
+
+bool EnvironmentMap::Precompute_(const std::filesystem::path& hdrPath,
+    int faceSize, LevelData& levelData)
+{
+    std::string buffer;
+    const char* validPath = GetConvertedPath(buffer, hdrPath);
+    int width = 0, height = 0, channels = 0;
+    float* rawData = stbi_loadf(validPath, &width, &height, &channels, 3);
+    if (rawData == nullptr) [[unlikely]]
+    {
+#   ifdef __cpp_lib_format
+        IOExtension::LogError(std::format("Fail to load HDR image at "
+            "path {} for reason : {}", hdrPath.string(), stbi_failure_reason()));
+#   else
+        IOExtension::LogError("Fail to load HDR image at path "
+            + hdrPath.string() + " for reason : " + stbi_failure_reason());
+#   endif
+        return false;
+    }
+    EquirectImage source{ rawData, width, height };
+    stbi_image_free(rawData);
+
+    levelData.resize(specularLevels_);
+    for (int level = 0; level < specularLevels_; level++)
+    {
+        const int levelSize = std::max(faceSize >> level, 1);
+        auto& data = levelData[level];
+        data.resize(static_cast<size_t>(levelSize) * levelSize * 3 * c_faceNum);
+
+        const float roughness = specularLevels_ == 1 ? 0.0f :
+            static_cast<float>(level) / (specularLevels_ - 1);
+        const auto samples = GetPrefilterSamples(roughness, source);
+
+        // Every row of every face is an independent task.
+        Threading::ParallelFor(0, levelSize * c_faceNum, [&](size_t task) {
+            const int face = static_cast<int>(task) / levelSize,
+                row = static_cast<int>(task) % levelSize;
+            float* dst = data.data() +
+                (task * levelSize) * 3;
+            const float v = 2 * (row + 0.5f) / levelSize - 1;
+            for (int col = 0; col < levelSize; col++, dst += 3)
+            {
+                const float u = 2 * (col + 0.5f) / levelSize - 1;
+                const glm::vec3 normal = GetCubeMapDirection(face, u, v);
+
+                glm::vec3 result;
+                if (level == 0) {
+                    result = source.Sample(normal);
+                }
+                else {
+                    const glm::vec3 up = std::abs(normal.z) < 0.999f ?
+                        glm::vec3{ 0, 0, 1 } : glm::vec3{ 1, 0, 0 };
+                    const glm::vec3 tangent = glm::normalize(glm::cross(up, normal)),
+                        bitangent = glm::cross(normal, tangent);
+
+                    glm::vec3 sum{ 0 };
+                    float weightSum = 0;
+                    for (const auto& sample : samples)
+                    {
+                        const glm::vec3 dir = tangent * sample.tangentDir.x +
+                            bitangent * sample.tangentDir.y +
+                            normal * sample.tangentDir.z;
+                        sum += source.Sample(dir, sample.sourceLevel) * sample.weight;
+                        weightSum += sample.weight;
+                    }
+                    result = weightSum > 0 ? sum / weightSum : source.Sample(normal);
+                }
+                dst[0] = result.r, dst[1] = result.g, dst[2] = result.b;
+            }
+        });
+    }
+
+    // Project radiance of level 0 onto SH, weighted by texel solid angle.
+    const auto& radiance = levelData[0];
+    std::array<std::array<glm::vec3, c_shCoeffNum>, c_faceNum> faceCoeffs{};
+    std::array<float, c_faceNum> faceWeights{};
+    Threading::ParallelFor(0, c_faceNum, [&](size_t face) {
+        const float* src = radiance.data() +
+            face * faceSize * faceSize * 3;
+        for (int row = 0; row < faceSize; row++)
+        {
+            const float v = 2 * (row + 0.5f) / faceSize - 1;
+            for (int col = 0; col < faceSize; col++, src += 3)
+            {
+                const float u = 2 * (col + 0.5f) / faceSize - 1;
+                const float temp = 1 + u * u + v * v;
+                const float solidAngle = 1 / (temp * std::sqrt(temp));
+                const auto basis = GetSHBasis(GetCubeMapDirection(static_cast<int>(face), u, v));
+                const glm::vec3 color{ src[0], src[1], src[2] };
+                for (int i = 0; i < c_shCoeffNum; i++)
+                    faceCoeffs[face][i] += color * (basis[i] * solidAngle);
+                faceWeights[face] += solidAngle;
+            }
+        }
+    });
+
+    float weightSum = 0;
+    shCoeffs_.fill(glm::vec3{ 0 });
+    for (int face = 0; face < c_faceNum; face++)
+    {
+        weightSum += faceWeights[face];
+        for (int i = 0; i < c_shCoeffNum; i++)
+            shCoeffs_[i] += faceCoeffs[face][i];
+    }
+
+    // Normalize to the whole sphere, then convolve with cosine lobe(whose
+    // bands are pi, 2pi/3, pi/4) and divide by pi for Lambertian BRDF.
+    constexpr std::array<float, c_shCoeffNum> c_bandFactors{
+        1.0f, 2.0f / 3, 2.0f / 3, 2.0f / 3, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f
+    };
+    for (int i = 0; i < c_shCoeffNum; i++)
+        shCoeffs_[i] *= 4 * c_pi / weightSum * c_bandFactors[i];
+    return true;
+}
+
+void EnvironmentMap::Upload_(int faceSize, const LevelData& levelData)
+{
+    auto& stateCache = GLStateCache::GetInstance();
+    glGenTextures(1, &cubeMapID_);
+    stateCache.BindTexture(GL_TEXTURE_CUBE_MAP, cubeMapID_);
+
+    const TextureGenConfig genConfig{
+        .gpuPixelFormat = TextureGenConfig::GPUPixelFormat::RGB,
+        .cpuPixelFormat = TextureGenConfig::CPUPixelFormat::RGB,
+        .rawDataType = TextureGenConfig::RawDataType::Float
+    };
+    genConfig.AllocateStorage(TextureType::CubeMap, specularLevels_,
+        faceSize, faceSize);
+    for (int level = 0; level < specularLevels_; level++)
+    {
+        const int levelSize = std::max(faceSize >> level, 1);
+        const size_t faceDataSize = static_cast<size_t>(levelSize) * levelSize * 3;
+        for (int face = 0; face < c_faceNum; face++)
+        {
+            genConfig.ApplySubImage(
+                static_cast<TextureType>(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face),
+                levelSize, levelSize, levelData[level].data() + faceDataSize * face,
+                level);
+        }
+    }
+
+    TextureParamConfig{
+        .textureType = TextureType::CubeMap,
+        .minFilter = TextureParamConfig::MinFilterType::LinearAfterMIPMAPLinear,
+        .wrapS = TextureParamConfig::WrapType::ClampToEdge,
+        .wrapT = TextureParamConfig::WrapType::ClampToEdge,
+        .wrapR = TextureParamConfig::WrapType::ClampToEdge
+    }.Apply();
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, specularLevels_ - 1);
+    // Prefiltered levels are blurry, so seams between faces are obvious.
+    stateCache.SetEnabled(GL_TEXTURE_CUBE_MAP_SEAMLESS, true);
+    stateCache.BindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    return;
+}
+
+void EnvironmentMap::BindOnShader(unsigned int activateID,
+    const Shader& shader) const
+{
+    static const auto c_shNames = []() {
+        std::array<std::string, c_shCoeffNum> names;
+        for (int i = 0; i < c_shCoeffNum; i++)
+            names[i] = "environmentSH[" + std::to_string(i) + "]";
+        return names;
+    }();
+
+    shader.SetInt("environmentMap", activateID);
+    GLStateCache::GetInstance().BindTexture(activateID, GL_TEXTURE_CUBE_MAP,
+        cubeMapID_);
+    for (int i = 0; i < c_shCoeffNum; i++)
+        shader.SetVec3(c_shNames[i].c_str(), shCoeffs_[i]);
+    shader.SetFloat("environmentMaxLod", static_cast<float>(specularLevels_ - 1));
+    return;
+}
+
+} // namespace OpenGLFramework::Core
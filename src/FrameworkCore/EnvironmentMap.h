@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Texture.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <filesystem>
+#include <vector>
+#include <array>
+
+namespace OpenGLFramework::Core
+{
+
+class Shader;
+
+// HDR environment converted from an equirectangular .hdr file. Mip 0 of the
+// cube map is the radiance, and mip i is GGX-prefiltered with roughness
+// i / (levels - 1). Diffuse irradiance is kept as 9 SH coefficients, so that
+// shaders don't need to convolve per pixel(see Shaders/EnvironmentLighting.frag).
+// All of them are computed once and cached to disk beside the source file.
+class EnvironmentMap
+{
+public:
+    static constexpr int c_shCoeffNum = 9;
+    static constexpr int c_defaultFaceSize = 256;
+    static constexpr int c_defaultSpecularLevels = 6;
+
+    EnvironmentMap(const std::filesystem::path& hdrPath,
+        int faceSize = c_defaultFaceSize,
+        int specularLevels = c_defaultSpecularLevels);
+    EnvironmentMap(const EnvironmentMap&) = delete;
+    EnvironmentMap& operator=(const EnvironmentMap&) = delete;
+    EnvironmentMap(EnvironmentMap&&) noexcept;
+    EnvironmentMap& operator=(EnvironmentMap&&) noexcept;
+    ~EnvironmentMap();
+
+    unsigned int GetID() const { return cubeMapID_; }
+    int GetSpecularLevels() const { return specularLevels_; }
+    // Coefficients are pre-multiplied by the cosine lobe and 1 / pi, so that
+    // their sum weighted by SH basis is the diffuse radiance for albedo 1.
+    const auto& GetSHCoefficients() const { return shCoeffs_; }
+
+    // Set samplerCube environmentMap, vec3 environmentSH[9] and
+    // float environmentMaxLod of shader.
+    void BindOnShader(unsigned int activateID, const Shader& shader) const;
+    static std::filesystem::path GetCachePath(
+        const std::filesystem::path& hdrPath);
+
+private:
+    unsigned int cubeMapID_ = 0;
+    int specularLevels_ = 0;
+    std::array<glm::vec3, c_shCoeffNum> shCoeffs_{};
+
+    // levelData[level] contains 6 faces one by one, each with RGB floats.
+    using LevelData = std::vector<std::vector<float>>;
+    bool LoadCache_(const std::filesystem::path& hdrPath, int faceSize,
+        LevelData& levelData);
+    void SaveCache_(const std::filesystem::path& hdrPath, int faceSize,
+        const LevelData& levelData) const;
+    bool Precompute_(const std::filesystem::path& hdrPath, int faceSize,
+        LevelData& levelData);
+    void Upload_(int faceSize, const LevelData& levelData);
+    void ReleaseResources_();
+};
+
+} // namespace OpenGLFramework::Core
@@ -0,0 +1,68 @@
+#include "EnvironmentMap.h"
+#include "ContextManager.h"
+#include "MainWindow.h"
+#include "../Utility/IO/IniFile.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <stb_image_write.h>
+
+#include <vector>
+#include <cmath>
+
+using namespace OpenGLFramework::Core;
+OpenGLFramework::IOExtension::IniFile config{ TEST_CONFIG_PATH };
+
+static const glm::vec3 c_radiance{ 2.0f, 0.5f, 0.25f };
+
+static glm::vec3 EvaluateSH(const EnvironmentMap& map, const glm::vec3& n)
+{
+    const auto& c = map.GetSHCoefficients();
+    return c[0] * 0.282095f + c[1] * 0.488603f * n.y +
+        c[2] * 0.488603f * n.z + c[3] * 0.488603f * n.x +
+        c[4] * 1.092548f * n.x * n.y + c[5] * 1.092548f * n.y * n.z +
+        c[6] * 0.315392f * (3 * n.z * n.z - 1) + c[7] * 1.092548f * n.x * n.z +
+        c[8] * 0.546274f * (n.x * n.x - n.y * n.y);
+}
+
+TEST_CASE("Constant-Environment")
+{
+    std::filesystem::path path = config.rootSection("hdr_path");
+    const int faceSize = std::stoi(config.rootSection("face_size")),
+        levels = std::stoi(config.rootSection("specular_levels"));
+
+    const int width = 64, height = 32;
+    std::vector<float> image(width * height * 3);
+    for (size_t i = 0; i < image.size(); i += 3)
+        image[i] = c_radiance.r, image[i + 1] = c_radiance.g, image[i + 2] = c_radiance.b;
+    REQUIRE(stbi_write_hdr(path.string().c_str(), width, height, 3, image.data()));
+    std::filesystem::remove(EnvironmentMap::GetCachePath(path));
+
+    EnvironmentMap map{ path, faceSize, levels };
+    REQUIRE(map.GetID() != 0);
+    REQUIRE(map.GetSpecularLevels() == levels);
+    REQUIRE(std::filesystem::exists(EnvironmentMap::GetCachePath(path)));
+
+    // For constant radiance, diffuse radiance for albedo 1 is just itself.
+    for (const glm::vec3& n : { glm::vec3{ 1, 0, 0 }, glm::vec3{ 0, -1, 0 },
+        glm::normalize(glm::vec3{ 1, 1, 1 }) })
+    {
+        auto result = EvaluateSH(map, n);
+        for (int i = 0; i < 3; i++)
+            REQUIRE(std::abs(result[i] - c_radiance[i]) < 1e-2f * c_radiance[i]);
+    }
+
+    SECTION("Load from cache")
+    {
+        EnvironmentMap cachedMap{ path, faceSize, levels };
+        REQUIRE(cachedMap.GetSHCoefficients() == map.GetSHCoefficients());
+    }
+}
+
+int main()
+{
+    [[maybe_unused]] ContextManager& manager = ContextManager::GetInstance();
+    MainWindow useForContextWindow{ 50, 50, "test", false };
+    auto result = Catch::Session().run();
+    return result;
+}
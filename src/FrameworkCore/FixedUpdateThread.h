@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace OpenGLFramework::Core
+{
+
+// Single-producer single-consumer buffer where the writer publishes whole
+// states and the reader always gets the latest one, and neither of them
+// waits for the other. Written states may be skipped if the reader is slow.
+template<typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+    explicit TripleBuffer(const T& initValue) :
+        buffers_{ initValue, initValue, initValue } {}
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer side.
+    T& GetWriteBuffer() { return buffers_[writeIndex_]; }
+    void Publish()
+    {
+        writeIndex_ = middle_.exchange(writeIndex_ | c_newFlag_,
+            std::memory_order_acq_rel) & c_indexMask_;
+        return;
+    }
+
+    // Reader side; returns whether a newer state is acquired.
+    bool Acquire()
+    {
+        if ((middle_.load(std::memory_order_relaxed) & c_newFlag_) == 0)
+            return false;
+        readIndex_ = middle_.exchange(readIndex_, std::memory_order_acq_rel) &
+            c_indexMask_;
+        return true;
+    }
+    const T& GetReadBuffer() const { return buffers_[readIndex_]; }
+
+private:
+    static constexpr std::uint8_t c_indexMask_ = 0b11;
+    static constexpr std::uint8_t c_newFlag_ = 0b100;
+
+    std::array<T, 3> buffers_{};
+    std::uint8_t writeIndex_ = 0, readIndex_ = 1;
+    // Index of the buffer exchanged between the two sides, with a flag of
+    // whether it's published after the reader's last acquisition.
+    std::atomic<std::uint8_t> middle_ = 2;
+};
+
+// Runs simulation on its own thread with a fixed timestep, so that slow logic
+// doesn't lower the frame rate and vice versa. Each step publishes the state
+// with the one before it, and the render thread interpolates between them,
+// i.e. what's rendered lags behind the simulation by one step.
+// State should be copyable, e.g. transforms of objects and the camera.
+template<typename State>
+class FixedUpdateThread
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    // Update the state by one step of deltaTime seconds.
+    using UpdateFunc = std::function<void(State& state, float deltaTime)>;
+    using Command = std::function<void(State& state)>;
+
+    struct Snapshot
+    {
+        State previous, current;
+        // When current is supposed to be reached.
+        Clock::time_point currentTime;
+        std::uint64_t step = 0;
+    };
+
+    FixedUpdateThread(const State& initState, float deltaTime, UpdateFunc func) :
+        state_{ initState }, deltaTime_{ deltaTime }, func_{ std::move(func) },
+        snapshots_{ Snapshot{ initState, initState, Clock::now() } }
+    {
+        return;
+    }
+    FixedUpdateThread(const FixedUpdateThread&) = delete;
+    FixedUpdateThread& operator=(const FixedUpdateThread&) = delete;
+    ~FixedUpdateThread() { Stop(); }
+
+    void Start()
+    {
+        if (thread_.joinable())
+            return;
+        thread_ = std::jthread{ [this](std::stop_token token) { Run_(token); } };
+        return;
+    }
+    // Also called when destructed; the state is kept for the next start.
+    void Stop()
+    {
+        if (!thread_.joinable())
+            return;
+        thread_.request_stop();
+        thread_.join();
+        return;
+    }
+    bool IsRunning() const { return thread_.joinable(); }
+
+    // Commands are executed on the update thread before the next step, which
+    // is how input on the render thread should change the state.
+    void Post(Command command)
+    {
+        std::scoped_lock lock{ commandMutex_ };
+        commands_.push_back(std::move(command));
+        return;
+    }
+
+    // Called on the render thread, at most once per frame; the snapshot is
+    // valid until the next call.
+    const Snapshot& AcquireSnapshot()
+    {
+        snapshots_.Acquire();
+        return snapshots_.GetReadBuffer();
+    }
+
+    // Factor to interpolate from previous to current in the snapshot at the
+    // given time, which is in [0, 1].
+    float GetInterpolationFactor(const Snapshot& snapshot,
+        Clock::time_point time = Clock::now()) const
+    {
+        const float factor = std::chrono::duration<float>(time -
+            snapshot.currentTime).count() / deltaTime_ + 1.0f;
+        return std::clamp(factor, 0.0f, 1.0f);
+    }
+
+    // Needs Interpolate(const State&, const State&, float) found by ADL, e.g.
+    // for Transform and Camera.
+    State GetInterpolatedState()
+    {
+        const auto& snapshot = AcquireSnapshot();
+        return Interpolate(snapshot.previous, snapshot.current,
+            GetInterpolationFactor(snapshot));
+    }
+
+    float GetDeltaTime() const { return deltaTime_; }
+
+private:
+    // Only accessed on the update thread while running.
+    State state_;
+    float deltaTime_;
+    UpdateFunc func_;
+    std::uint64_t step_ = 0;
+
+    std::mutex commandMutex_;
+    std::vector<Command> commands_;
+    TripleBuffer<Snapshot> snapshots_;
+    std::jthread thread_;
+
+    void Run_(std::stop_token token)
+    {
+        const auto stepDuration = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<float>{ deltaTime_ });
+        // Steps that are too late are dropped instead of caught up, which
+        // would make the update fall further behind.
+        constexpr int c_maxLateStepNum = 4;
+        auto nextTime = Clock::now();
+        std::vector<Command> commands;
+        while (!token.stop_requested())
+        {
+            {
+                std::scoped_lock lock{ commandMutex_ };
+                commands.swap(commands_);
+            }
+            for (auto& command : commands)
+                command(state_);
+            commands.clear();
+
+            auto& snapshot = snapshots_.GetWriteBuffer();
+            snapshot.previous = state_;
+            func_(state_, deltaTime_);
+            snapshot.current = state_;
+            nextTime += stepDuration;
+            snapshot.currentTime = nextTime;
+            snapshot.step = ++step_;
+            snapshots_.Publish();
+
+            if (const auto now = Clock::now(); now - nextTime > stepDuration * c_maxLateStepNum)
+                nextTime = now;
+            std::this_thread::sleep_until(nextTime);
+        }
+        return;
+    }
+};
+
+} // namespace OpenGLFramework::Core
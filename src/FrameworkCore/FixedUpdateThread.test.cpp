@@ -0,0 +1,109 @@
+#include "FixedUpdateThread.h"
+#include "Transform.h"
+#include "Camera.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <numbers>
+#include <thread>
+
+using namespace OpenGLFramework::Core;
+
+static float tolerantEpsilon = 1e-5f;
+
+TEST_CASE("Triple-Buffer")
+{
+    TripleBuffer<int> buffer{ 0 };
+    REQUIRE_FALSE(buffer.Acquire());
+
+    buffer.GetWriteBuffer() = 1;
+    buffer.Publish();
+    buffer.GetWriteBuffer() = 2;
+    buffer.Publish();
+    // Only the latest state is read.
+    REQUIRE(buffer.Acquire());
+    REQUIRE(buffer.GetReadBuffer() == 2);
+    REQUIRE_FALSE(buffer.Acquire());
+    REQUIRE(buffer.GetReadBuffer() == 2);
+
+    SECTION("Concurrent")
+    {
+        constexpr int c_lastValue = 100000;
+        std::jthread writer{ [&buffer]() {
+            for (int i = 3; i <= c_lastValue; i++)
+            {
+                buffer.GetWriteBuffer() = i;
+                buffer.Publish();
+            }
+        } };
+
+        int lastValue = 2;
+        while (lastValue != c_lastValue)
+        {
+            if (!buffer.Acquire())
+                continue;
+            REQUIRE(buffer.GetReadBuffer() > lastValue);
+            lastValue = buffer.GetReadBuffer();
+        }
+    }
+}
+
+struct Counter
+{
+    int value = 0;
+    int commandNum = 0;
+};
+
+TEST_CASE("Fixed-Update-Thread")
+{
+    FixedUpdateThread<Counter> updateThread{ {}, 0.005f,
+        [](Counter& counter, [[maybe_unused]] float deltaTime) { counter.value++; } };
+    REQUIRE(updateThread.AcquireSnapshot().step == 0);
+
+    updateThread.Post([](Counter& counter) { counter.commandNum++; });
+    updateThread.Start();
+    REQUIRE(updateThread.IsRunning());
+    while (updateThread.AcquireSnapshot().step < 4)
+        std::this_thread::yield();
+
+    const auto& snapshot = updateThread.AcquireSnapshot();
+    REQUIRE(snapshot.current.value == static_cast<int>(snapshot.step));
+    REQUIRE(snapshot.previous.value + 1 == snapshot.current.value);
+    REQUIRE(snapshot.current.commandNum == 1);
+
+    const auto stepDuration = std::chrono::microseconds{ 5000 };
+    REQUIRE(updateThread.GetInterpolationFactor(snapshot,
+        snapshot.currentTime - stepDuration * 2) == 0.0f);
+    REQUIRE(updateThread.GetInterpolationFactor(snapshot, snapshot.currentTime) == 1.0f);
+    const float halfFactor = updateThread.GetInterpolationFactor(snapshot,
+        snapshot.currentTime - stepDuration / 2);
+    REQUIRE(std::abs(halfFactor - 0.5f) < 1e-3f);
+
+    updateThread.Stop();
+    REQUIRE_FALSE(updateThread.IsRunning());
+}
+
+TEST_CASE("Interpolate")
+{
+    const Transform transform1{}, transform2{ .position = { 2, 0, 0 },
+        .scale = { 3, 3, 3 },
+        .rotation = glm::angleAxis(std::numbers::pi_v<float> / 2, glm::vec3{ 0, 1, 0 }) };
+    const auto transform = Interpolate(transform1, transform2, 0.5f);
+    REQUIRE(glm::all(glm::epsilonEqual(transform.position, glm::vec3{ 1, 0, 0 },
+        tolerantEpsilon)));
+    REQUIRE(glm::all(glm::epsilonEqual(transform.scale, glm::vec3{ 2, 2, 2 },
+        tolerantEpsilon)));
+    REQUIRE(std::abs(glm::angle(transform.rotation) - std::numbers::pi_v<float> / 4) <
+        tolerantEpsilon);
+
+    Camera camera1{ glm::vec3{ 0, 0, 0 }, glm::vec3{ 0, 1, 0 }, glm::vec3{ 0, 0, -1 } };
+    Camera camera2{ glm::vec3{ 0, 2, 0 }, glm::vec3{ 0, 1, 0 }, glm::vec3{ 1, 0, 0 } };
+    camera2.fov = 60.0f;
+    const auto camera = Interpolate(camera1, camera2, 0.5f);
+    REQUIRE(glm::all(glm::epsilonEqual(camera.GetPosition(), glm::vec3{ 0, 1, 0 },
+        tolerantEpsilon)));
+    REQUIRE(glm::all(glm::epsilonEqual(camera.Front(),
+        glm::normalize(glm::vec3{ 1, 0, -1 }), tolerantEpsilon)));
+    REQUIRE(std::abs(glm::dot(camera.Front(), camera.Up())) < tolerantEpsilon);
+    REQUIRE(camera.fov == 52.5f);
+}
@@ -0,0 +1,334 @@
+#include "FrameCapture.h"
+#include "MainWindow.h"
+#include "Utility/IO/IOExtension.h"
+#include "Utility/Image/ImageEncoder.h"
+#include "Utility/Image/PNGEncoder.h"
+#include "Utility/Image/Y4MWriter.h"
+
+#include <stb_image_write.h>
+
+#include <algorithm>
+#include <string>
+
+namespace OpenGLFramework::Core
+{
+extern const char* GetConvertedPath(std::string& buffer,
+    const std::filesystem::path& path);
+
+struct FrameCapture::Sequence_
+{
+    std::filesystem::path path;
+    Format format;
+    int fps;
+    // Assigned on the context thread when frames are queued.
+    size_t nextFrameIndex = 0;
+
+    // Only for Y4M; opened by the first encoded frame, and frames are
+    // converted concurrently but written in order.
+    std::unique_ptr<ImageExtension::Y4MWriter> writer;
+    bool writerValid = false;
+    std::mutex writeMutex;
+    std::condition_variable writeTurn;
+    size_t nextWriteIndex = 0;
+};
+
+static const char* GetExtension(FrameCapture::Format format)
+{
+    switch (format)
+    {
+    case FrameCapture::Format::JPG: return ".jpg";
+    case FrameCapture::Format::BMP: return ".bmp";
+    case FrameCapture::Format::QOI: return ".qoi";
+    case FrameCapture::Format::Y4M: return ".y4m";
+    default: return ".png";
+    }
+}
+
+static FrameCapture::Format GetFormatFromPath(const std::filesystem::path& path)
+{
+    auto extension = path.extension().string();
+    if (extension == ".png")
+        return FrameCapture::Format::PNG;
+    if (extension == ".jpg")
+        return FrameCapture::Format::JPG;
+    if (extension == ".bmp")
+        return FrameCapture::Format::BMP;
+    if (extension == ".qoi")
+        return FrameCapture::Format::QOI;
+
+    IOExtension::LogError("Unrecognized picture format: "
+        + extension + ", save as png.\n");
+    return FrameCapture::Format::PNG;
+}
+
+static std::filesystem::path GetSequenceFramePath(
+    const std::filesystem::path& path, FrameCapture::Format format, size_t index)
+{
+    auto indexStr = std::to_string(index);
+    if (indexStr.size() < 6)
+        indexStr.insert(0, 6 - indexStr.size(), '0');
+    return path.parent_path() / (path.stem().string() + indexStr +
+        GetExtension(format));
+}
+
+FrameCapture::FrameCapture(int workerNum, size_t queueCapacity) :
+    queueCapacity_{ std::max<size_t>(queueCapacity, 1) }
+{
+    workerNum = std::max(workerNum, 1);
+    workers_.reserve(workerNum);
+    for (int i = 0; i < workerNum; i++)
+        workers_.emplace_back(&FrameCapture::WorkerLoop_, this);
+    return;
+}
+
+FrameCapture::~FrameCapture()
+{
+    Flush();
+    {
+        std::scoped_lock lock{ mutex_ };
+        stop_ = true;
+    }
+    jobAvailable_.notify_all();
+    for (auto& worker : workers_)
+        worker.join();
+    return;
+}
+
+void FrameCapture::SaveImage(ReadbackHandle handle,
+    const std::filesystem::path& path, bool needFlip)
+{
+    requestedFrames_++;
+    pendingReadbacks_.push_back({ std::move(handle), Job_{
+        .needFlip = needFlip, .format = GetFormatFromPath(path), .path = path
+    }, false });
+    return;
+}
+
+void FrameCapture::SaveImageSync(ReadbackHandle handle,
+    const std::filesystem::path& path, bool needFlip)
+{
+    Job_ job{ .needFlip = needFlip, .format = GetFormatFromPath(path), .path = path };
+    job.pixels = handle.Get();
+    if (job.pixels.empty()) [[unlikely]]
+    {
+        IOExtension::LogError("Fail to read back pixels for " + path.string());
+        return;
+    }
+    job.width = handle.GetWidth();
+    job.height = handle.GetHeight();
+    job.channelNum = handle.GetChannelNum();
+    // The calling thread waits anyway, so all hardware threads are used.
+    Encode_(job, 0);
+    return;
+}
+
+void FrameCapture::BeginSequence(const std::filesystem::path& path,
+    Format format, int fps)
+{
+    sequence_ = std::make_shared<Sequence_>();
+    sequence_->path = path;
+    sequence_->format = format;
+    sequence_->fps = fps;
+    return;
+}
+
+void FrameCapture::EndSequence()
+{
+    // Queued frames still hold the sequence, so the stream is closed after
+    // they're all written.
+    sequence_.reset();
+    return;
+}
+
+void FrameCapture::Update(const MainWindow& window)
+{
+    CollectReadbacks_(false);
+    if (sequence_ != nullptr)
+    {
+        requestedFrames_++;
+        pendingReadbacks_.push_back({ window.RequestPixelsAsync(3), Job_{
+            .format = sequence_->format, .sequence = sequence_ }, true });
+    }
+    return;
+}
+
+void FrameCapture::Flush()
+{
+    CollectReadbacks_(true);
+    std::unique_lock lock{ mutex_ };
+    jobFinished_.wait(lock, [this]() {
+        return jobs_.empty() && activeJobNum_ == 0;
+    });
+    return;
+}
+
+FrameCapture::Statistics FrameCapture::GetStatistics() const
+{
+    return { requestedFrames_.load(), encodedFrames_.load(),
+        droppedFrames_.load() };
+}
+
+void FrameCapture::CollectReadbacks_(bool wait)
+{
+    // Fences are signaled in order, so stop at the first unfinished one.
+    while (!pendingReadbacks_.empty())
+    {
+        auto& front = pendingReadbacks_.front();
+        std::optional<std::vector<unsigned char>> pixels;
+        if (wait)
+            pixels = front.handle.Get();
+        else if (pixels = front.handle.TryGet(); !pixels.has_value())
+            break;
+
+        Job_ job = std::move(front.job);
+        job.pixels = std::move(*pixels);
+        job.width = front.handle.GetWidth();
+        job.height = front.handle.GetHeight();
+        job.channelNum = front.handle.GetChannelNum();
+        const bool droppable = front.droppable && !wait;
+        pendingReadbacks_.pop_front();
+        PushJob_(std::move(job), droppable);
+    }
+    return;
+}
+
+bool FrameCapture::PushJob_(Job_&& job, bool droppable)
+{
+    if (job.pixels.empty()) [[unlikely]]
+    {
+        droppedFrames_++;
+        return false;
+    }
+
+    std::unique_lock lock{ mutex_ };
+    if (jobs_.size() >= queueCapacity_)
+    {
+        if (droppable)
+        {
+            droppedFrames_++;
+            return false;
+        }
+        jobFinished_.wait(lock, [this]() { return jobs_.size() < queueCapacity_; });
+    }
+
+    if (job.sequence != nullptr)
+    {
+        job.frameIndex = job.sequence->nextFrameIndex++;
+        if (job.sequence->format != Format::Y4M)
+            job.path = GetSequenceFramePath(job.sequence->path,
+                job.sequence->format, job.frameIndex);
+    }
+    jobs_.push_back(std::move(job));
+    lock.unlock();
+    jobAvailable_.notify_one();
+    return true;
+}
+
+void FrameCapture::WorkerLoop_()
+{
+    while (true)
+    {
+        std::unique_lock lock{ mutex_ };
+        jobAvailable_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+        if (jobs_.empty()) // stopped and drained.
+            return;
+
+        Job_ job = std::move(jobs_.front());
+        jobs_.pop_front();
+        activeJobNum_++;
+        lock.unlock();
+        jobFinished_.notify_all();
+
+        // Workers already encode frames concurrently.
+        if (Encode_(job, 1))
+            encodedFrames_++;
+        else
+            droppedFrames_++;
+
+        lock.lock();
+        activeJobNum_--;
+        lock.unlock();
+        jobFinished_.notify_all();
+    }
+}
+
+bool FrameCapture::Encode_(Job_& job, int threadNum)
+{
+    ImageExtension::ImageView image{ job.pixels.data(), job.width, job.height,
+        job.channelNum, job.needFlip };
+
+    if (job.format == Format::QOI)
+    {
+        ImageExtension::WriteFile(job.path, ImageExtension::EncodeQOI(image));
+        return true;
+    }
+
+    if (job.format == Format::PNG)
+    {
+        ImageExtension::WriteFile(job.path, ImageExtension::EncodePNG(image, threadNum));
+        return true;
+    }
+
+    if (job.format == Format::Y4M)
+    {
+        auto& sequence = *job.sequence;
+        {
+            std::scoped_lock lock{ sequence.writeMutex };
+            if (sequence.writer == nullptr)
+            {
+                sequence.writer = std::make_unique<ImageExtension::Y4MWriter>(
+                    sequence.path, job.width, job.height, sequence.fps);
+                sequence.writerValid = sequence.writer->IsOpen();
+            }
+        }
+        // Video stream can't change size, e.g. when window is resized.
+        const bool valid = sequence.writerValid &&
+            sequence.writer->GetWidth() == job.width &&
+            sequence.writer->GetHeight() == job.height;
+        std::vector<unsigned char> frame;
+        if (valid) [[likely]]
+            frame = sequence.writer->ConvertFrame(image);
+
+        // Dropped frames still take their turns, otherwise later ones wait
+        // forever.
+        std::unique_lock lock{ sequence.writeMutex };
+        sequence.writeTurn.wait(lock, [&]() {
+            return sequence.nextWriteIndex == job.frameIndex;
+        });
+        if (valid) [[likely]]
+            sequence.writer->WriteConvertedFrame(frame);
+        sequence.nextWriteIndex++;
+        lock.unlock();
+        sequence.writeTurn.notify_all();
+        return valid;
+    }
+
+    // stbi_flip_vertically_on_write is a global flag which isn't thread-safe,
+    // so rows are flipped here instead.
+    const size_t rowSize = static_cast<size_t>(job.width) * job.channelNum;
+    if (job.needFlip)
+    {
+        for (int row = 0; row < job.height / 2; row++)
+        {
+            std::swap_ranges(job.pixels.begin() + row * rowSize,
+                job.pixels.begin() + (row + 1) * rowSize,
+                job.pixels.begin() + (job.height - 1 - row) * rowSize);
+        }
+    }
+
+    std::string pathBuffer;
+    const char* validPath = GetConvertedPath(pathBuffer, job.path);
+    const auto pixels = job.pixels.data();
+    switch (job.format)
+    {
+    case Format::BMP:
+        stbi_write_bmp(validPath, job.width, job.height, job.channelNum, pixels);
+        break;
+    default:
+        stbi_write_jpg(validPath, job.width, job.height, job.channelNum, pixels, 95);
+        break;
+    }
+    return true;
+}
+
+} // namespace OpenGLFramework::Core
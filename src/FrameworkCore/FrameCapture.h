@@ -0,0 +1,110 @@
+#pragma once
+
+#include "AsyncReadback.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace OpenGLFramework::ImageExtension
+{
+class Y4MWriter;
+}
+
+namespace OpenGLFramework::Core
+{
+
+class MainWindow;
+
+// Frames are read back asynchronously on the context thread, and encoded
+// by worker threads through a bounded queue. Frames of a sequence are
+// dropped when the queue is full, i.e. encoders fall behind the rendering.
+class FrameCapture
+{
+public:
+    enum class Format { PNG, JPG, BMP, QOI, Y4M };
+    struct Statistics
+    {
+        size_t requestedFrames = 0;
+        size_t encodedFrames = 0;
+        size_t droppedFrames = 0;
+    };
+
+    FrameCapture(int workerNum = 2, size_t queueCapacity = 8);
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+    // Pending frames are all encoded before destruction, so the context
+    // should still be alive.
+    ~FrameCapture();
+
+    // Format is decided by extension of path, png if not recognized.
+    // Single image will never be dropped.
+    void SaveImage(ReadbackHandle handle, const std::filesystem::path& path,
+        bool needFlip = true);
+    // Wait for the readback and encode on the calling thread, so the file
+    // is written once returned; called on the context thread.
+    static void SaveImageSync(ReadbackHandle handle,
+        const std::filesystem::path& path, bool needFlip = true);
+    // Images are named as path stem + frame index + extension of format,
+    // e.g. capture/frame.png -> capture/frame000000.png; for Y4M, path is
+    // used as the video stream directly.
+    void BeginSequence(const std::filesystem::path& path, Format format,
+        int fps = 60);
+    void EndSequence();
+    bool IsCapturingSequence() const { return sequence_ != nullptr; }
+
+    // Called on the context thread after every swap(see MainWindow::MainLoop).
+    void Update(const MainWindow& window);
+    // Block until all requested frames are encoded.
+    void Flush();
+    Statistics GetStatistics() const;
+
+private:
+    struct Sequence_;
+    struct Job_
+    {
+        std::vector<unsigned char> pixels;
+        int width = 0, height = 0, channelNum = 0;
+        bool needFlip = true;
+        Format format = Format::PNG;
+        std::filesystem::path path;
+        std::shared_ptr<Sequence_> sequence;
+        size_t frameIndex = 0;
+    };
+    struct PendingReadback_
+    {
+        ReadbackHandle handle;
+        Job_ job;
+        bool droppable;
+    };
+
+    std::shared_ptr<Sequence_> sequence_;
+    std::deque<PendingReadback_> pendingReadbacks_;
+
+    std::deque<Job_> jobs_;
+    size_t queueCapacity_;
+    size_t activeJobNum_ = 0;
+    bool stop_ = false;
+    mutable std::mutex mutex_;
+    std::condition_variable jobAvailable_;
+    std::condition_variable jobFinished_;
+    std::vector<std::thread> workers_;
+
+    std::atomic<size_t> requestedFrames_ = 0;
+    std::atomic<size_t> encodedFrames_ = 0;
+    std::atomic<size_t> droppedFrames_ = 0;
+
+    void CollectReadbacks_(bool wait);
+    bool PushJob_(Job_&& job, bool droppable);
+    void WorkerLoop_();
+    // Return false if the frame is dropped; threadNum is passed to encoders
+    // that split images across threads.
+    static bool Encode_(Job_& job, int threadNum);
+};
+
+} // namespace OpenGLFramework::Core
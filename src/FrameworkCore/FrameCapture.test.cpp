@@ -0,0 +1,93 @@
+#include "FrameCapture.h"
+#include "ContextManager.h"
+#include "MainWindow.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+
+#include <filesystem>
+
+using namespace OpenGLFramework::Core;
+MainWindow* g_window = nullptr;
+
+TEST_CASE("Single-Image")
+{
+    glClearColor(0.0f, 0.0f, 1.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glfwSwapBuffers(g_window->GetNativeHandler());
+
+    // Written once returned.
+    for (auto path : { "FrameCapture.test.png", "FrameCapture.test.qoi" })
+    {
+        std::filesystem::remove(path);
+        g_window->SaveImage(path);
+        REQUIRE(std::filesystem::exists(path));
+    }
+    REQUIRE(std::filesystem::file_size("FrameCapture.test.png") > 0);
+    REQUIRE(std::filesystem::file_size("FrameCapture.test.qoi") > 14);
+}
+
+TEST_CASE("Single-Image-Async")
+{
+    glClearColor(0.0f, 1.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glfwSwapBuffers(g_window->GetNativeHandler());
+
+    for (auto path : { "FrameCapture.async.test.png", "FrameCapture.async.test.jpg" })
+    {
+        std::filesystem::remove(path);
+        g_window->SaveImageAsync(path);
+    }
+    g_window->GetFrameCapture().Flush();
+    REQUIRE(std::filesystem::file_size("FrameCapture.async.test.png") > 0);
+    REQUIRE(std::filesystem::file_size("FrameCapture.async.test.jpg") > 0);
+}
+
+TEST_CASE("Sequence")
+{
+    FrameCapture capture{ 1, 1 };
+    std::filesystem::create_directories("FrameCaptureSequence");
+    capture.BeginSequence("FrameCaptureSequence/frame.qoi",
+        FrameCapture::Format::QOI);
+    for (int i = 0; i < 10; i++)
+    {
+        glClear(GL_COLOR_BUFFER_BIT);
+        glfwSwapBuffers(g_window->GetNativeHandler());
+        AsyncReadback::GetInstance().Poll();
+        capture.Update(*g_window);
+    }
+    capture.EndSequence();
+    capture.Flush();
+
+    auto statistics = capture.GetStatistics();
+    REQUIRE(statistics.requestedFrames == 10);
+    REQUIRE(statistics.encodedFrames + statistics.droppedFrames == 10);
+    REQUIRE(std::filesystem::exists("FrameCaptureSequence/frame000000.qoi"));
+}
+
+TEST_CASE("Video-Stream")
+{
+    std::filesystem::remove("FrameCapture.test.y4m");
+    {
+        FrameCapture capture{ 2, 16 };
+        capture.BeginSequence("FrameCapture.test.y4m", FrameCapture::Format::Y4M, 30);
+        for (int i = 0; i < 5; i++)
+        {
+            glfwSwapBuffers(g_window->GetNativeHandler());
+            capture.Update(*g_window);
+        }
+        capture.EndSequence();
+    }
+    auto [width, height] = g_window->GetWidthAndHeight();
+    REQUIRE(std::filesystem::file_size("FrameCapture.test.y4m") > 
+        static_cast<size_t>(width) * height);
+}
+
+int main()
+{
+    [[maybe_unused]] ContextManager& manager = ContextManager::GetInstance();
+    MainWindow useForContextWindow{ 64, 48, "test", false };
+    g_window = &useForContextWindow;
+    auto result = Catch::Session().run();
+    return result;
+}
@@ -0,0 +1,117 @@
+#include "FrameScheduler.h"
+#include "ContextManager.h"
+#include "UploadWorker.h"
+#include "Utility/IO/IOExtension.h"
+#include "Utility/Threading/JobSystem.h"
+
+#include <GLFW/glfw3.h>
+
+#include <exception>
+
+namespace OpenGLFramework::Core
+{
+
+FrameScheduler& FrameScheduler::GetInstance()
+{
+    static FrameScheduler scheduler;
+    return scheduler;
+}
+
+FrameScheduler::~FrameScheduler()
+{
+    ReleaseResources();
+    return;
+}
+
+void FrameScheduler::Spawn(Coroutine::Task<> task)
+{
+    Run_(std::move(task)).Detach();
+    return;
+}
+
+Coroutine::Task<> FrameScheduler::Run_(Coroutine::Task<> task)
+{
+    try
+    {
+        co_await task;
+    }
+    catch (const std::exception& ex)
+    {
+        IOExtension::LogError(std::string{ "Exception in spawned task: " } + ex.what());
+    }
+    co_return;
+}
+
+void FrameScheduler::Tick()
+{
+    {
+        std::scoped_lock lock{ mutex_ };
+        frameStart_ = std::chrono::steady_clock::now();
+        mainThreadID_ = std::this_thread::get_id();
+        resuming_.swap(waiting_);
+    }
+    // Coroutines waiting again go to waiting_, and run in the next frame.
+    for (auto& waiting : resuming_)
+        waiting.coroutine.resume();
+    resuming_.clear();
+    return;
+}
+
+bool FrameScheduler::HasWaitingTasks() const
+{
+    std::scoped_lock lock{ mutex_ };
+    return !waiting_.empty();
+}
+
+void FrameScheduler::ReleaseResources()
+{
+    std::vector<Waiting_> waiting;
+    {
+        std::scoped_lock lock{ mutex_ };
+        waiting.swap(waiting_);
+    }
+    for (auto& task : waiting)
+        task.root.destroy();
+    return;
+}
+
+std::chrono::steady_clock::duration FrameScheduler::GetElapsedTimeInFrame() const
+{
+    std::scoped_lock lock{ mutex_ };
+    return std::chrono::steady_clock::now() - frameStart_;
+}
+
+void FrameScheduler::ScheduleNextFrame(std::coroutine_handle<> coroutine,
+    std::coroutine_handle<> root)
+{
+    bool isMainThread;
+    {
+        std::scoped_lock lock{ mutex_ };
+        waiting_.push_back({ coroutine, root });
+        isMainThread = std::this_thread::get_id() == mainThreadID_;
+    }
+    // Otherwise on-demand rendering may wait for events before the next Tick.
+    if (!isMainThread)
+        glfwPostEmptyEvent();
+    return;
+}
+
+void ThreadPoolAwaiter::await_suspend(std::coroutine_handle<> coroutine) const
+{
+    Threading::JobSystem::GetInstance().Schedule([coroutine]() { coroutine.resume(); });
+    return;
+}
+
+void LoadTextureAwaiter::await_suspend(std::coroutine_handle<> coroutine)
+{
+    // The awaiter lives in the coroutine frame until it's resumed.
+    ContextManager::GetInstance().GetUploadWorker().Upload(
+        [path = path, config = config]() { return Texture{ path, config }; },
+        [this, coroutine](Texture texture) {
+            result.emplace(std::move(texture));
+            coroutine.resume();
+        });
+    return;
+}
+
+} // namespace OpenGLFramework::Core
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "Texture.h"
+#include "Utility/Generator/Task.h"
+
+#include <chrono>
+#include <coroutine>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace OpenGLFramework::Core
+{
+
+// Resumes coroutines on the main thread once per frame(see
+// MainWindow::MainLoop), so that streaming and incremental work is written
+// sequentially without callbacks, e.g.
+//     Coroutine::Task<> Stream(std::filesystem::path path)
+//     {
+//         Texture texture = co_await LoadTextureAsync(path);
+//         co_await ThreadPool();  // CPU work off the main thread.
+//         co_await NextFrame();   // back to the main thread.
+//         for (auto& item : items)
+//         {
+//             Process(item);
+//             co_await FrameBudget(std::chrono::milliseconds{ 2 });
+//         }
+//     }
+//     FrameScheduler::GetInstance().Spawn(Stream(path));
+class FrameScheduler
+{
+public:
+    static FrameScheduler& GetInstance();
+
+    // The task runs at once until it first suspends; exceptions escaping
+    // it are logged.
+    void Spawn(Coroutine::Task<> task);
+    // Resume coroutines waiting for this frame; called on the main thread.
+    void Tick();
+    bool HasWaitingTasks() const;
+    // Destroy tasks waiting for frames, called before the main context is
+    // destroyed. NOTICE: tasks suspended on other threads or for uploads
+    // aren't destroyed, and ones dropped by the upload worker never resume.
+    void ReleaseResources();
+
+    std::chrono::steady_clock::duration GetElapsedTimeInFrame() const;
+    // Resume the coroutine in the next Tick; thread-safe, and wakes up the
+    // main loop waiting for events when called on other threads. root is
+    // destroyed instead if resources are released before.
+    void ScheduleNextFrame(std::coroutine_handle<> coroutine,
+        std::coroutine_handle<> root);
+
+private:
+    struct Waiting_
+    {
+        std::coroutine_handle<> coroutine;
+        std::coroutine_handle<> root;
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<Waiting_> waiting_;
+    std::vector<Waiting_> resuming_;
+    std::chrono::steady_clock::time_point frameStart_ = std::chrono::steady_clock::now();
+    std::thread::id mainThreadID_ = std::this_thread::get_id();
+
+    FrameScheduler() = default;
+    ~FrameScheduler();
+    static Coroutine::Task<> Run_(Coroutine::Task<> task);
+};
+
+struct NextFrameAwaiter
+{
+    bool await_ready() const noexcept { return false; }
+    template<typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> coroutine) const
+    {
+        FrameScheduler::GetInstance().ScheduleNextFrame(coroutine,
+            Coroutine::GetRootCoroutine(coroutine));
+        return;
+    }
+    void await_resume() const noexcept {}
+};
+
+struct FrameBudgetAwaiter : NextFrameAwaiter
+{
+    std::chrono::steady_clock::duration budget;
+    bool await_ready() const
+    {
+        return FrameScheduler::GetInstance().GetElapsedTimeInFrame() < budget;
+    }
+};
+
+struct ThreadPoolAwaiter
+{
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> coroutine) const;
+    void await_resume() const noexcept {}
+};
+
+struct LoadTextureAwaiter
+{
+    std::filesystem::path path;
+    TextureParamConfig config;
+    std::optional<Texture> result;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> coroutine);
+    Texture await_resume() { return std::move(*result); }
+};
+
+// Continue on the main thread in the next frame.
+inline NextFrameAwaiter NextFrame() { return {}; }
+
+// Continue at once if the frame has been running for less than budget,
+// otherwise in the next frame. Put in loops to slice work across frames.
+template<typename Rep, typename Period>
+FrameBudgetAwaiter FrameBudget(std::chrono::duration<Rep, Period> budget)
+{
+    return FrameBudgetAwaiter{ {},
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(budget) };
+}
+
+// Continue on a worker of Threading::JobSystem; GL calls aren't allowed
+// there until co_await NextFrame().
+inline ThreadPoolAwaiter ThreadPool() { return {}; }
+
+// Decode and upload the texture on the upload worker(see UploadWorker), and
+// continue on the main thread once it's ready.
+inline LoadTextureAwaiter LoadTextureAsync(std::filesystem::path path,
+    const TextureParamConfig& config = Texture::GetDefaultParamConfig())
+{
+    return LoadTextureAwaiter{ std::move(path), config, std::nullopt };
+}
+
+} // namespace OpenGLFramework::Core
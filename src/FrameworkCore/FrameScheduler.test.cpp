@@ -0,0 +1,168 @@
+#include "FrameScheduler.h"
+#include "ContextManager.h"
+#include "MainWindow.h"
+#include "../Utility/IO/IniFile.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+
+#include <chrono>
+#include <thread>
+
+using namespace OpenGLFramework::Core;
+using OpenGLFramework::Coroutine::Task;
+OpenGLFramework::IOExtension::IniFile config{ TEST_CONFIG_PATH };
+
+// Run frames as the main loop does until finished becomes true.
+static bool RunFramesUntil(const bool& finished)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 10 };
+    while (!finished)
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+            return false;
+        FrameScheduler::GetInstance().Tick();
+        ContextManager::GetInstance().PollUploadWorker();
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    }
+    return true;
+}
+
+Task<int> CountFrames(int frameNum)
+{
+    int count = 0;
+    for (int i = 0; i < frameNum; i++)
+    {
+        co_await NextFrame();
+        count++;
+    }
+    co_return count;
+}
+
+TEST_CASE("Next-Frame")
+{
+    auto& scheduler = FrameScheduler::GetInstance();
+    int result = 0;
+    scheduler.Spawn([](int& result) -> Task<> {
+        result = co_await CountFrames(3);
+    }(result));
+
+    for (int i = 0; i < 3; i++)
+    {
+        REQUIRE(scheduler.HasWaitingTasks());
+        REQUIRE(result == 0);
+        scheduler.Tick();
+    }
+    REQUIRE(!scheduler.HasWaitingTasks());
+    REQUIRE(result == 3);
+}
+
+Task<> Slice(int itemNum, std::chrono::milliseconds budget, int& processedNum)
+{
+    for (int i = 0; i < itemNum; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+        processedNum++;
+        co_await FrameBudget(budget);
+    }
+}
+
+TEST_CASE("Frame-Budget")
+{
+    auto& scheduler = FrameScheduler::GetInstance();
+    int processedNum = 0;
+    scheduler.Tick();
+    // Budget is used up after each item.
+    scheduler.Spawn(Slice(4, std::chrono::milliseconds{ 0 }, processedNum));
+    REQUIRE(processedNum == 1);
+    scheduler.Tick();
+    REQUIRE(processedNum == 2);
+    for (int i = 0; i < 10 && scheduler.HasWaitingTasks(); i++)
+        scheduler.Tick();
+    REQUIRE(processedNum == 4);
+
+    // All items fit in one frame.
+    processedNum = 0;
+    scheduler.Tick();
+    scheduler.Spawn(Slice(4, std::chrono::seconds{ 10 }, processedNum));
+    REQUIRE(processedNum == 4);
+    REQUIRE(!scheduler.HasWaitingTasks());
+}
+
+Task<> SwitchThreads(std::thread::id mainThreadID, bool& onWorker, bool& backOnMain,
+    bool& finished)
+{
+    co_await ThreadPool();
+    onWorker = std::this_thread::get_id() != mainThreadID;
+    co_await NextFrame();
+    backOnMain = std::this_thread::get_id() == mainThreadID;
+    finished = true;
+}
+
+TEST_CASE("Thread-Pool")
+{
+    bool onWorker = false, backOnMain = false, finished = false;
+    FrameScheduler::GetInstance().Spawn(SwitchThreads(std::this_thread::get_id(),
+        onWorker, backOnMain, finished));
+    REQUIRE(RunFramesUntil(finished));
+    REQUIRE(onWorker);
+    REQUIRE(backOnMain);
+}
+
+Task<> LoadTexture(std::filesystem::path path, std::optional<Texture>& texture,
+    bool& finished)
+{
+    texture.emplace(co_await LoadTextureAsync(path));
+    finished = true;
+}
+
+TEST_CASE("Load-Texture-Async")
+{
+    auto& path = config.rootSection.GetEntry("texture_path")->get();
+    std::filesystem::path unicodePath{
+        reinterpret_cast<const char8_t*>(path.c_str())
+    };
+    REQUIRE(std::filesystem::exists(unicodePath));
+
+    std::optional<Texture> texture;
+    bool finished = false;
+    FrameScheduler::GetInstance().Spawn(LoadTexture(unicodePath, texture, finished));
+    REQUIRE(RunFramesUntil(finished));
+
+    CPUTextureData cpuTex{ unicodePath };
+    auto [width, height] = texture->GetWidthAndHeight();
+    REQUIRE(width == cpuTex.width);
+    REQUIRE(height == cpuTex.height);
+    REQUIRE(glGetError() == GL_NO_ERROR);
+}
+
+struct DestructionFlag
+{
+    bool& destroyed;
+    ~DestructionFlag() { destroyed = true; }
+};
+
+TEST_CASE("Release-Resources")
+{
+    auto& scheduler = FrameScheduler::GetInstance();
+    bool destroyed = false, resumed = false;
+    scheduler.Spawn([](bool& destroyed, bool& resumed) -> Task<> {
+        DestructionFlag flag{ destroyed };
+        co_await CountFrames(10);
+        resumed = true;
+    }(destroyed, resumed));
+    scheduler.Tick();
+
+    scheduler.ReleaseResources();
+    REQUIRE(destroyed);
+    REQUIRE(!resumed);
+    REQUIRE(!scheduler.HasWaitingTasks());
+}
+
+int main()
+{
+    [[maybe_unused]] ContextManager& manager = ContextManager::GetInstance();
+    MainWindow useForContextWindow{ 50, 50, "test", false };
+    auto result = Catch::Session().run();
+    return result;
+}
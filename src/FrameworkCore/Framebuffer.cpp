@@ -1,33 +1,56 @@
 #include "Framebuffer.h"
+#include "GLStateCache.h"
 #include "Utility/IO/IOExtension.h"
+#include "Utility/GLHelper/GLFeature.h"
 #include "Texture.h"
 
 #include <glad/glad.h>
 
+#include <algorithm>
+
 namespace OpenGLFramework::Core
 {
 
 void Framebuffer::GenerateAndAttachDepthBuffer_(RenderBufferConfigCRef ref)
 {
     depthBuffer_ = RenderBuffer{ ref.get().Apply(width_, height_) };
+    depthAttachment_ = static_cast<GLenum>(ref.get().attachmentType);
     return;
 }
 
-void Framebuffer::GenerateAndAttachDepthBuffer_(TexParamConfigCRef ref)
+unsigned int Framebuffer::GenerateTextureStorage_(TexParamConfigCRef ref,
+    const TextureGenConfig& defaultGenConfig)
 {
     unsigned int buffer = 0;
     glGenTextures(1, &buffer);
-    glBindTexture(GL_TEXTURE_2D, buffer);
-    TextureGenConfig{
+    GLStateCache::GetInstance().BindTexture(GL_TEXTURE_2D, buffer);
+
+    // Storage is immutable, so the MIPMAP chain is allocated ahead when it may
+    // be generated later, i.e. the min filter samples MIPMAPs.
+    using enum TextureParamConfig::MinFilterType;
+    const auto& config = ref.get();
+    const bool useMIPMAP = config.needMIPMAP ||
+        (config.minFilter != Nearest && config.minFilter != Linear);
+    const int levels = useMIPMAP ? GetMIPMAPLevels(width_, height_) : 1;
+    config.genConfig.value_or(defaultGenConfig).AllocateStorage(
+        TextureType::Texture2D, levels, width_, height_);
+    config.Apply();
+    GLStateCache::GetInstance().BindTexture(GL_TEXTURE_2D, 0);
+    return buffer;
+}
+
+void Framebuffer::GenerateAndAttachDepthBuffer_(TexParamConfigCRef ref)
+{
+    static const TextureGenConfig c_defaultGenConfig{
         .gpuPixelFormat = TextureGenConfig::GPUPixelFormat::Depth,
         .cpuPixelFormat = TextureGenConfig::CPUPixelFormat::Depth,
         .rawDataType = TextureGenConfig::RawDataType::Float
-    }.Apply(TextureType::Texture2D, width_, height_, nullptr);
-    ref.get().Apply();
+    };
+    unsigned int buffer = GenerateTextureStorage_(ref, c_defaultGenConfig);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
         GL_TEXTURE_2D, buffer, 0);
-    glBindTexture(GL_TEXTURE_2D, 0);
     depthBuffer_ = RenderTexture{ buffer };
+    depthAttachment_ = GL_DEPTH_ATTACHMENT;
     return;
 }
 
@@ -42,16 +65,10 @@ void Framebuffer::GenerateAndAttachColorBuffer_(RenderBufferConfigCRef ref, int
 };
 
 void Framebuffer::GenerateAndAttachColorBuffer_(TexParamConfigCRef ref, int id) {
-    unsigned int buffer = 0;
-    glGenTextures(1, &buffer);
-    glBindTexture(GL_TEXTURE_2D, buffer);
-
-    GetDefaultTextureGenConfig(GL_RGB).Apply(TextureType::Texture2D,
-        width_, height_, nullptr);
-    ref.get().Apply();
+    static const TextureGenConfig c_defaultGenConfig = GetDefaultTextureGenConfig(GL_RGB);
+    unsigned int buffer = GenerateTextureStorage_(ref, c_defaultGenConfig);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + id,
         GL_TEXTURE_2D, buffer, 0);
-    glBindTexture(GL_TEXTURE_2D, 0);
 
     colorBuffers_.push_back(RenderTexture{ buffer });
 };
@@ -87,7 +104,7 @@ Framebuffer::Framebuffer(unsigned int init_width, unsigned int init_height,
     }
 
     glGenFramebuffers(1, &frameBuffer_);
-    glBindFramebuffer(GL_FRAMEBUFFER, frameBuffer_);
+    GLStateCache::GetInstance().BindFramebuffer(GL_FRAMEBUFFER, frameBuffer_);
 
     if (colorConfigs.empty()) {
         glDrawBuffer(GL_NONE);
@@ -115,13 +132,13 @@ Framebuffer::Framebuffer(unsigned int init_width, unsigned int init_height,
         glDrawBuffers(static_cast<GLsizei>(attachmentNum), attachmentIDs.data());
 
     // restore default option.
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLStateCache::GetInstance().BindFramebuffer(GL_FRAMEBUFFER, 0);
     return;
 }
 
 Framebuffer::Framebuffer(Framebuffer&& another) noexcept: 
     frameBuffer_(another.frameBuffer_), depthBuffer_(another.depthBuffer_),
-    colorBuffers_(std::move(another.colorBuffers_)), width_(another.width_),
+    depthAttachment_(another.depthAttachment_), colorBuffers_(std::move(another.colorBuffers_)), width_(another.width_),
     height_(another.height_)
 {
     another.frameBuffer_ = 0;
@@ -136,7 +153,10 @@ void Framebuffer::ReleaseResources_()
         if constexpr (std::is_same_v<T, RenderBuffer>)
             glDeleteRenderbuffers(1, &arg.buffer);
         else if constexpr (std::is_same_v<T, RenderTexture>)
+        {
+            GLStateCache::GetInstance().OnTextureDeleted(arg.buffer);
             glDeleteTextures(1, &arg.buffer);
+        }
         else
         {
             IOExtension::LogError("Unrecognized format.");
@@ -146,6 +166,7 @@ void Framebuffer::ReleaseResources_()
     std::visit(ReleaseBuffer, depthBuffer_);
     for (auto& buffer : colorBuffers_)
         std::visit(ReleaseBuffer, buffer);
+    GLStateCache::GetInstance().OnFramebufferDeleted(frameBuffer_);
     glDeleteFramebuffers(1, &frameBuffer_);
     colorBuffers_.clear();
     return;
@@ -159,6 +180,7 @@ Framebuffer& Framebuffer::operator=(Framebuffer&& another) noexcept
     ReleaseResources_();
     frameBuffer_ = another.frameBuffer_;
     depthBuffer_ = std::move(another.depthBuffer_);
+    depthAttachment_ = another.depthAttachment_;
     colorBuffers_ = std::move(another.colorBuffers_);
     width_ = another.width_;
     height_ = another.height_;
@@ -175,17 +197,93 @@ Framebuffer::~Framebuffer()
 
 void Framebuffer::UseAsRenderTarget() const
 {
-    glBindFramebuffer(GL_FRAMEBUFFER, frameBuffer_);
+    GLStateCache::GetInstance().BindFramebuffer(GL_FRAMEBUFFER, frameBuffer_);
     return;
 };
 
 void Framebuffer::RestoreDefaultRenderTarget()
 {
-    glEnable(GL_DEPTH_TEST);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    auto& stateCache = GLStateCache::GetInstance();
+    stateCache.SetEnabled(GL_DEPTH_TEST, true);
+    stateCache.BindFramebuffer(GL_FRAMEBUFFER, 0);
     return;
 };
 
+// Only a hint, so it's just skipped if not supported.
+static void InvalidateAttachments(const std::vector<GLenum>& attachments)
+{
+    if (attachments.empty() || !GLHelper::SupportInvalidateFramebuffer())
+        return;
+    glInvalidateFramebuffer(GL_FRAMEBUFFER,
+        static_cast<GLsizei>(attachments.size()), attachments.data());
+    return;
+}
+
+void Framebuffer::BeginPass(const PassAction& action) const
+{
+    UseAsRenderTarget();
+    std::vector<GLenum> invalidAttachments;
+    if (depthAttachment_ != GL_NONE)
+    {
+        if (action.depth.load == LoadAction::DontCare)
+            invalidAttachments.push_back(depthAttachment_);
+        else if (action.depth.load == LoadAction::Clear)
+        {
+            if (depthAttachment_ == GL_DEPTH_STENCIL_ATTACHMENT)
+                glClearBufferfi(GL_DEPTH_STENCIL, 0, action.clearDepth, 0);
+            else
+                glClearBufferfv(GL_DEPTH, 0, &action.clearDepth);
+        }
+    }
+
+    // Color attachments are in the same order as draw buffers.
+    const auto colorNum = std::min(action.colors.size(), colorBuffers_.size());
+    for (size_t i = 0; i < colorNum; i++)
+    {
+        if (action.colors[i].load == LoadAction::DontCare)
+            invalidAttachments.push_back(GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i));
+        else if (action.colors[i].load == LoadAction::Clear)
+            glClearBufferfv(GL_COLOR, static_cast<GLint>(i), &backgroundColor[0]);
+    }
+    InvalidateAttachments(invalidAttachments);
+    return;
+}
+
+void Framebuffer::EndPass(const PassAction& action) const
+{
+    std::vector<GLenum> invalidAttachments;
+    if (depthAttachment_ != GL_NONE && action.depth.store == StoreAction::DontCare)
+        invalidAttachments.push_back(depthAttachment_);
+
+    const auto colorNum = std::min(action.colors.size(), colorBuffers_.size());
+    for (size_t i = 0; i < colorNum; i++)
+    {
+        if (action.colors[i].store == StoreAction::DontCare)
+            invalidAttachments.push_back(GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i));
+    }
+    if (!invalidAttachments.empty())
+    {
+        UseAsRenderTarget();
+        InvalidateAttachments(invalidAttachments);
+    }
+    RestoreDefaultRenderTarget();
+    return;
+}
+
+void Framebuffer::Invalidate() const
+{
+    std::vector<GLenum> invalidAttachments;
+    if (depthAttachment_ != GL_NONE)
+        invalidAttachments.push_back(depthAttachment_);
+    for (size_t i = 0; i < colorBuffers_.size(); i++)
+        invalidAttachments.push_back(GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i));
+
+    UseAsRenderTarget();
+    InvalidateAttachments(invalidAttachments);
+    RestoreDefaultRenderTarget();
+    return;
+}
+
 std::vector<unsigned char> Framebuffer::SaveFrameBufferInCPU(unsigned int bufferID,
     unsigned int width, unsigned int height, int channelNum)
 {
@@ -193,7 +291,8 @@ std::vector<unsigned char> Framebuffer::SaveFrameBufferInCPU(unsigned int buffer
         static_cast<size_t>(width) * height * channelNum);
     GLenum gpuChannel = GetGPUChannelFromCPUChannel(channelNum);
 
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, bufferID);
+    auto& stateCache = GLStateCache::GetInstance();
+    stateCache.BindFramebuffer(GL_READ_FRAMEBUFFER, bufferID);
 
     int initialAlignment;
     glGetIntegerv(GL_PACK_ALIGNMENT, &initialAlignment);    
@@ -201,8 +300,15 @@ std::vector<unsigned char> Framebuffer::SaveFrameBufferInCPU(unsigned int buffer
     glReadPixels(0, 0, width, height, gpuChannel, GL_UNSIGNED_BYTE,
         pixelBuffer.data());
     glPixelStorei(GL_PACK_ALIGNMENT, initialAlignment);
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    stateCache.BindFramebuffer(GL_READ_FRAMEBUFFER, 0);
     return pixelBuffer;
 }
 
+ReadbackHandle Framebuffer::SaveFrameBufferInCPUAsync(unsigned int bufferID,
+    unsigned int width, unsigned int height, int channelNum)
+{
+    return AsyncReadback::GetInstance().RequestFramebuffer(bufferID, 0,
+        static_cast<int>(width), static_cast<int>(height), channelNum);
+}
+
 } // namespace OpenGLFramework::Core
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "ConfigHelpers/TextureConfig.h"
 #include "ConfigHelpers/RenderBufferConfig.h"
+#include "AsyncReadback.h"
 
 #include <glm/glm.hpp>
 
@@ -68,6 +69,25 @@ public:
         StencilClear = GL_STENCIL_BUFFER_BIT
     };
 
+    // Load actions are applied when beginning a pass, and store actions when
+    // ending it. DontCare lets the driver discard the attachment by
+    // glInvalidateFramebuffer if supported, so that e.g. transient depth
+    // is never written back to or read from memory.
+    enum class LoadAction { Load, Clear, DontCare };
+    enum class StoreAction { Store, DontCare };
+    struct AttachmentAction
+    {
+        LoadAction load = LoadAction::Load;
+        StoreAction store = StoreAction::Store;
+    };
+    struct PassAction
+    {
+        AttachmentAction depth{};
+        // Indexed by color attachments; missing ones are loaded and stored.
+        std::vector<AttachmentAction> colors{};
+        float clearDepth = 1.0f;
+    };
+
     Framebuffer(unsigned int init_width = s_randomLen_,
         unsigned int init_height = s_randomLen_,
         std::variant<std::monostate, RenderBufferConfigCRef, TexParamConfigCRef>
@@ -82,6 +102,9 @@ public:
 
     static std::vector<unsigned char> SaveFrameBufferInCPU(unsigned int bufferID,
         unsigned int width, unsigned int height, int channelNum);
+    // Same as above, but pixels are read into PBOs without stall.
+    static ReadbackHandle SaveFrameBufferInCPUAsync(unsigned int bufferID,
+        unsigned int width, unsigned int height, int channelNum);
 
     unsigned int GetWidth() const { return width_; }
     unsigned int GetHeight() const { return height_; }
@@ -112,15 +135,28 @@ public:
     }
     void UseAsRenderTarget() const;
     static void RestoreDefaultRenderTarget();
+
+    // Bind as render target and apply load actions; colors are cleared to
+    // backgroundColor. NOTICE: clears are affected by color and depth masks.
+    void BeginPass(const PassAction& action) const;
+    // Apply store actions and restore the default render target.
+    void EndPass(const PassAction& action) const;
+    // Discard all attachments, e.g. when contents are no longer needed.
+    void Invalidate() const;
 private:
     unsigned int frameBuffer_ = 0;
     AttachType depthBuffer_;
+    // GL_NONE if there is no depth buffer.
+    GLenum depthAttachment_ = GL_NONE;
     std::vector<AttachType> colorBuffers_;
 
     unsigned int width_;
     unsigned int height_;
     static const unsigned int s_randomLen_ = 1000u;
 
+    // Allocate immutable storage in the format of ref.genConfig, and apply ref.
+    unsigned int GenerateTextureStorage_(TexParamConfigCRef ref,
+        const TextureGenConfig& defaultGenConfig);
     void GenerateAndAttachDepthBuffer_(RenderBufferConfigCRef ref);
     void GenerateAndAttachDepthBuffer_(TexParamConfigCRef ref);
 
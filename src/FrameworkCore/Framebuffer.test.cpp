@@ -4,14 +4,113 @@
 #include "SpecialModels/SpecialModel.h"
 #include "Camera.h"
 #include "Framebuffer.h"
+#include "GLStateCache.h"
 #include "../Utility/IO/IniFile.h"
 
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
 #include <glm/glm.hpp>
 #include <imgui.h>
 
+#include <array>
+
 using namespace OpenGLFramework::Core;
 OpenGLFramework::IOExtension::IniFile config{ TEST_CONFIG_PATH };
 
+static int GetInternalFormat(unsigned int texture)
+{
+    int format = 0;
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &format);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    GLStateCache::GetInstance().Invalidate();
+    return format;
+}
+
+TEST_CASE("Sized-Attachments")
+{
+    using enum TextureGenConfig::SizedPixelFormat;
+    const TextureParamConfig depthConfig{
+        .minFilter = TextureParamConfig::MinFilterType::Nearest,
+        .genConfig = TextureGenConfig{ .sizedPixelFormat = Depth16 }
+    };
+    const TextureParamConfig hdrConfig{
+        .minFilter = TextureParamConfig::MinFilterType::Linear,
+        .genConfig = TextureGenConfig{ .sizedPixelFormat = R11G11B10F }
+    };
+    const TextureParamConfig momentConfig{
+        .minFilter = TextureParamConfig::MinFilterType::LinearAfterMIPMAPLinear,
+        .genConfig = TextureGenConfig{ .sizedPixelFormat = RG16F }
+    };
+    const TextureParamConfig maskConfig{
+        .minFilter = TextureParamConfig::MinFilterType::Nearest,
+        .genConfig = TextureGenConfig{ .sizedPixelFormat = R8 }
+    };
+
+    Framebuffer framebuffer{ 32, 32, depthConfig,
+        { hdrConfig, momentConfig, maskConfig } };
+    framebuffer.UseAsRenderTarget();
+    REQUIRE(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+    Framebuffer::RestoreDefaultRenderTarget();
+
+    REQUIRE(GetInternalFormat(framebuffer.GetDepthBuffer()) == GL_DEPTH_COMPONENT16);
+    REQUIRE(GetInternalFormat(framebuffer.GetColorBuffer(0)) == GL_R11F_G11F_B10F);
+    REQUIRE(GetInternalFormat(framebuffer.GetColorBuffer(1)) == GL_RG16F);
+    REQUIRE(GetInternalFormat(framebuffer.GetColorBuffer(2)) == GL_R8);
+
+    // A min filter using MIPMAPs allocates the whole chain ahead.
+    int lastLevelWidth = 0;
+    glBindTexture(GL_TEXTURE_2D, framebuffer.GetColorBuffer(1));
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 5, GL_TEXTURE_WIDTH, &lastLevelWidth);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    GLStateCache::GetInstance().Invalidate();
+    REQUIRE(lastLevelWidth == 1);
+
+    REQUIRE(glGetError() == GL_NO_ERROR);
+}
+
+static std::array<unsigned char, 3> GetPixel(const Framebuffer& buffer, int attachment)
+{
+    std::array<unsigned char, 3> pixel{};
+    auto& stateCache = GLStateCache::GetInstance();
+    stateCache.BindFramebuffer(GL_READ_FRAMEBUFFER, buffer.GetFramebuffer());
+    glReadBuffer(GL_COLOR_ATTACHMENT0 + attachment);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, 1, 1, GL_RGB, GL_UNSIGNED_BYTE, pixel.data());
+    stateCache.BindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    return pixel;
+}
+
+TEST_CASE("Pass-Actions")
+{
+    using enum Framebuffer::LoadAction;
+    const auto& colorConfig = Framebuffer::GetColorTextureDefaultParamConfig();
+    Framebuffer buffer{ 16, 16, Framebuffer::GetDepthRenderBufferDefaultConfig(),
+        { colorConfig, colorConfig } };
+
+    buffer.backgroundColor = { 1, 0, 0, 1 };
+    buffer.BeginPass({ .depth = { .load = Clear },
+        .colors = { { .load = Clear }, { .load = Clear } } });
+    buffer.EndPass({});
+    REQUIRE(GetPixel(buffer, 0) == std::array<unsigned char, 3>{ 255, 0, 0 });
+    REQUIRE(GetPixel(buffer, 1) == std::array<unsigned char, 3>{ 255, 0, 0 });
+
+    // Only the second attachment is cleared, and depth is discarded.
+    const Framebuffer::PassAction action{
+        .depth = { .load = DontCare, .store = Framebuffer::StoreAction::DontCare },
+        .colors = { { .load = Load }, { .load = Clear } }
+    };
+    buffer.backgroundColor = { 0, 1, 0, 1 };
+    buffer.BeginPass(action);
+    buffer.EndPass(action);
+    REQUIRE(GetPixel(buffer, 0) == std::array<unsigned char, 3>{ 255, 0, 0 });
+    REQUIRE(GetPixel(buffer, 1) == std::array<unsigned char, 3>{ 0, 255, 0 });
+
+    buffer.Invalidate();
+    REQUIRE(glGetError() == GL_NO_ERROR);
+}
+
 void SetMVP(float width, float height, float near, float far,
     BasicTriRenderModel& model, Camera& camera, Shader& shader)
 {
@@ -32,6 +131,8 @@ int main()
 {
     [[maybe_unused]] ContextManager& manager = ContextManager::GetInstance();
     MainWindow window{ 800, 600, "Test"};
+    if (auto result = Catch::Session().run(); result != 0)
+        return result;
 
     auto model = Cube::GetBasicTriRenderModel();
     Shader shader{ config.rootSection.GetEntry("Vert_Shader")->get(),
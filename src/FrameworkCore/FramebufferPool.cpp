@@ -0,0 +1,115 @@
+#include "FramebufferPool.h"
+
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace OpenGLFramework::Core
+{
+
+// Framebuffer only refers to configs while creating attachments.
+static Framebuffer CreateFramebuffer(const FramebufferDesc& desc)
+{
+    using DepthConfigRef = std::variant<std::monostate,
+        std::reference_wrapper<const RenderBufferConfig>,
+        std::reference_wrapper<const TextureParamConfig>>;
+    auto depthConfig = std::visit([](const auto& config) -> DepthConfigRef {
+        if constexpr (std::is_same_v<std::decay_t<decltype(config)>, std::monostate>)
+            return config;
+        else
+            return std::cref(config);
+    }, desc.depthConfig);
+
+    std::vector<Framebuffer::ConfigType> colorConfigs;
+    colorConfigs.reserve(desc.colorConfigs.size());
+    for (const auto& colorConfig : desc.colorConfigs)
+    {
+        colorConfigs.push_back(std::visit([](const auto& config) -> Framebuffer::ConfigType {
+            return std::cref(config);
+        }, colorConfig));
+    }
+    return Framebuffer{ desc.width, desc.height, depthConfig, colorConfigs };
+}
+
+PooledFramebuffer::PooledFramebuffer(PooledFramebuffer&& another) noexcept :
+    desc_{ std::move(another.desc_) },
+    framebuffer_{ std::exchange(another.framebuffer_, std::nullopt) }
+{
+    return;
+}
+
+PooledFramebuffer& PooledFramebuffer::operator=(PooledFramebuffer&& another) noexcept
+{
+    if (&another == this) [[unlikely]]
+        return *this;
+
+    Release_();
+    desc_ = std::move(another.desc_);
+    framebuffer_ = std::exchange(another.framebuffer_, std::nullopt);
+    return *this;
+}
+
+PooledFramebuffer::~PooledFramebuffer()
+{
+    Release_();
+    return;
+}
+
+void PooledFramebuffer::Release_()
+{
+    if (!framebuffer_.has_value())
+        return;
+    FramebufferPool::GetInstance().Release_(std::move(desc_),
+        std::move(*framebuffer_));
+    framebuffer_.reset();
+    return;
+}
+
+FramebufferPool& FramebufferPool::GetInstance()
+{
+    static FramebufferPool pool{};
+    return pool;
+}
+
+PooledFramebuffer FramebufferPool::Acquire(const FramebufferDesc& desc)
+{
+    auto it = std::ranges::find_if(freeEntries_, [this, &desc](const Entry_& entry) {
+        return currFrame_ - entry.releasedFrame >= recycleDelay_ &&
+            entry.desc == desc;
+    });
+    if (it == freeEntries_.end())
+    {
+        statistics_.createdNum++;
+        return PooledFramebuffer{ desc, CreateFramebuffer(desc) };
+    }
+
+    statistics_.recycledNum++;
+    PooledFramebuffer result{ std::move(it->desc), std::move(it->framebuffer) };
+    freeEntries_.erase(it);
+    return result;
+}
+
+void FramebufferPool::Release_(FramebufferDesc desc, Framebuffer framebuffer)
+{
+    freeEntries_.push_back({ std::move(desc), std::move(framebuffer), currFrame_ });
+    return;
+}
+
+void FramebufferPool::EndFrame()
+{
+    currFrame_++;
+    statistics_.deletedNum += std::erase_if(freeEntries_, [this](const Entry_& entry) {
+        return currFrame_ - entry.releasedFrame > evictionDelay_;
+    });
+    return;
+}
+
+void FramebufferPool::Clear()
+{
+    statistics_.deletedNum += freeEntries_.size();
+    freeEntries_.clear();
+    return;
+}
+
+} // namespace OpenGLFramework::Core
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Framebuffer.h"
+
+#include <cstdint>
+#include <optional>
+#include <variant>
+#include <vector>
+
+namespace OpenGLFramework::Core
+{
+
+// Configs are copied, so framebuffers are matched by their size, formats and
+// sample counts rather than the config objects used to describe them.
+struct FramebufferDesc
+{
+    using DepthConfigType = std::variant<std::monostate,
+        RenderBufferConfig, TextureParamConfig>;
+    using ConfigType = std::variant<RenderBufferConfig, TextureParamConfig>;
+
+    unsigned int width = 0, height = 0;
+    DepthConfigType depthConfig = Framebuffer::GetDepthRenderBufferDefaultConfig();
+    std::vector<ConfigType> colorConfigs = {
+        Framebuffer::GetColorTextureDefaultParamConfig()
+    };
+    bool operator==(const FramebufferDesc&) const = default;
+};
+
+// Framebuffer acquired from FramebufferPool, which is given back to the pool
+// when destructed.
+class PooledFramebuffer
+{
+    friend class FramebufferPool;
+public:
+    PooledFramebuffer() = default;
+    PooledFramebuffer(const PooledFramebuffer&) = delete;
+    PooledFramebuffer& operator=(const PooledFramebuffer&) = delete;
+    PooledFramebuffer(PooledFramebuffer&& another) noexcept;
+    PooledFramebuffer& operator=(PooledFramebuffer&& another) noexcept;
+    ~PooledFramebuffer();
+
+    bool IsValid() const { return framebuffer_.has_value(); }
+    Framebuffer& Get() { return *framebuffer_; }
+    const Framebuffer& Get() const { return *framebuffer_; }
+    Framebuffer& operator*() { return *framebuffer_; }
+    const Framebuffer& operator*() const { return *framebuffer_; }
+    Framebuffer* operator->() { return &*framebuffer_; }
+    const Framebuffer* operator->() const { return &*framebuffer_; }
+    const FramebufferDesc& GetDesc() const { return desc_; }
+
+private:
+    FramebufferDesc desc_;
+    std::optional<Framebuffer> framebuffer_;
+
+    PooledFramebuffer(FramebufferDesc desc, Framebuffer framebuffer) :
+        desc_{ std::move(desc) }, framebuffer_{ std::move(framebuffer) } {};
+    void Release_();
+};
+
+// Released framebuffers are kept and handed out again to requests of the
+// same description, so that e.g. resizing back and forth or rebuilding
+// post-process chains doesn't create new textures and renderbuffers. They
+// are recycled only some frames later, so the driver needn't wait for the
+// GPU still using them, and are deleted if unused for a long time.
+class FramebufferPool
+{
+    friend class PooledFramebuffer;
+public:
+    struct Statistics
+    {
+        size_t createdNum = 0;
+        size_t recycledNum = 0;
+        size_t deletedNum = 0;
+    };
+
+    static FramebufferPool& GetInstance();
+    FramebufferPool(const FramebufferPool&) = delete;
+    FramebufferPool& operator=(const FramebufferPool&) = delete;
+
+    // Should be called on the context thread.
+    PooledFramebuffer Acquire(const FramebufferDesc& desc);
+
+    // Called after every swap(see MainWindow::MainLoop).
+    void EndFrame();
+    void SetRecycleDelay(std::uint64_t frameNum) { recycleDelay_ = frameNum; }
+    void SetEvictionDelay(std::uint64_t frameNum) { evictionDelay_ = frameNum; }
+    // Delete all framebuffers not in use.
+    void Clear();
+
+    size_t GetFreeFramebufferNum() const { return freeEntries_.size(); }
+    const Statistics& GetStatistics() const { return statistics_; }
+
+private:
+    struct Entry_
+    {
+        FramebufferDesc desc;
+        Framebuffer framebuffer;
+        std::uint64_t releasedFrame = 0;
+    };
+
+    std::vector<Entry_> freeEntries_;
+    std::uint64_t currFrame_ = 0;
+    std::uint64_t recycleDelay_ = 1;
+    std::uint64_t evictionDelay_ = 120;
+    Statistics statistics_;
+
+    FramebufferPool() = default;
+    ~FramebufferPool() = default;
+    void Release_(FramebufferDesc desc, Framebuffer framebuffer);
+};
+
+} // namespace OpenGLFramework::Core
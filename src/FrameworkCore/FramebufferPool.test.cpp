@@ -0,0 +1,114 @@
+#include "FramebufferPool.h"
+#include "ContextManager.h"
+#include "MainWindow.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+
+using namespace OpenGLFramework::Core;
+
+static const RenderBufferConfig c_multisampleDepthConfig = {
+    .bufferType = RenderBufferConfig::RenderBufferType::Depth,
+    .attachmentType = RenderBufferConfig::AttachmentType::Depth,
+    .samples = 4
+};
+static const RenderBufferConfig c_multisampleColorConfig = {
+    .bufferType = RenderBufferConfig::RenderBufferType::RGBA,
+    .attachmentType = RenderBufferConfig::AttachmentType::Color,
+    .samples = 4
+};
+
+TEST_CASE("Framebuffer-Pool")
+{
+    auto& pool = FramebufferPool::GetInstance();
+    pool.Clear();
+    pool.SetRecycleDelay(1);
+    pool.SetEvictionDelay(4);
+    const FramebufferDesc desc{ .width = 32, .height = 32 };
+
+    unsigned int framebufferID = 0;
+    {
+        auto framebuffer = pool.Acquire(desc);
+        REQUIRE(framebuffer.IsValid());
+        REQUIRE(framebuffer->GetWidth() == 32);
+        framebufferID = framebuffer->GetFramebuffer();
+    }
+    REQUIRE(pool.GetFreeFramebufferNum() == 1);
+
+    SECTION("Frame-delayed recycling")
+    {
+        // Released in the current frame, so it's not handed out yet.
+        auto framebuffer1 = pool.Acquire(desc);
+        REQUIRE(framebuffer1->GetFramebuffer() != framebufferID);
+
+        pool.EndFrame();
+        auto framebuffer2 = pool.Acquire(desc);
+        REQUIRE(framebuffer2->GetFramebuffer() == framebufferID);
+        REQUIRE(pool.GetFreeFramebufferNum() == 0);
+    }
+
+    SECTION("Different description")
+    {
+        pool.EndFrame();
+        auto framebuffer1 = pool.Acquire({ .width = 64, .height = 32 });
+        auto framebuffer2 = pool.Acquire({ .width = 32, .height = 32,
+            .depthConfig = Framebuffer::GetDepthTextureDefaultParamConfig() });
+        REQUIRE(framebuffer1->GetFramebuffer() != framebufferID);
+        REQUIRE(framebuffer2->GetFramebuffer() != framebufferID);
+        REQUIRE(pool.GetFreeFramebufferNum() == 1);
+    }
+
+    SECTION("Equal configs")
+    {
+        // A copy of the config describes the same framebuffer.
+        pool.EndFrame();
+        const auto colorConfig = Framebuffer::GetColorTextureDefaultParamConfig();
+        auto framebuffer = pool.Acquire({ .width = 32, .height = 32,
+            .colorConfigs = { colorConfig } });
+        REQUIRE(framebuffer->GetFramebuffer() == framebufferID);
+    }
+
+    SECTION("Resizing back and forth")
+    {
+        auto framebuffer = pool.Acquire({ .width = 48, .height = 48 });
+        const auto createdNum = pool.GetStatistics().createdNum;
+        for (int i = 0; i < 8; i++)
+        {
+            pool.EndFrame();
+            const unsigned int size = i % 2 == 0 ? 32 : 48;
+            framebuffer = pool.Acquire({ .width = size, .height = size });
+        }
+        REQUIRE(pool.GetStatistics().createdNum == createdNum);
+    }
+
+    SECTION("Eviction")
+    {
+        for (int i = 0; i < 5; i++)
+            pool.EndFrame();
+        REQUIRE(pool.GetFreeFramebufferNum() == 0);
+    }
+
+    SECTION("Multisample")
+    {
+        auto framebuffer = pool.Acquire({ .width = 32, .height = 32,
+            .depthConfig = c_multisampleDepthConfig,
+            .colorConfigs = { c_multisampleColorConfig } });
+        framebuffer->UseAsRenderTarget();
+        REQUIRE(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+        int samples = 0;
+        glGetIntegerv(GL_SAMPLES, &samples);
+        REQUIRE(samples == 4);
+        Framebuffer::RestoreDefaultRenderTarget();
+    }
+
+    pool.SetEvictionDelay(120);
+    REQUIRE(glGetError() == GL_NO_ERROR);
+}
+
+int main()
+{
+    [[maybe_unused]] ContextManager& manager = ContextManager::GetInstance();
+    MainWindow useForContextWindow{ 50, 50, "test", false };
+    auto result = Catch::Session().run();
+    return result;
+}
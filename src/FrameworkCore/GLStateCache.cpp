@@ -0,0 +1,116 @@
+#include "GLStateCache.h"
+
+namespace OpenGLFramework::Core
+{
+
+GLStateCache& GLStateCache::GetInstance()
+{
+    thread_local GLStateCache cache{};
+    return cache;
+}
+
+void GLStateCache::BindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    if (target == GL_FRAMEBUFFER)
+    {
+        if (drawFramebuffer_ == framebuffer && readFramebuffer_ == framebuffer)
+        {
+            currFrameStatistics_.avoidedCalls++;
+            return;
+        }
+        drawFramebuffer_ = readFramebuffer_ = framebuffer;
+        currFrameStatistics_.issuedCalls++;
+        glBindFramebuffer(target, framebuffer);
+        return;
+    }
+
+    auto& cached = target == GL_READ_FRAMEBUFFER ? readFramebuffer_ : 
+        drawFramebuffer_;
+    if (Check_(cached, framebuffer))
+        glBindFramebuffer(target, framebuffer);
+    return;
+}
+
+void GLStateCache::BindTexture(GLenum target, GLuint texture)
+{
+    int targetIndex = target == GL_TEXTURE_2D ? Texture2D :
+        target == GL_TEXTURE_CUBE_MAP ? CubeMap : TargetNum;
+    // Untracked target or unit are just forwarded.
+    if (targetIndex == TargetNum || activeUnit_ >= c_maxTextureUnits_) [[unlikely]]
+    {
+        currFrameStatistics_.issuedCalls++;
+        glBindTexture(target, texture);
+        return;
+    }
+
+    if (Check_(textures_[activeUnit_][targetIndex], texture))
+        glBindTexture(target, texture);
+    return;
+}
+
+void GLStateCache::SetEnabled(GLenum capability, bool enabled)
+{
+    auto [it, inserted] = capabilities_.try_emplace(capability, enabled);
+    if (!inserted && it->second == enabled)
+    {
+        currFrameStatistics_.avoidedCalls++;
+        return;
+    }
+
+    it->second = enabled;
+    currFrameStatistics_.issuedCalls++;
+    if (enabled)
+        glEnable(capability);
+    else
+        glDisable(capability);
+    return;
+}
+
+void GLStateCache::OnProgramDeleted(GLuint program)
+{
+    // A program in use is only flagged for deletion, so just forget it.
+    if (program_ == program)
+        program_ = c_unknown_;
+    return;
+}
+
+void GLStateCache::OnVertexArrayDeleted(GLuint vertexArray)
+{
+    if (vertexArray_ == vertexArray)
+        vertexArray_ = 0;
+    return;
+}
+
+void GLStateCache::OnFramebufferDeleted(GLuint framebuffer)
+{
+    if (drawFramebuffer_ == framebuffer)
+        drawFramebuffer_ = 0;
+    if (readFramebuffer_ == framebuffer)
+        readFramebuffer_ = 0;
+    return;
+}
+
+void GLStateCache::OnTextureDeleted(GLuint texture)
+{
+    for (auto& unit : textures_)
+    {
+        for (auto& bindTexture : unit)
+        {
+            if (bindTexture == texture)
+                bindTexture = 0;
+        }
+    }
+    return;
+}
+
+void GLStateCache::Invalidate()
+{
+    program_ = vertexArray_ = drawFramebuffer_ = readFramebuffer_ = c_unknown_;
+    activeUnit_ = c_unknown_;
+    for (auto& unit : textures_)
+        unit.fill(c_unknown_);
+    capabilities_.clear();
+    return;
+}
+
+} // namespace OpenGLFramework::Core
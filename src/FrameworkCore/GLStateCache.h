@@ -0,0 +1,103 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <unordered_map>
+
+namespace OpenGLFramework::Core
+{
+
+// Shadow copy of binding and enable states, so that binds to the state
+// already set are skipped. FrameworkCore routes its binds through here;
+// after changing these states by raw GL calls, call Invalidate so that the
+// following binds are always issued. States belong to the context current on
+// the thread, so each thread has its own cache(e.g. the upload worker).
+class GLStateCache
+{
+    static constexpr GLuint c_unknown_ = std::numeric_limits<GLuint>::max();
+    static constexpr int c_maxTextureUnits_ = 32;
+    enum TextureTarget_ { Texture2D, CubeMap, TargetNum };
+
+public:
+    struct Statistics
+    {
+        size_t issuedCalls = 0;
+        size_t avoidedCalls = 0;
+    };
+
+    static GLStateCache& GetInstance();
+    GLStateCache(const GLStateCache&) = delete;
+    GLStateCache& operator=(const GLStateCache&) = delete;
+
+    void UseProgram(GLuint program) {
+        if (Check_(program_, program))
+            glUseProgram(program);
+    }
+    void BindVertexArray(GLuint vertexArray) {
+        if (Check_(vertexArray_, vertexArray))
+            glBindVertexArray(vertexArray);
+    }
+
+    // GL_FRAMEBUFFER sets both draw and read framebuffers.
+    void BindFramebuffer(GLenum target, GLuint framebuffer);
+
+    void ActiveTexture(GLuint unit) {
+        if (Check_(activeUnit_, unit))
+            glActiveTexture(GL_TEXTURE0 + unit);
+    }
+    // Bind on the active unit, e.g. to upload data.
+    void BindTexture(GLenum target, GLuint texture);
+    void BindTexture(GLuint unit, GLenum target, GLuint texture) {
+        ActiveTexture(unit);
+        BindTexture(target, texture);
+    }
+
+    void SetEnabled(GLenum capability, bool enabled);
+
+    // GL resets bindings of deleted objects to 0, and may reuse their names.
+    void OnProgramDeleted(GLuint program);
+    void OnVertexArrayDeleted(GLuint vertexArray);
+    void OnFramebufferDeleted(GLuint framebuffer);
+    void OnTextureDeleted(GLuint texture);
+    void Invalidate();
+
+    // Called after every swap(see MainWindow::MainLoop).
+    void EndFrame() {
+        lastFrameStatistics_ = currFrameStatistics_;
+        currFrameStatistics_ = {};
+    }
+    const Statistics& GetLastFrameStatistics() const { return lastFrameStatistics_; }
+    const Statistics& GetCurrFrameStatistics() const { return currFrameStatistics_; }
+
+private:
+    GLuint program_ = c_unknown_;
+    GLuint vertexArray_ = c_unknown_;
+    GLuint drawFramebuffer_ = c_unknown_;
+    GLuint readFramebuffer_ = c_unknown_;
+    GLuint activeUnit_ = c_unknown_;
+    std::array<std::array<GLuint, TargetNum>, c_maxTextureUnits_> textures_;
+    std::unordered_map<GLenum, bool> capabilities_;
+
+    Statistics currFrameStatistics_;
+    Statistics lastFrameStatistics_;
+
+    GLStateCache() { Invalidate(); }
+    ~GLStateCache() = default;
+
+    // Return whether the call should be issued, and record the new state.
+    bool Check_(GLuint& cached, GLuint value) {
+        if (cached == value)
+        {
+            currFrameStatistics_.avoidedCalls++;
+            return false;
+        }
+        cached = value;
+        currFrameStatistics_.issuedCalls++;
+        return true;
+    }
+};
+
+} // namespace OpenGLFramework::Core
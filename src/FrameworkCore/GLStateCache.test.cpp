@@ -0,0 +1,114 @@
+#include "GLStateCache.h"
+#include "ContextManager.h"
+#include "MainWindow.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+
+using namespace OpenGLFramework::Core;
+
+static GLint GetInteger(GLenum name)
+{
+    GLint value = 0;
+    glGetIntegerv(name, &value);
+    return value;
+}
+
+TEST_CASE("GL-State-Cache")
+{
+    auto& stateCache = GLStateCache::GetInstance();
+    stateCache.Invalidate();
+
+    GLuint textures[2];
+    glGenTextures(2, textures);
+
+    SECTION("Redundant binds are avoided")
+    {
+        stateCache.EndFrame();
+        stateCache.BindTexture(1, GL_TEXTURE_2D, textures[0]);
+        const auto issued = stateCache.GetCurrFrameStatistics().issuedCalls;
+        for (int i = 0; i < 10; i++)
+            stateCache.BindTexture(1, GL_TEXTURE_2D, textures[0]);
+
+        const auto& statistics = stateCache.GetCurrFrameStatistics();
+        REQUIRE(statistics.issuedCalls == issued);
+        REQUIRE(statistics.avoidedCalls == 20); // active unit + texture.
+        REQUIRE(GetInteger(GL_ACTIVE_TEXTURE) == GL_TEXTURE0 + 1);
+        REQUIRE(GetInteger(GL_TEXTURE_BINDING_2D) ==
+            static_cast<GLint>(textures[0]));
+
+        stateCache.EndFrame();
+        REQUIRE(stateCache.GetLastFrameStatistics().avoidedCalls == 20);
+        REQUIRE(stateCache.GetCurrFrameStatistics().avoidedCalls == 0);
+    }
+
+    SECTION("Units and targets are tracked separately")
+    {
+        stateCache.BindTexture(0, GL_TEXTURE_2D, textures[0]);
+        stateCache.BindTexture(1, GL_TEXTURE_2D, textures[1]);
+        stateCache.BindTexture(0, GL_TEXTURE_2D, textures[0]);
+        REQUIRE(GetInteger(GL_ACTIVE_TEXTURE) == GL_TEXTURE0);
+        REQUIRE(GetInteger(GL_TEXTURE_BINDING_2D) ==
+            static_cast<GLint>(textures[0]));
+        stateCache.ActiveTexture(1);
+        REQUIRE(GetInteger(GL_TEXTURE_BINDING_2D) ==
+            static_cast<GLint>(textures[1]));
+    }
+
+    SECTION("Framebuffer targets")
+    {
+        GLuint framebuffer = 0;
+        glGenFramebuffers(1, &framebuffer);
+        stateCache.BindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        stateCache.BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        REQUIRE(GetInteger(GL_DRAW_FRAMEBUFFER_BINDING) == 0);
+        REQUIRE(GetInteger(GL_READ_FRAMEBUFFER_BINDING) ==
+            static_cast<GLint>(framebuffer));
+
+        stateCache.OnFramebufferDeleted(framebuffer);
+        glDeleteFramebuffers(1, &framebuffer);
+        REQUIRE(GetInteger(GL_READ_FRAMEBUFFER_BINDING) == 0);
+        // Cache knows it's 0 now.
+        stateCache.EndFrame();
+        stateCache.BindFramebuffer(GL_FRAMEBUFFER, 0);
+        REQUIRE(stateCache.GetCurrFrameStatistics().issuedCalls == 0);
+    }
+
+    SECTION("Deleted names are forgotten")
+    {
+        stateCache.BindTexture(0, GL_TEXTURE_2D, textures[0]);
+        stateCache.OnTextureDeleted(textures[0]);
+        glDeleteTextures(1, &textures[0]);
+
+        // GL may hand out the same name again, which must be bound anew.
+        glGenTextures(1, &textures[0]);
+        stateCache.BindTexture(0, GL_TEXTURE_2D, textures[0]);
+        REQUIRE(GetInteger(GL_TEXTURE_BINDING_2D) ==
+            static_cast<GLint>(textures[0]));
+    }
+
+    SECTION("Invalidate after raw GL calls")
+    {
+        stateCache.SetEnabled(GL_BLEND, true);
+        glDisable(GL_BLEND);
+        stateCache.SetEnabled(GL_BLEND, true);
+        REQUIRE(glIsEnabled(GL_BLEND) == GL_FALSE);
+
+        stateCache.Invalidate();
+        stateCache.SetEnabled(GL_BLEND, true);
+        REQUIRE(glIsEnabled(GL_BLEND) == GL_TRUE);
+        stateCache.SetEnabled(GL_BLEND, false);
+    }
+
+    stateCache.OnTextureDeleted(textures[0]);
+    stateCache.OnTextureDeleted(textures[1]);
+    glDeleteTextures(2, textures);
+}
+
+int main()
+{
+    [[maybe_unused]] ContextManager& manager = ContextManager::GetInstance();
+    MainWindow useForContextWindow{ 50, 50, "test", false };
+    auto result = Catch::Session().run();
+    return result;
+}
@@ -1,14 +1,21 @@
 #include "MainWindow.h"
+#include "ContextManager.h"
+#include "GLStateCache.h"
+#include "FramebufferPool.h"
+#include "FrameScheduler.h"
 #include "Utility/IO/IOExtension.h"
+#include "Utility/Threading/JobSystem.h"
 
 #define STBI_WINDOWS_UTF8
 #include <stb_image.h>
-#include <stb_image_write.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 
+#include <algorithm>
 #include <limits>
 #include <exception>
+#include <thread>
+#include <utility>
 
 namespace OpenGLFramework::Core
 {
@@ -19,6 +26,13 @@ std::function<void(double, double)> MainWindow::s_cursorPosCallback_;
 
 bool MainWindow::singletonFlag_ = true;
 
+MainWindow::InputBindings_::InputBindings_(int codeNum) : isDown(codeNum)
+{
+    for (auto& list : funcs)
+        list.resize(codeNum);
+    return;
+}
+
 MainWindow::MainWindow() : deltaTime_(0.0f), currTime_(0.0f), window_(nullptr)
 {}
 
@@ -46,6 +60,15 @@ MainWindow::MainWindow(unsigned int init_width, unsigned int init_height,
         return;
     }
     glfwMakeContextCurrent(newWindow);
+    // Set before ImGui, which chains to callbacks installed previously.
+    glfwSetWindowUserPointer(newWindow, this);
+    glfwSetKeyCallback(newWindow, KeyCallback_);
+    glfwSetMouseButtonCallback(newWindow, MouseButtonCallback_);
+    glfwSetCursorPosCallback(newWindow, CursorPosCallback_);
+    glfwSetScrollCallback(newWindow, ScrollCallback_);
+    glfwSetCharCallback(newWindow, CharCallback_);
+    glfwSetFramebufferSizeCallback(newWindow, FramebufferSizeCallback_);
+    glfwSetWindowRefreshCallback(newWindow, RefreshCallback_);
     if(gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)) == 0) 
         [[unlikely]]
         IOExtension::LogError("Fail to initialize GLAD.");
@@ -62,6 +85,14 @@ MainWindow::~MainWindow()
 {
     if (window_ != nullptr)
     {
+        // Pending captures need the context to be read back.
+        capture_.reset();
+        AsyncReadback::GetInstance().ReleaseResources();
+        FrameScheduler::GetInstance().ReleaseResources();
+        ContextManager::GetInstance().ReleaseUploadWorker();
+        // Released last since resources above may give framebuffers back,
+        // which would otherwise be deleted at exit without a context.
+        FramebufferPool::GetInstance().Clear();
         glfwDestroyWindow(window_);
         singletonFlag_ = true;
     }
@@ -70,13 +101,17 @@ MainWindow::~MainWindow()
 
 MainWindow::MainWindow(MainWindow&& another) noexcept:
     deltaTime_{ 0.0f }, currTime_{0.0f},
-    window_{ another.window_ }, routineList_{std::move(routineList_)},
-    pressedList_{ std::move(another.pressedList_) }, 
-    pressingList_{ std::move(another.pressingList_) },
-    releasedList_{std::move(another.releasedList_)},
-    releasingList_{std::move(another.releasingList_)}
+    window_{ another.window_ }, routineList_{ std::move(another.routineList_) },
+    inputBindings_{ std::move(another.inputBindings_) },
+    inputEvents_{ std::move(another.inputEvents_) },
+    capture_{ std::move(another.capture_) }, onDemand_{ another.onDemand_ },
+    pendingFrameNum_{ another.pendingFrameNum_ },
+    minFrameDuration_{ another.minFrameDuration_ },
+    frameDeadline_{ another.frameDeadline_ }, sleepDuration_{ another.sleepDuration_ }
 {
     another.window_ = nullptr;
+    if (window_ != nullptr)
+        glfwSetWindowUserPointer(window_, this);
 };
 
 MainWindow& MainWindow::operator=(MainWindow&& another) noexcept
@@ -85,13 +120,19 @@ MainWindow& MainWindow::operator=(MainWindow&& another) noexcept
 
     window_ = another.window_;
     another.window_ = nullptr;
-    routineList_ = std::move(routineList_);
-    pressedList_ = std::move(another.pressedList_);
-    pressingList_ = std::move(another.pressingList_);
-    releasedList_ = std::move(another.releasedList_);
-    releasingList_ = std::move(another.releasingList_);
+    if (window_ != nullptr)
+        glfwSetWindowUserPointer(window_, this);
+    routineList_ = std::move(another.routineList_);
+    inputBindings_ = std::move(another.inputBindings_);
+    inputEvents_ = std::move(another.inputEvents_);
+    capture_ = std::move(another.capture_);
     deltaTime_ = another.deltaTime_;
     currTime_ = another.currTime_;
+    onDemand_ = another.onDemand_;
+    pendingFrameNum_ = another.pendingFrameNum_;
+    minFrameDuration_ = another.minFrameDuration_;
+    frameDeadline_ = another.frameDeadline_;
+    sleepDuration_ = another.sleepDuration_;
     return *this;
 };
 
@@ -99,6 +140,22 @@ void MainWindow::MainLoop(const glm::vec4& backgroundColor)
 {
     while (!glfwWindowShouldClose(window_))
     {
+        if (onDemand_ && !NeedRedraw_())
+        {
+            // Wake up regularly so that pending readbacks and uploads are
+            // still finished, and show uploaded assets.
+            glfwWaitEventsTimeout(0.1);
+            AsyncReadback::GetInstance().Poll();
+            if (ContextManager::GetInstance().PollUploadWorker() > 0)
+                RequestRedraw();
+            // Idle time isn't counted, so that e.g. camera movement doesn't
+            // jump in the next frame.
+            currTime_ = static_cast<float>(glfwGetTime()) - deltaTime_;
+            continue;
+        }
+        if (pendingFrameNum_ > 0)
+            pendingFrameNum_--;
+
         glClearColor(backgroundColor.r, backgroundColor.g, backgroundColor.b, 
             backgroundColor.a);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -107,162 +164,315 @@ void MainWindow::MainLoop(const glm::vec4& backgroundColor)
 
         const auto [m_width, m_height] = GetWidthAndHeight();
         glViewport(0, 0, m_width, m_height);
-        glEnable(GL_DEPTH_TEST);
+        GLStateCache::GetInstance().SetEnabled(GL_DEPTH_TEST, true);
 
         ImGui_ImplOpenGL3_NewFrame();
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
 
-        currRoutineID_ = 0;
-        for (auto& func : routineList_)
-        {
-            std::invoke(func);
-            currRoutineID_++;
-        }
-
-        for (auto& list : pressedList_)
-        {
-            for (auto& func : list)
-            {
-                std::invoke(func.second);
-            }
-        }
-
-        for (auto& list : pressingList_)
-        {
-            for (auto& func : list)
-            {
-                std::invoke(func.second);
-            }
-        }
-
-        for (auto& list : releasedList_)
-        {
-            for (auto& func : list)
-            {
-                std::invoke(func.second);
-            }
-        }
-
-        for (auto& list : releasingList_)
-        {
-            for (auto& func : list)
-            {
-                std::invoke(func.second);
-            }
-        }
+        FrameScheduler::GetInstance().Tick();
+        RunRoutines_();
+        DispatchInputEvents_();
 
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
         glfwSwapBuffers(window_);
+        AsyncReadback::GetInstance().Poll();
+        if (ContextManager::GetInstance().PollUploadWorker() > 0)
+            RequestRedraw();
+        GLStateCache::GetInstance().EndFrame();
+        FramebufferPool::GetInstance().EndFrame();
+        if (capture_ != nullptr)
+            capture_->Update(*this);
+        LimitFrameRate_();
         glfwPollEvents();
     }
     return;
 };
 
-void MainWindow::Register(UpdateFunc&& func)
+MainWindow::RoutineID MainWindow::Register(UpdateFunc&& func)
 {
-    routineList_.push_back(std::move(func));
+    return Register(std::move(func), RoutineAffinity::GLThread);
 }
 
-void MainWindow::Register(UpdateFunc& func)
+MainWindow::RoutineID MainWindow::Register(UpdateFunc& func)
 {
-    routineList_.push_back(func);
+    return Register(UpdateFunc{ func }, RoutineAffinity::GLThread);
 };
 
+MainWindow::RoutineID MainWindow::Register(UpdateFunc func,
+    RoutineAffinity affinity, std::initializer_list<RoutineID> dependencies)
+{
+    const RoutineID id = routineList_.size();
+    Routine_ routine{ .func = std::move(func), .affinity = affinity };
+    for (auto dependency : dependencies)
+    {
+        if (dependency >= id) [[unlikely]]
+        {
+            IOExtension::LogError("Dependency of a routine should be registered "
+                "before it.");
+            continue;
+        }
+        routine.dependencies.push_back(dependency);
+        routine.glGate = std::max(routine.glGate, routineList_[dependency].glGate);
+    }
+    if (affinity == RoutineAffinity::GLThread)
+        routine.glGate = glRoutineNum_++;
+    routineList_.push_back(std::move(routine));
+    return id;
+}
+
 void MainWindow::ClearRoutines()
 {
     routineList_.clear();
+    glRoutineNum_ = 0;
 }
 
-void MainWindow::BindScrollCallback(std::function<void(double, double)> callback)
+void MainWindow::RunRoutines_()
 {
-    if (callback) // if callback is not empty.
+    // Routines registered by routines run from the next frame.
+    const size_t routineNum = routineList_.size();
+    auto& jobSystem = Threading::JobSystem::GetInstance();
+    std::vector<Threading::TaskHandle> tasks(routineNum), dependencies;
+    auto scheduleAfter = [&](int glGate) {
+        for (RoutineID id = 0; id < routineNum; id++)
+        {
+            const auto& routine = routineList_[id];
+            if (routine.affinity != RoutineAffinity::AnyThread ||
+                routine.glGate != glGate)
+                continue;
+            // Handles of GL routines are empty, which are finished already.
+            dependencies.clear();
+            for (auto dependency : routine.dependencies)
+                dependencies.push_back(tasks[dependency]);
+            // Copied since GL routines may register new ones meanwhile.
+            tasks[id] = jobSystem.Schedule(routine.func, dependencies);
+        }
+    };
+
+    scheduleAfter(-1);
+    for (RoutineID id = 0; id < routineNum; id++)
     {
-        s_scrollCallback_ = std::move(callback);
-        glfwSetScrollCallback(window_, 
-            []([[maybe_unused]]GLFWwindow* window, double xOffset, double yOffset) {
-                s_scrollCallback_(xOffset, yOffset);
-            });
+        if (routineList_[id].affinity != RoutineAffinity::GLThread)
+            continue;
+        // Other tasks are run when waiting, so the thread isn't wasted.
+        for (auto dependency : routineList_[id].dependencies)
+            jobSystem.Wait(tasks[dependency]);
+        currRoutineID_ = id;
+        std::invoke(routineList_[id].func);
+        scheduleAfter(routineList_[id].glGate);
     }
-    else
+
+    for (const auto& task : tasks)
+        jobSystem.Wait(task);
+    return;
+}
+
+void MainWindow::BindInput_(InputHandleBindType type, InputAction_ action,
+    int code, UpdateFunc&& func)
+{
+    auto& bindings = inputBindings_[static_cast<int>(type)];
+    bindings.funcs[static_cast<int>(action)][code] = std::move(func);
+    if (action != InputAction_::Pressing && action != InputAction_::Releasing)
+        return;
+
+    auto& levelCodes = bindings.levelCodes;
+    const bool isLevelBound =
+        bindings.funcs[static_cast<int>(InputAction_::Pressing)][code] != nullptr ||
+        bindings.funcs[static_cast<int>(InputAction_::Releasing)][code] != nullptr;
+    auto it = std::ranges::find(levelCodes, code);
+    if (isLevelBound && it == levelCodes.end())
+        levelCodes.push_back(code);
+    else if (!isLevelBound && it != levelCodes.end())
+        levelCodes.erase(it);
+    return;
+}
+
+void MainWindow::KeyCallback_(GLFWwindow* window, int key,
+    [[maybe_unused]] int scancode, int action, [[maybe_unused]] int mods)
+{
+    auto mainWindow = static_cast<MainWindow*>(glfwGetWindowUserPointer(window));
+    mainWindow->OnInputEvent_(InputHandleBindType::Key, key, action);
+    return;
+}
+
+void MainWindow::MouseButtonCallback_(GLFWwindow* window, int button,
+    int action, [[maybe_unused]] int mods)
+{
+    auto mainWindow = static_cast<MainWindow*>(glfwGetWindowUserPointer(window));
+    mainWindow->OnInputEvent_(InputHandleBindType::MouseButton, button, action);
+    return;
+}
+
+void MainWindow::OnInputEvent_(InputHandleBindType type, int code, int action)
+{
+    // Repeats don't change the state, and unknown keys can't be bound.
+    auto& bindings = inputBindings_[static_cast<int>(type)];
+    if (action == GLFW_REPEAT || code < 0 ||
+        code >= static_cast<int>(bindings.isDown.size())) [[unlikely]]
+        return;
+
+    bindings.isDown[code] = action == GLFW_PRESS;
+    inputEvents_.push_back({ type, code, action });
+    return;
+}
+
+void MainWindow::DispatchInputEvents_()
+{
+    // Callbacks may bind inputs, so events are indexed instead of iterated.
+    for (size_t i = 0; i < inputEvents_.size(); i++)
+    {
+        const auto event = inputEvents_[i];
+        auto& bindings = inputBindings_[static_cast<int>(event.type)];
+        const auto action = event.action == GLFW_PRESS ?
+            InputAction_::Pressed : InputAction_::Released;
+        if (auto& func = bindings.funcs[static_cast<int>(action)][event.code]; func)
+            std::invoke(func);
+    }
+    inputEvents_.clear();
+
+    for (auto& bindings : inputBindings_)
     {
-        s_scrollCallback_ = nullptr;
-        glfwSetScrollCallback(window_, nullptr);
+        for (size_t i = 0; i < bindings.levelCodes.size(); i++)
+        {
+            const int code = bindings.levelCodes[i];
+            const auto action = bindings.isDown[code] ?
+                InputAction_::Pressing : InputAction_::Releasing;
+            if (auto& func = bindings.funcs[static_cast<int>(action)][code]; func)
+                std::invoke(func);
+        }
     }
     return;
 }
 
+void MainWindow::CursorPosCallback_(GLFWwindow* window, double xPos, double yPos)
+{
+    auto mainWindow = static_cast<MainWindow*>(glfwGetWindowUserPointer(window));
+    mainWindow->RequestRedraw(c_inputRedrawFrameNum_);
+    if (s_cursorPosCallback_)
+        s_cursorPosCallback_(xPos, yPos);
+    return;
+}
+
+void MainWindow::ScrollCallback_(GLFWwindow* window, double xOffset, double yOffset)
+{
+    auto mainWindow = static_cast<MainWindow*>(glfwGetWindowUserPointer(window));
+    mainWindow->RequestRedraw(c_inputRedrawFrameNum_);
+    if (s_scrollCallback_)
+        s_scrollCallback_(xOffset, yOffset);
+    return;
+}
+
+void MainWindow::CharCallback_(GLFWwindow* window, [[maybe_unused]] unsigned int codepoint)
+{
+    auto mainWindow = static_cast<MainWindow*>(glfwGetWindowUserPointer(window));
+    mainWindow->RequestRedraw(c_inputRedrawFrameNum_);
+    return;
+}
+
+void MainWindow::FramebufferSizeCallback_(GLFWwindow* window,
+    [[maybe_unused]] int width, [[maybe_unused]] int height)
+{
+    auto mainWindow = static_cast<MainWindow*>(glfwGetWindowUserPointer(window));
+    mainWindow->RequestRedraw(c_inputRedrawFrameNum_);
+    return;
+}
+
+void MainWindow::RefreshCallback_(GLFWwindow* window)
+{
+    auto mainWindow = static_cast<MainWindow*>(glfwGetWindowUserPointer(window));
+    mainWindow->RequestRedraw();
+    return;
+}
+
+// Callbacks are installed when creating the window so that ImGui also
+// receives the events, and these only change what's forwarded.
+void MainWindow::BindScrollCallback(std::function<void(double, double)> callback)
+{
+    s_scrollCallback_ = std::move(callback);
+    return;
+}
+
 void MainWindow::BindCursorPosCallback(std::function<void(double, double)> callback)
 {
-    if (callback) // if callback is not empty.
-    {
-        s_cursorPosCallback_ = std::move(callback);
-        glfwSetCursorPosCallback(window_, 
-            []([[maybe_unused]] GLFWwindow* window, double xOffset, double yOffset) {
-                s_cursorPosCallback_(xOffset, yOffset);
-            });
-    }
+    s_cursorPosCallback_ = std::move(callback);
+    return;
+}
+
+bool MainWindow::NeedRedraw_() const
+{
+    if (pendingFrameNum_ > 0 || !inputEvents_.empty() ||
+        FrameScheduler::GetInstance().HasWaitingTasks())
+        return true;
+    // Pressing bindings are continuous input, e.g. moving the camera.
+    return std::ranges::any_of(inputBindings_, [](const InputBindings_& bindings) {
+        const auto& pressingFuncs = bindings.funcs[static_cast<int>(InputAction_::Pressing)];
+        return std::ranges::any_of(bindings.levelCodes, [&](int code) {
+            return bindings.isDown[code] && pressingFuncs[code] != nullptr;
+        });
+    });
+}
+
+void MainWindow::SetFrameRateLimit(double maxFPS)
+{
+    if (maxFPS > 0)
+        minFrameDuration_ = std::chrono::duration_cast<Clock_::duration>(
+            std::chrono::duration<double>{ 1.0 / maxFPS });
     else
+        minFrameDuration_ = Clock_::duration::zero();
+    frameDeadline_ = Clock_::now();
+    return;
+}
+
+void MainWindow::LimitFrameRate_()
+{
+    if (minFrameDuration_ == Clock_::duration::zero())
+        return;
+
+    // Frames that are late start a new deadline instead of catching up, which
+    // would render a burst of frames.
+    frameDeadline_ = std::max(frameDeadline_ + minFrameDuration_, Clock_::now());
+
+    // Sleeping may overshoot by a scheduler tick, so only sleep while there is
+    // enough time left for the observed sleep duration and spin the rest.
+    auto now = Clock_::now();
+    while (frameDeadline_ - now > sleepDuration_)
     {
-        s_cursorPosCallback_ = nullptr;
-        glfwSetCursorPosCallback(window_, nullptr);
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+        const auto lastNow = std::exchange(now, Clock_::now());
+        // Rise to oversleeping at once, but decay slowly.
+        sleepDuration_ = std::max(now - lastNow, sleepDuration_ - sleepDuration_ / 64);
     }
+    while (Clock_::now() < frameDeadline_)
+        std::this_thread::yield();
     return;
 }
 
-std::vector<unsigned char> MainWindow::GetPixelsFromGPU_(
-    int width, int height, int channelNum) const
+ReadbackHandle MainWindow::RequestPixelsAsync(int channelNum) const
 {
-    std::vector<unsigned char> pixelBuffer(
-        static_cast<size_t>(width) * height * channelNum);
-    unsigned char* pixelBufferRawPtr = pixelBuffer.data();
-
-    int initialAlignment, initalBuffer;
-    glGetIntegerv(GL_PACK_ALIGNMENT, &initialAlignment);
-    glGetIntegerv(GL_READ_BUFFER, &initalBuffer);
-
-    glPixelStorei(GL_PACK_ALIGNMENT, 1);
-    glReadBuffer(GL_FRONT);
-    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE,
-        pixelBufferRawPtr);
-    glReadBuffer(initalBuffer); // restore settings.
-    glPixelStorei(GL_PACK_ALIGNMENT, initialAlignment);
-    return pixelBuffer;
-};
+    int width, height;
+    glfwGetFramebufferSize(window_, &width, &height);
+    return AsyncReadback::GetInstance().RequestFramebuffer(0, GL_FRONT,
+        width, height, channelNum);
+}
 
-extern const char* GetConvertedPath(std::string& buffer,
-    const std::filesystem::path& path);
+FrameCapture& MainWindow::GetFrameCapture() const
+{
+    if (capture_ == nullptr)
+        capture_ = std::make_unique<FrameCapture>();
+    return *capture_;
+}
 
 void MainWindow::SaveImage(const std::filesystem::path& path, bool needFlip) const
 {
-    auto extension = path.extension().string();
-    std::string pathBuffer;
-    const char* validPath = GetConvertedPath(pathBuffer, path);
+    FrameCapture::SaveImageSync(RequestPixelsAsync(3), path, needFlip);
+    return;
+}
 
-    int width, height, channelNum = 3;
-    glfwGetFramebufferSize(window_, &width, &height);
-    auto pixelBuffer = GetPixelsFromGPU_(width, height, channelNum);
-    auto pixelBufferRawPtr = pixelBuffer.data();
-
-    stbi_flip_vertically_on_write(needFlip);
-    if (extension == ".bmp")
-        stbi_write_bmp(validPath, width, height, channelNum,
-            pixelBufferRawPtr);
-    else if (extension == ".jpg")
-        stbi_write_jpg(validPath, width, height, channelNum, 
-            pixelBufferRawPtr, 95);
-    else if (extension == ".png")
-        stbi_write_png(validPath, width, height, channelNum, 
-            pixelBufferRawPtr, width * channelNum);
-    else // not recognized.
-    {
-        IOExtension::LogError("Unrecognized picture format: " 
-            + extension + ", save as png.\n");
-        stbi_write_png(validPath, width, height, channelNum,
-            pixelBufferRawPtr, width * channelNum);
-    }
-    stbi_flip_vertically_on_write(false);
+void MainWindow::SaveImageAsync(const std::filesystem::path& path,
+    bool needFlip) const
+{
+    GetFrameCapture().SaveImage(RequestPixelsAsync(3), path, needFlip);
     return;
 }
 
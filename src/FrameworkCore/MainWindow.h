@@ -1,14 +1,20 @@
 #pragma once
 
+#include "AsyncReadback.h"
+#include "FrameCapture.h"
+
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 
+#include <algorithm>
 #include <functional>
+#include <initializer_list>
 #include <vector>
-#include <unordered_map>
 #include <array>
 #include <filesystem>
+#include <memory>
+#include <chrono>
 
 namespace OpenGLFramework::Core
 {
@@ -18,8 +24,25 @@ class MainWindow
     using UpdateFunc = std::function<void(void)>;
     constexpr static int handleAmount_ = 2;
     enum class InputHandleBindType { Key = 0, MouseButton = 1 };
-    using InputHandleFunc = decltype(glfwGetKey);
-    using InputToUpdateFuncMap = std::unordered_map<int, UpdateFunc>;
+    enum class InputAction_ { Pressed = 0, Pressing, Released, Releasing, Num };
+
+    // Bindings are indexed by key or mouse button code, so that dispatching
+    // an event is just an index.
+    struct InputBindings_
+    {
+        std::array<std::vector<UpdateFunc>, static_cast<int>(InputAction_::Num)> funcs;
+        std::vector<char> isDown;
+        // Codes bound to Pressing or Releasing, which are checked every frame.
+        std::vector<int> levelCodes;
+        explicit InputBindings_(int codeNum);
+    };
+    struct InputEvent_
+    {
+        InputHandleBindType type;
+        int code;
+        int action;
+    };
+
 public:
     MainWindow();
     MainWindow(unsigned int m_height, unsigned int m_width, const char* title,
@@ -30,156 +53,123 @@ public:
     MainWindow(MainWindow&&) noexcept;
     MainWindow& operator=(MainWindow&&) noexcept;
 
+    using RoutineID = size_t;
+    enum class RoutineAffinity { GLThread, AnyThread };
+
+    // Coroutines spawned on FrameScheduler are resumed before routines.
     void MainLoop(const glm::vec4& backgroundColor);
-    void Register(UpdateFunc&& func);
-    void Register(UpdateFunc& func);
+    RoutineID Register(UpdateFunc&& func);
+    RoutineID Register(UpdateFunc& func);
+    // Routines on the GL thread run in registration order on the context
+    // thread, while ones on any thread, e.g. animation and culling, run
+    // concurrently on the job system once their dependencies are finished,
+    // which mustn't use GL or ImGui. Dependencies should be registered before,
+    // and all routines are finished before input dispatching and rendering ImGui.
+    RoutineID Register(UpdateFunc func, RoutineAffinity affinity,
+        std::initializer_list<RoutineID> dependencies = {});
     void ClearRoutines();
     void BindScrollCallback(std::function<void(double, double)> callback);
     void BindCursorPosCallback(std::function<void(double, double)> callback);
-private:
-    template<int keyCode, InputHandleBindType type>
-    void BindPressed_(UpdateFunc&& func, InputHandleFunc handleFunc)
-    {
-        auto& currList = pressedList_[static_cast<int>(type)];
-        if (func == nullptr) [[unlikely]]
-        { 
-            currList.erase(keyCode);
-            return;
-        }
-
-        static bool lastPress = true;
-        currList.insert_or_assign(keyCode,
-            [func, handleFunc, this]() {
-                if (handleFunc(window_, keyCode) == GLFW_PRESS)
-                {
-                    if (!lastPress)
-                    {
-                        lastPress = true;
-                        std::invoke(func);
-                    }
-                }
-                else // Release.
-                    lastPress = false;
-            });
-        return;
-    }
 
-    template<int keyCode, InputHandleBindType type>
-    void BindPressing_(UpdateFunc&& func, InputHandleFunc handleFunc)
-    {
-        auto& currList = pressingList_[static_cast<int>(type)];
-        if (func == nullptr) [[unlikely]]
-        {
-            currList.erase(keyCode);
-            return;
-        }
-
-        currList.insert_or_assign(keyCode,
-            [func, handleFunc, this]() {
-                if (handleFunc(window_, keyCode) == GLFW_PRESS)
-                    std::invoke(func);
-            });
-        return;
+    // In on-demand mode, frames are only rendered after input, resizing,
+    // RequestRedraw or while a key bound by Pressing is held; otherwise the
+    // loop sleeps until events come. Note that Releasing bindings are then
+    // only triggered in rendered frames, and frame captures don't keep the
+    // loop rendering.
+    void SetOnDemandRendering(bool onDemand) { onDemand_ = onDemand; }
+    // Render at least frameNum more frames, e.g. when the scene is changed
+    // by loading or animations in on-demand mode.
+    void RequestRedraw(int frameNum = 1) {
+        pendingFrameNum_ = std::max(pendingFrameNum_, frameNum);
     }
+    // Sleep after swapping so that at most maxFPS frames are rendered per
+    // second; 0 means no limit.
+    void SetFrameRateLimit(double maxFPS);
+private:
+    // Pressed and Released are triggered by events of the key, while Pressing
+    // and Releasing are triggered every frame by its current state.
+    void BindInput_(InputHandleBindType type, InputAction_ action, int code,
+        UpdateFunc&& func);
+    // Key and mouse button events are queued by GLFW callbacks when polling,
+    // and dispatched in the next frame.
+    void DispatchInputEvents_();
+    void RunRoutines_();
+    static void KeyCallback_(GLFWwindow* window, int key, int scancode,
+        int action, int mods);
+    static void MouseButtonCallback_(GLFWwindow* window, int button,
+        int action, int mods);
+    void OnInputEvent_(InputHandleBindType type, int code, int action);
+    static void CursorPosCallback_(GLFWwindow* window, double xPos, double yPos);
+    static void ScrollCallback_(GLFWwindow* window, double xOffset, double yOffset);
+    static void CharCallback_(GLFWwindow* window, unsigned int codepoint);
+    static void FramebufferSizeCallback_(GLFWwindow* window, int width, int height);
+    static void RefreshCallback_(GLFWwindow* window);
+    bool NeedRedraw_() const;
+    void LimitFrameRate_();
 
-    template<int keyCode, InputHandleBindType type>
-    void BindReleased_(UpdateFunc&& func, InputHandleFunc handleFunc)
-    {
-        auto& currList = releasedList_[static_cast<int>(type)];
-        if (func == nullptr) [[unlikely]]
-        {
-            currList.erase(keyCode);
-            return;
-        }
-
-        static bool lastRelease = true;
-        currList.insert_or_assign(keyCode,
-            [func, handleFunc, this]() {
-                if (handleFunc(window_, keyCode) == GLFW_RELEASE)
-                {
-                    if (!lastRelease)
-                    {
-                        lastRelease = true;
-                        std::invoke(func);
-                    }
-                }
-                else // Press.
-                    lastRelease = false;
-            });
-
-        return;
-    };
-
-    template<int keyCode, InputHandleBindType type>
-    void BindReleasing_(UpdateFunc&& func, InputHandleFunc handleFunc)
-    {
-        auto& currList = releasingList_[static_cast<int>(type)];
-        if (func == nullptr) [[unlikely]]
-        {
-            currList.erase(keyCode);
-            return;
-        }
-
-        currList.insert_or_assign(keyCode,
-            [func, handleFunc, this]() {
-                if (handleFunc(window_, keyCode) == GLFW_RELEASE)
-                    std::invoke(func);
-            });
-        return;
-    };
-
-    std::vector<unsigned char> GetPixelsFromGPU_(int, int, int) const;
 public:
     template<int keyCode>
     void BindKeyPressed(UpdateFunc&& func)
     {
-        BindPressed_<keyCode, InputHandleBindType::Key>(std::move(func), glfwGetKey);
+        static_assert(keyCode >= 0 && keyCode <= GLFW_KEY_LAST);
+        BindInput_(InputHandleBindType::Key, InputAction_::Pressed, keyCode,
+            std::move(func));
     }
 
     template<int keyCode>
     void BindKeyPressing(UpdateFunc&& func)
     {
-        BindPressing_<keyCode, InputHandleBindType::Key>(std::move(func), glfwGetKey);
+        static_assert(keyCode >= 0 && keyCode <= GLFW_KEY_LAST);
+        BindInput_(InputHandleBindType::Key, InputAction_::Pressing, keyCode,
+            std::move(func));
     }
 
     template<int keyCode>
     void BindKeyReleased(UpdateFunc&& func)
     {
-        BindReleased_<keyCode, InputHandleBindType::Key>(std::move(func), glfwGetKey);
+        static_assert(keyCode >= 0 && keyCode <= GLFW_KEY_LAST);
+        BindInput_(InputHandleBindType::Key, InputAction_::Released, keyCode,
+            std::move(func));
     }
 
     template<int keyCode>
     void BindKeyReleasing(UpdateFunc&& func)
     {
-        BindReleasing_<keyCode, InputHandleBindType::Key>(std::move(func), glfwGetKey);
+        static_assert(keyCode >= 0 && keyCode <= GLFW_KEY_LAST);
+        BindInput_(InputHandleBindType::Key, InputAction_::Releasing, keyCode,
+            std::move(func));
     }
 
     template<int mouseButtonCode>
     void BindMouseButtonPressed(UpdateFunc&& func)
     {
-        BindPressed_<mouseButtonCode, InputHandleBindType::MouseButton>(
-            std::move(func), glfwGetMouseButton);
+        static_assert(mouseButtonCode >= 0 && mouseButtonCode <= GLFW_MOUSE_BUTTON_LAST);
+        BindInput_(InputHandleBindType::MouseButton, InputAction_::Pressed,
+            mouseButtonCode, std::move(func));
     }
 
     template<int mouseButtonCode>
     void BindMouseButtonPressing(UpdateFunc&& func)
     {
-        BindPressing_<mouseButtonCode, InputHandleBindType::MouseButton>(
-            std::move(func), glfwGetMouseButton);
+        static_assert(mouseButtonCode >= 0 && mouseButtonCode <= GLFW_MOUSE_BUTTON_LAST);
+        BindInput_(InputHandleBindType::MouseButton, InputAction_::Pressing,
+            mouseButtonCode, std::move(func));
     }
 
     template<int mouseButtonCode>
     void BindMouseButtonReleased(UpdateFunc&& func)
     {
-        BindReleased_<mouseButtonCode, InputHandleBindType::MouseButton>(
-            std::move(func), glfwGetMouseButton);
+        static_assert(mouseButtonCode >= 0 && mouseButtonCode <= GLFW_MOUSE_BUTTON_LAST);
+        BindInput_(InputHandleBindType::MouseButton, InputAction_::Released,
+            mouseButtonCode, std::move(func));
     }
 
     template<int mouseButtonCode>
     void BindMouseButtonReleasing(UpdateFunc&& func)
     {
-        BindReleasing_<mouseButtonCode, InputHandleBindType::MouseButton>(
-            std::move(func), glfwGetMouseButton);
+        static_assert(mouseButtonCode >= 0 && mouseButtonCode <= GLFW_MOUSE_BUTTON_LAST);
+        BindInput_(InputHandleBindType::MouseButton, InputAction_::Releasing,
+            mouseButtonCode, std::move(func));
     }
 
     std::pair<unsigned int, unsigned int> GetWidthAndHeight()
@@ -207,19 +197,52 @@ public:
             glfwShowWindow(window_);
     }
     void Close() const { glfwSetWindowShouldClose(window_, true); }
+    // The file is written once returned, which stalls the pipeline.
     void SaveImage(const std::filesystem::path& path, bool needFlip = true) const;
+    // Pixels are read back asynchronously and encoded on worker threads, see
+    // FrameCapture::Flush to wait for them.
+    void SaveImageAsync(const std::filesystem::path& path,
+        bool needFlip = true) const;
+    // Created on first use, e.g. to capture image sequences.
+    FrameCapture& GetFrameCapture() const;
+    // Read the last presented frame without stall; pixels are bottom-up.
+    ReadbackHandle RequestPixelsAsync(int channelNum = 3) const;
     GLFWwindow* GetNativeHandler() const { return window_; }
     float GetDeltaTime() const { return deltaTime_; }
     float GetCurrTime() const { return currTime_; }
 private:
+    struct Routine_
+    {
+        UpdateFunc func;
+        RoutineAffinity affinity;
+        std::vector<RoutineID> dependencies{};
+        // Index of the routine among GL routines; for others, index of the
+        // last GL routine they depend on directly or indirectly, after which
+        // they're scheduled, or -1 if there's none.
+        int glGate = -1;
+    };
+
     float deltaTime_, currTime_;
     GLFWwindow* window_;
     size_t currRoutineID_ = 0;
-    std::vector<UpdateFunc> routineList_;
-    std::array<InputToUpdateFuncMap, handleAmount_> pressedList_;
-    std::array<InputToUpdateFuncMap, handleAmount_> pressingList_;
-    std::array<InputToUpdateFuncMap, handleAmount_> releasedList_;
-    std::array<InputToUpdateFuncMap, handleAmount_> releasingList_;
+    std::vector<Routine_> routineList_;
+    int glRoutineNum_ = 0;
+    std::array<InputBindings_, handleAmount_> inputBindings_{
+        InputBindings_{ GLFW_KEY_LAST + 1 },
+        InputBindings_{ GLFW_MOUSE_BUTTON_LAST + 1 }
+    };
+    std::vector<InputEvent_> inputEvents_;
+    mutable std::unique_ptr<FrameCapture> capture_;
+
+    using Clock_ = std::chrono::steady_clock;
+    // ImGui needs another frame to settle hovering and layout after input.
+    constexpr static int c_inputRedrawFrameNum_ = 2;
+    bool onDemand_ = false;
+    int pendingFrameNum_ = c_inputRedrawFrameNum_;
+    Clock_::duration minFrameDuration_{};
+    Clock_::time_point frameDeadline_{};
+    // Estimated duration of a short sleep, including the oversleeping.
+    Clock_::duration sleepDuration_ = std::chrono::milliseconds{ 1 };
  
     static std::function<void(double, double)> s_scrollCallback_;
     static std::function<void(double, double)> s_cursorPosCallback_;
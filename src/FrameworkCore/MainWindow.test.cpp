@@ -1,14 +1,157 @@
 #include "ContextManager.h"
 #include "MainWindow.h"
 
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace OpenGLFramework::Core;
+MainWindow* g_window = nullptr;
+
+// Run until a routine closes the window, and reset it for the next test.
+static void RunMainLoop(MainWindow& window)
+{
+    window.MainLoop({ 0, 0, 0, 1 });
+    window.ClearRoutines();
+    glfwSetWindowShouldClose(window.GetNativeHandler(), false);
+    return;
+}
+
+// Feed a key event as GLFW does when polling.
+static void SendKeyEvent(MainWindow& window, int key, int action)
+{
+    auto handle = window.GetNativeHandler();
+    auto callback = glfwSetKeyCallback(handle, nullptr);
+    glfwSetKeyCallback(handle, callback);
+    callback(handle, key, 0, action, 0);
+    return;
+}
+
+TEST_CASE("Input-Bindings")
+{
+    auto& window = *g_window;
+    std::vector<std::string> triggered;
+    window.BindKeyPressed<GLFW_KEY_A>([&triggered]() { triggered.push_back("A pressed"); });
+    window.BindKeyPressed<GLFW_KEY_D>([&triggered]() { triggered.push_back("D pressed"); });
+    window.BindKeyReleased<GLFW_KEY_A>([&triggered]() { triggered.push_back("A released"); });
+    window.BindKeyPressing<GLFW_KEY_S>([&triggered]() { triggered.push_back("S pressing"); });
+
+    // Events are dispatched after routines of the frame they're sent in.
+    int frameNum = 0;
+    window.Register([&]() {
+        switch (++frameNum)
+        {
+        case 1:
+            // Edges are detected per key, and repeats are ignored.
+            SendKeyEvent(window, GLFW_KEY_A, GLFW_PRESS);
+            SendKeyEvent(window, GLFW_KEY_D, GLFW_PRESS);
+            SendKeyEvent(window, GLFW_KEY_D, GLFW_REPEAT);
+            SendKeyEvent(window, GLFW_KEY_A, GLFW_RELEASE);
+            break;
+        case 2:
+            SendKeyEvent(window, GLFW_KEY_S, GLFW_PRESS);
+            break;
+        case 4:
+            SendKeyEvent(window, GLFW_KEY_S, GLFW_RELEASE);
+            SendKeyEvent(window, GLFW_KEY_D, GLFW_RELEASE);
+            break;
+        case 5:
+            window.Close();
+            break;
+        }
+    });
+    RunMainLoop(window);
+    window.BindKeyPressed<GLFW_KEY_A>({});
+    window.BindKeyPressed<GLFW_KEY_D>({});
+    window.BindKeyReleased<GLFW_KEY_A>({});
+    window.BindKeyPressing<GLFW_KEY_S>({});
+
+    REQUIRE(triggered == std::vector<std::string>{ "A pressed", "D pressed",
+        "A released", "S pressing", "S pressing" });
+}
+
+TEST_CASE("On-Demand-Rendering")
+{
+    auto& window = *g_window;
+    int frameNum = 0;
+    window.Register([&frameNum]() { frameNum++; });
+    window.SetOnDemandRendering(true);
+    window.RequestRedraw(3);
+
+    // Routines don't run while idle, so the window is closed by another thread.
+    std::jthread closer{ [&window]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 500 });
+        window.Close();
+        glfwPostEmptyEvent();
+    } };
+    RunMainLoop(window);
+    window.SetOnDemandRendering(false);
+
+    // Only requested frames and ones after window events are rendered.
+    REQUIRE(frameNum >= 3);
+    REQUIRE(frameNum < 10);
+}
+
+TEST_CASE("Frame-Rate-Limit")
+{
+    auto& window = *g_window;
+    int frameNum = 0;
+    window.Register([&window, &frameNum]() {
+        if (++frameNum == 20)
+            window.Close();
+    });
+    window.SetFrameRateLimit(100);
+    const auto start = std::chrono::steady_clock::now();
+    RunMainLoop(window);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    window.SetFrameRateLimit(0);
+
+    // Each frame ends at least 10ms after the last one.
+    REQUIRE(elapsed >= std::chrono::milliseconds{ 190 });
+}
+
+TEST_CASE("Routine-Affinity")
+{
+    auto& window = *g_window;
+    const auto mainThreadID = std::this_thread::get_id();
+    std::atomic<int> countedNum = 0;
+    int frameNum = 0, unfinishedNum = 0;
+    bool onMainThread = true;
+
+    auto counting = window.Register([&countedNum]() { countedNum++; },
+        MainWindow::RoutineAffinity::AnyThread);
+    window.Register([&]() {
+        // Dependencies on the job system are finished before.
+        if (countedNum != ++frameNum)
+            unfinishedNum++;
+        onMainThread = onMainThread && std::this_thread::get_id() == mainThreadID;
+        if (frameNum == 10)
+            window.Close();
+    }, MainWindow::RoutineAffinity::GLThread, { counting });
+    RunMainLoop(window);
+
+    REQUIRE(countedNum == 10);
+    REQUIRE(unfinishedNum == 0);
+    REQUIRE(onMainThread);
+}
 
 int main()
 {
     [[maybe_unused]]ContextManager& manager = ContextManager::GetInstance();
     MainWindow mainWindow{ 800, 600, "Title test" };
+    g_window = &mainWindow;
+    // Hidden so that cursor movement doesn't disturb frames counted by tests.
+    mainWindow.Hide();
+    if (auto result = Catch::Session().run(); result != 0)
+        return result;
+    mainWindow.Hide(false);
+
     mainWindow.Register([]() {
         static int i = 0;
         if(i < 10)
@@ -0,0 +1,35 @@
+#include "Material.h"
+#include "GLStateCache.h"
+
+namespace OpenGLFramework::Core
+{
+
+Material::Material(const Shader& shader,
+    std::span<const MaterialTexture> textures) : shaderSerial_{ shader.GetSerial() }
+{
+    bindings_.reserve(textures.size());
+    for (const auto& texture : textures)
+    {
+        UniformID sampler{ texture.samplerName };
+        if (shader.GetUniformLocation(sampler) < 0)
+            continue;
+        bindings_.push_back({ sampler, texture.target, texture.texture });
+    }
+    return;
+}
+
+int Material::Apply(const Shader& shader) const
+{
+    auto& stateCache = GLStateCache::GetInstance();
+    for (int unit = 0; const auto& binding : bindings_)
+    {
+        // Units are same as the last draw for most meshes, so the upload is
+        // skipped if the shader skips redundant uploads.
+        shader.SetInt(binding.sampler, unit);
+        stateCache.BindTexture(unit, binding.target, binding.texture);
+        unit++;
+    }
+    return GetTextureUnitNum();
+}
+
+} // namespace OpenGLFramework::Core
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Shader.h"
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace OpenGLFramework::Core
+{
+
+struct MaterialTexture
+{
+    std::string_view samplerName;
+    GLuint texture;
+    GLenum target = GL_TEXTURE_2D;
+};
+
+// Textures of a mesh resolved against one shader. Samplers are assigned to
+// fixed texture units at creation and samplers not used by the shader are
+// dropped, so that applying it only sets units and binds textures without
+// any string processing.
+class Material
+{
+public:
+    Material() = default;
+    Material(const Shader& shader, std::span<const MaterialTexture> textures);
+
+    // Return the next free texture unit, i.e. the number of used units.
+    // NOTICE: shader should be the one used for creation and be activated.
+    int Apply(const Shader& shader) const;
+
+    bool IsCreatedFor(const Shader& shader) const {
+        return shaderSerial_ != 0 && shaderSerial_ == shader.GetSerial();
+    }
+    int GetTextureUnitNum() const { return static_cast<int>(bindings_.size()); }
+
+private:
+    struct TextureBinding_
+    {
+        UniformID sampler;
+        GLenum target;
+        GLuint texture;
+    };
+    std::uint64_t shaderSerial_ = 0;
+    std::vector<TextureBinding_> bindings_;
+};
+
+} // namespace OpenGLFramework::Core
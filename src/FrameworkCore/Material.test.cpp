@@ -0,0 +1,80 @@
+#include "Material.h"
+#include "ContextManager.h"
+#include "MainWindow.h"
+#include "TestShader.test.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+
+using namespace OpenGLFramework::Core;
+
+static const char* c_vertShader = R"(#version 330 core
+layout(location = 0) in vec3 position;
+void main() { gl_Position = vec4(position, 1.0); }
+)";
+
+// specularTexture1 is declared but unused, so it's optimized out.
+static const char* c_fragShader = R"(#version 330 core
+out vec4 FragColor;
+uniform sampler2D diffuseTexture1;
+uniform sampler2D diffuseTexture2;
+uniform sampler2D specularTexture1;
+void main() {
+    FragColor = texture(diffuseTexture1, vec2(0)) + texture(diffuseTexture2, vec2(0));
+}
+)";
+
+TEST_CASE("Material")
+{
+    Shader shader = CreateShader(c_vertShader, c_fragShader);
+    GLuint textures[3];
+    glGenTextures(3, textures);
+
+    const MaterialTexture materialTextures[]{
+        { "diffuseTexture1", textures[0] },
+        { "specularTexture1", textures[1] },
+        { "diffuseTexture2", textures[2] }
+    };
+    Material material{ shader, materialTextures };
+    REQUIRE(material.IsCreatedFor(shader));
+    REQUIRE(material.GetTextureUnitNum() == 2);
+
+    SECTION("Apply binds textures to fixed units")
+    {
+        shader.Activate();
+        REQUIRE(material.Apply(shader) == 2);
+
+        GLint unit = -1;
+        glGetUniformiv(shader.GetID(), shader.GetUniformLocation("diffuseTexture2"),
+            &unit);
+        REQUIRE(unit == 1);
+
+        GLint bindTexture = 0;
+        glActiveTexture(GL_TEXTURE1);
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &bindTexture);
+        REQUIRE(static_cast<GLuint>(bindTexture) == textures[2]);
+        GLStateCache::GetInstance().Invalidate();
+    }
+
+    SECTION("Materials are bound to one shader")
+    {
+        Shader another = CreateShader(c_vertShader, c_fragShader);
+        REQUIRE(another.GetSerial() != shader.GetSerial());
+        REQUIRE_FALSE(material.IsCreatedFor(another));
+
+        Shader moved = std::move(shader);
+        REQUIRE(material.IsCreatedFor(moved));
+        REQUIRE_FALSE(material.IsCreatedFor(shader));
+    }
+
+    glDeleteTextures(3, textures);
+    GLStateCache::GetInstance().Invalidate();
+}
+
+int main()
+{
+    [[maybe_unused]] ContextManager& manager = ContextManager::GetInstance();
+    MainWindow useForContextWindow{ 50, 50, "test", false };
+    auto result = Catch::Session().run();
+    return result;
+}
@@ -1,5 +1,10 @@
 #include "Mesh.h"
+#include "GLStateCache.h"
+#include "UploadWorker.h"
+#include "Utility/Threading/JobSystem.h"
 
+#include <algorithm>
+#include <mutex>
 #include <ranges>
 #include <iostream>
 
@@ -48,8 +53,9 @@ BasicTriMesh::TriangleVerts BasicTriMesh::GetTriangleVerts(glm::ivec3 triangle)
 std::vector<glm::vec3> BasicTriMesh::GetRealTriNormals()
 {
     std::vector<glm::vec3> normals(triangles.size());
-    std::ranges::iota_view triangleView{size_t(0), triangles.size()};
-    std::for_each(triangleView.begin(), triangleView.end(),
+    // Small meshes are a single chunk, which runs on the current thread.
+    constexpr size_t c_grainSize = 4096;
+    Threading::ParallelFor(0, triangles.size(),
         [&normals, this](size_t id)
         {
             auto v1 = triangles[id][0], v2 = triangles[id][1],
@@ -57,7 +63,7 @@ std::vector<glm::vec3> BasicTriMesh::GetRealTriNormals()
             glm::vec3 e1 = vertices[v1] - vertices[v2],
                 e2 = vertices[v2] - vertices[v3];
             normals[id] = glm::normalize(glm::cross(e1, e2));
-        });
+        }, c_grainSize);
     return normals;
 }
 
@@ -85,28 +91,61 @@ std::vector<glm::vec3> BasicTriMesh::GetRealVertexNormals()
 
 void BasicTriRenderMesh::SetupRenderResource_()
 {
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
+    if (!vertices.empty()) [[likely]]
+    {
+        auto [minX, maxX] = std::ranges::minmax(vertices | std::views::transform(
+            [](const glm::vec3& vertex) { return vertex.x; }));
+        auto [minY, maxY] = std::ranges::minmax(vertices | std::views::transform(
+            [](const glm::vec3& vertex) { return vertex.y; }));
+        auto [minZ, maxZ] = std::ranges::minmax(vertices | std::views::transform(
+            [](const glm::vec3& vertex) { return vertex.z; }));
+        boundCenter_ = glm::vec3{ minX + maxX, minY + maxY, minZ + maxZ } / 2.0f;
+    }
 
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    UploadBuffers_();
+    // VAOs aren't shared between contexts, so they're set up on the main
+    // thread after uploading(see BasicTriRenderModel::LoadAsync).
+    if (UploadWorker::IsWorkerThread())
+        VAO = 0;
+    else
+        SetupVertexArray_();
+    return;
+}
 
-    verticesAttributes_.AllocateAndBind(sizeof(glm::vec3), vertices.size());
+void BasicTriRenderMesh::UploadBuffers_()
+{
+    glGenBuffers(1, &VBO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    verticesAttributes_.Allocate(sizeof(glm::vec3), vertices.size());
     glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glm::vec3) * vertices.size(),
         vertices.data());
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
+    // The element array binding is a state of VAO, so a general target is
+    // used to fill it without any VAO.
     glGenBuffers(1, &IBO);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, IBO);
+    glBufferData(GL_COPY_WRITE_BUFFER, triangles.size() * sizeof(glm::ivec3),
+        triangles.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return;
+}
 
+void BasicTriRenderMesh::SetupVertexArray_()
+{
+    glGenVertexArrays(1, &VAO);
+    GLStateCache::GetInstance().BindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    verticesAttributes_.Bind(sizeof(glm::vec3), vertices.size());
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, triangles.size() * sizeof(glm::ivec3),
-        triangles.data(), GL_STATIC_DRAW);
 
     // NOTICE: Unbind sequence MUST be VAO->VBO&IBO
-    glBindVertexArray(0);
+    GLStateCache::GetInstance().BindVertexArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    return;
 }
 
 void BasicTriRenderMesh::CopyAttributes_(const aiMesh* mesh)
@@ -182,6 +221,7 @@ void BasicTriRenderMesh::ReleaseRenderResources_()
 {
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &IBO);
+    GLStateCache::GetInstance().OnVertexArrayDeleted(VAO);
     glDeleteVertexArrays(1, &VAO);
     return;
 }
@@ -191,7 +231,9 @@ BasicTriRenderMesh::BasicTriRenderMesh(BasicTriRenderMesh&& another) noexcept:
     verticesAttributes_{ std::move(another.verticesAttributes_)},
     diffuseTextureRefs_{ std::move(another.diffuseTextureRefs_)},
     specularTextureRefs_{ std::move(another.specularTextureRefs_)},
-    VAO{ another.VAO }, VBO{ another.VBO }, IBO{ another.IBO }
+    VAO{ another.VAO }, VBO{ another.VBO }, IBO{ another.IBO },
+    boundCenter_{ another.boundCenter_ }, materials_{ std::move(another.materials_) },
+    materialUseNum_{ another.materialUseNum_.load(std::memory_order_relaxed) }
 {
     another.VAO = another.VBO = another.IBO = 0;
     return;
@@ -208,8 +250,12 @@ BasicTriRenderMesh& BasicTriRenderMesh::operator=(BasicTriRenderMesh&& another)
     verticesAttributes_ = std::move(another.verticesAttributes_);
     diffuseTextureRefs_ = std::move(another.diffuseTextureRefs_);
     specularTextureRefs_ = std::move(another.specularTextureRefs_);
+    materials_ = std::move(another.materials_);
+    materialUseNum_.store(another.materialUseNum_.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
 
     VAO = another.VAO, VBO = another.VBO, IBO = another.IBO;
+    boundCenter_ = another.boundCenter_;
     another.VAO = another.VBO = another.IBO = 0;
     return *this;
 }
@@ -219,32 +265,80 @@ BasicTriRenderMesh::~BasicTriRenderMesh()
     ReleaseRenderResources_();
 }
 
-void BasicTriRenderMesh::SetTextures_(const Shader& shader,
-    const std::string& namePrefix,
-    const decltype(diffuseTextureRefs_)& textures, int& beginID) const
+std::shared_ptr<const Material> BasicTriRenderMesh::GetMaterial_(const Shader& shader) const
 {
-    int currTypeID = 1;
-    for (auto& texture : textures)
+    auto findMaterial = [this, &shader]() -> MaterialEntry_* {
+        for (auto& entry : materials_)
+        {
+            if (entry.material->IsCreatedFor(shader)) [[likely]]
+                return &entry;
+        }
+        return nullptr;
+    };
+    auto touch = [this](MaterialEntry_& entry) {
+        entry.lastUse.store(materialUseNum_.fetch_add(1, std::memory_order_relaxed),
+            std::memory_order_relaxed);
+        return entry.material;
+    };
+    // Command buffers may be recorded on several threads.
     {
-        std::string name = namePrefix + std::to_string(currTypeID);
-        Texture::BindTextureOnShader(beginID, name.c_str(), shader,
-            texture.get().GetID());
-        ++beginID, ++currTypeID;
+        std::shared_lock lock{ materialMutex_ };
+        if (auto entry = findMaterial(); entry != nullptr) [[likely]]
+            return touch(*entry);
     }
-};
+
+    std::unique_lock lock{ materialMutex_ };
+    auto entry = findMaterial();
+    if (entry != nullptr)
+        return touch(*entry);
+
+    // Samplers are named as diffuseTexture1, diffuseTexture2, ...,
+    // specularTexture1, ...
+    std::vector<std::string> names;
+    std::vector<MaterialTexture> textures;
+    names.reserve(diffuseTextureRefs_.size() + specularTextureRefs_.size());
+    auto addTextures = [&](std::string_view namePrefix, 
+        const decltype(diffuseTextureRefs_)& refs) {
+        for (size_t i = 0; i < refs.size(); i++)
+        {
+            auto& name = names.emplace_back(namePrefix);
+            name += std::to_string(i + 1);
+            textures.push_back({ name, refs[i].get().GetID() });
+        }
+    };
+    addTextures("diffuseTexture", diffuseTextureRefs_);
+    addTextures("specularTexture", specularTextureRefs_);
+    auto material = std::make_shared<const Material>(shader, textures);
+
+    if (materials_.size() < c_maxMaterialNum_)
+        entry = &materials_.emplace_back();
+    else
+    {
+        entry = &*std::ranges::min_element(materials_, {},
+            [](const MaterialEntry_& entry) {
+                return entry.lastUse.load(std::memory_order_relaxed);
+            });
+    }
+    entry->material = std::move(material);
+    return touch(*entry);
+}
+
+void BasicTriRenderMesh::InvalidateMaterials_()
+{
+    std::unique_lock lock{ materialMutex_ };
+    materials_.clear();
+    return;
+}
 
 void BasicTriRenderMesh::Draw(const Shader& shader) const
 {
-    int textureCnt = 0;
-    SetTextures_(shader, "diffuseTexture", diffuseTextureRefs_, textureCnt);
-    SetTextures_(shader, "specularTexture", specularTextureRefs_, textureCnt);
+    GetMaterial_(shader)->Apply(shader);
 
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+    // IBO is recorded in VAO, and VAO is left bound so that consecutive
+    // draws of the same mesh needn't bind again.
+    GLStateCache::GetInstance().BindVertexArray(VAO);
     glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(triangles.size() * 3), 
         GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     return;
 };
 
@@ -252,20 +346,15 @@ void BasicTriRenderMesh::Draw(const Shader& shader,
     const std::function<void(int, const Shader&)>& preprocess,
     const std::function<void(void)>& postprocess) const
 {
-    int textureCnt = 0;
-    SetTextures_(shader, "diffuseTexture", diffuseTextureRefs_, textureCnt);
-    SetTextures_(shader, "specularTexture", specularTextureRefs_, textureCnt);
+    int textureCnt = GetMaterial_(shader)->Apply(shader);
     if(preprocess) [[likely]]
         preprocess(textureCnt, shader);
     
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+    GLStateCache::GetInstance().BindVertexArray(VAO);
     glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(triangles.size() * 3),
         GL_UNSIGNED_INT, 0);
     if (postprocess) [[unlikely]]
         postprocess();
-    glBindVertexArray(0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
     return;
 };
 
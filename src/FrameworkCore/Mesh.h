@@ -3,6 +3,7 @@
 #include "Shader.h"
 #include "Texture.h"
 #include "Framebuffer.h"
+#include "Material.h"
 #include "../Utility/GLHelper/VertexAttribHelper.h"
 
 #ifdef _MSC_VER
@@ -19,6 +20,10 @@
 #endif
 
 #include <unordered_map>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <shared_mutex>
 #include <filesystem>
 #include <functional>
 #include <vector>
@@ -100,6 +105,7 @@ public:
 class BasicTriRenderMesh : public BasicTriMesh
 {
     friend class BasicTriRenderModel;
+    friend class RenderQueue;
 public:
     BasicTriRenderMesh(BasicTriMesh mesh, 
         const std::vector<glm::vec3>& init_normals);
@@ -126,10 +132,26 @@ private:
     std::vector<std::reference_wrapper<Texture>> diffuseTextureRefs_;
     std::vector<std::reference_wrapper<Texture>> specularTextureRefs_;
     GLuint VAO, VBO, IBO;
+    glm::vec3 boundCenter_{ 0.0f };
+    struct MaterialEntry_
+    {
+        std::shared_ptr<const Material> material;
+        std::atomic<std::uint64_t> lastUse = 0;
+    };
+    static constexpr size_t c_maxMaterialNum_ = 8;
+    // One for each shader that draws the mesh, and the least recently used
+    // one is replaced for new shaders when full; all are dropped when
+    // textures change. Render queues and command buffers share ownership, so
+    // queued draws keep applying the material they're recorded with.
+    mutable std::deque<MaterialEntry_> materials_;
+    mutable std::atomic<std::uint64_t> materialUseNum_ = 0;
+    mutable std::shared_mutex materialMutex_;
 
     void ReleaseRenderResources_();
 
     void SetupRenderResource_();
+    void UploadBuffers_();
+    void SetupVertexArray_();
     void CopyAttributes_(const aiMesh* mesh);
     void AddAllTexturesToPoolAndFillRefs_(const aiMaterial* material,
         TexturePool& texturePool, const std::filesystem::path& rootPath);
@@ -137,8 +159,8 @@ private:
         const aiTextureType type, std::vector<std::reference_wrapper<Texture>>& refs,
         TexturePool& texturePool, const std::filesystem::path& rootPath);
 
-    void SetTextures_(const Core::Shader& shader, const std::string& namePrefix,
-        const decltype(diffuseTextureRefs_)& textures, int& beginID) const;
+    std::shared_ptr<const Material> GetMaterial_(const Shader& shader) const;
+    void InvalidateMaterials_();
 };
 
 }
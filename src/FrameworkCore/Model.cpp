@@ -1,9 +1,10 @@
 #include "Model.h"
+#include "ContextManager.h"
+#include "UploadWorker.h"
 #include "Utility/IO/IOExtension.h"
 
 #include <stb_image.h>
 
-#include <execution>
 #include <ranges>
 
 namespace OpenGLFramework::Core
@@ -50,11 +51,22 @@ void BasicTriModel::LoadResources_(const aiScene* model)
     return;
 }
 
+// The thread-local setter overrides the global flag for good, so it's only
+// used on the upload worker, where models are loaded concurrently.
+static void SetTextureFlip(bool flip)
+{
+    if (UploadWorker::IsWorkerThread())
+        stbi_set_flip_vertically_on_load_thread(flip);
+    else
+        stbi_set_flip_vertically_on_load(flip);
+    return;
+}
+
 void BasicTriRenderModel::LoadResources_(const aiScene* model, 
     const std::filesystem::path& resourceRootPath, bool textureNeedFlip,
     const GLHelper::IVertexAttribContainer& container)
 {
-    stbi_set_flip_vertically_on_load(textureNeedFlip);
+    SetTextureFlip(textureNeedFlip);
 
     LoadResourcesDecorator_(model, 
         [this](const aiMesh* mesh, const aiScene* model,
@@ -67,14 +79,14 @@ void BasicTriRenderModel::LoadResources_(const aiScene* model,
                 resourceRootPath, c);
         }, model, resourceRootPath, container);
 
-    stbi_set_flip_vertically_on_load(false);
+    SetTextureFlip(false);
 }
 
 void BasicTriRenderModel::LoadResourcesFromCollection_(const aiScene* model,
     const std::filesystem::path& resourceRootPath, bool textureNeedFlip,
     std::vector<GLHelper::IVertexAttribContainer>& collection)
 {
-    stbi_set_flip_vertically_on_load(textureNeedFlip);
+    SetTextureFlip(textureNeedFlip);
 
     LoadResourcesDecorator_(model,
         [this, id = 0](const aiMesh* mesh, const aiScene* model,
@@ -87,7 +99,7 @@ void BasicTriRenderModel::LoadResourcesFromCollection_(const aiScene* model,
                 resourceRootPath, std::move(collection[id++]));
         }, model, resourceRootPath, collection);
 
-    stbi_set_flip_vertically_on_load(false);
+    SetTextureFlip(false);
 }
 
 BasicTriRenderModel::BasicTriRenderModel(std::vector<BasicTriRenderMesh> 
@@ -127,19 +139,41 @@ BasicTriRenderModel::BasicTriRenderModel(const std::filesystem::path& modelPath,
     return;
 }
 
+void BasicTriRenderModel::LoadAsync(const std::filesystem::path& modelPath,
+    std::function<void(BasicTriRenderModel)> onReady,
+    const GLHelper::IVertexAttribContainer& container, bool needTBN,
+    bool textureNeedFlip)
+{
+    ContextManager::GetInstance().GetUploadWorker().Upload(
+        [modelPath, container, needTBN, textureNeedFlip]() {
+            return BasicTriRenderModel{ modelPath, container, needTBN,
+                textureNeedFlip };
+        },
+        [onReady = std::move(onReady)](BasicTriRenderModel model) {
+            // Meshes uploaded on the worker don't have VAOs yet.
+            for (auto& mesh : model.meshes)
+            {
+                if (mesh.VAO == 0)
+                    mesh.SetupVertexArray_();
+            }
+            onReady(std::move(model));
+        });
+    return;
+}
+
 void BasicTriRenderModel::AttachTexture(const std::filesystem::path& path,
     std::initializer_list<int> attachIDs, bool isSpecular)
 {
     auto [textureIt, _] = texturePool_.try_emplace(path, path);
-    if (isSpecular)
+    for (auto attachID : attachIDs)
     {
-        for (auto attachID : attachIDs)
-            meshes.at(attachID).specularTextureRefs_.push_back(textureIt->second);
-        return;
+        auto& mesh = meshes.at(attachID);
+        if (isSpecular)
+            mesh.specularTextureRefs_.push_back(textureIt->second);
+        else
+            mesh.diffuseTextureRefs_.push_back(textureIt->second);
+        mesh.InvalidateMaterials_();
     }
-    // else, diffuse.
-    for (auto attachID : attachIDs)
-        meshes.at(attachID).diffuseTextureRefs_.push_back(textureIt->second);
     return;
 };
 
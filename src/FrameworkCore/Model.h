@@ -65,6 +65,14 @@ public:
         std::vector<GLHelper::IVertexAttribContainer> collection,
         bool needTBN = false, bool textureNeedFlip = false);
 
+    // The model is loaded and uploaded on the upload worker, and given to
+    // onReady on the main thread(see UploadWorker), so that loading doesn't
+    // stall rendering.
+    static void LoadAsync(const std::filesystem::path& modelPath,
+        std::function<void(BasicTriRenderModel)> onReady,
+        const GLHelper::IVertexAttribContainer& = std::vector<BasicVertexAttribute>{},
+        bool needTBN = false, bool textureNeedFlip = false);
+
     void AttachTexture(const std::filesystem::path& path,
         std::initializer_list<int> attachIDs, bool isSpecular = false);
     void Draw(const Shader& shader) const;
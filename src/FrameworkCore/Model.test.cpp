@@ -3,13 +3,18 @@
 #include "Model.h"
 #include "SpecialModels/SpecialModel.h"
 #include "../Utility/IO/IniFile.h"
+#include "../Utility/Threading/JobSystem.h"
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_session.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/matchers/catch_matchers_vector.hpp>
 
 #include <algorithm>
+#include <cmath>
+#include <execution>
 #include <filesystem>
+#include <numeric>
 
 using namespace OpenGLFramework::Core;
 OpenGLFramework::IOExtension::IniFile config{ TEST_CONFIG_PATH };
@@ -59,4 +64,70 @@ TEST_CASE("Cube")
             }
         }
     }
-}
\ No newline at end of file
+}
+
+// Height field of size * size vertices, e.g. a terrain chunk.
+static BasicTriMesh CreateGridMesh(int size)
+{
+    std::vector<glm::vec3> vertices;
+    std::vector<glm::ivec3> triangles;
+    for (int row = 0; row < size; row++)
+    {
+        for (int col = 0; col < size; col++)
+        {
+            vertices.emplace_back(col, std::sin(col * 0.1f) * std::cos(row * 0.1f), row);
+            if (row == 0 || col == 0)
+                continue;
+            const int current = row * size + col, left = current - 1,
+                up = current - size, upLeft = up - 1;
+            triangles.emplace_back(upLeft, left, current);
+            triangles.emplace_back(upLeft, current, up);
+        }
+    }
+    return BasicTriMesh{ std::move(vertices), std::move(triangles) };
+}
+
+TEST_CASE("Benchmark-Normals")
+{
+    // Large meshes are split by GetRealTriNormals itself.
+    auto terrain = CreateGridMesh(1024);
+    const auto normals = terrain.GetRealTriNormals();
+    REQUIRE(normals.size() == terrain.triangles.size());
+    REQUIRE(std::ranges::all_of(normals, [](const glm::vec3& normal) {
+        return normal.y > 0;
+    }));
+
+    BENCHMARK("Large mesh")
+    {
+        return terrain.GetRealTriNormals();
+    };
+
+    // Small meshes are a single chunk each, so they're processed in parallel
+    // instead, e.g. meshes of a loaded model.
+    std::vector<BasicTriMesh> chunks(256, CreateGridMesh(32));
+    std::vector<std::vector<glm::vec3>> chunkNormals(chunks.size());
+    std::vector<size_t> indices(chunks.size());
+    std::iota(indices.begin(), indices.end(), size_t{ 0 });
+    auto computeNormals = [&chunks, &chunkNormals](size_t i) {
+        chunkNormals[i] = chunks[i].GetRealTriNormals();
+    };
+
+    BENCHMARK("Small meshes, serial")
+    {
+        std::ranges::for_each(indices, computeNormals);
+        return chunkNormals.back().size();
+    };
+
+    BENCHMARK("Small meshes, std::execution::par")
+    {
+        std::for_each(std::execution::par, indices.begin(), indices.end(),
+            computeNormals);
+        return chunkNormals.back().size();
+    };
+
+    BENCHMARK("Small meshes, ParallelFor")
+    {
+        OpenGLFramework::Threading::ParallelFor(0, chunks.size(), computeNormals, 1);
+        return chunkNormals.back().size();
+    };
+}
@@ -0,0 +1,158 @@
+#include "ProgramBinaryCache.h"
+#include "Utility/IO/IOExtension.h"
+#include "Utility/GLHelper/GLFeature.h"
+#include "Utility/String/StringExtension.h"
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+namespace OpenGLFramework::Core
+{
+
+struct ProgramBinaryHeader
+{
+    char magic[4] = { 'O', 'G', 'F', 'P' };
+    std::uint32_t version = 1;
+    std::uint64_t key = 0;
+    std::uint32_t binaryFormat = 0;
+    std::uint32_t binarySize = 0;
+};
+
+ProgramBinaryCache& ProgramBinaryCache::GetInstance()
+{
+    static ProgramBinaryCache cache{};
+    return cache;
+}
+
+bool ProgramBinaryCache::IsEnabled() const
+{
+    return enabled_ && !directory_.empty() && GLHelper::SupportProgramBinary();
+}
+
+std::uint64_t ProgramBinaryCache::GetKey(std::span<const ShaderSource> sources) const
+{
+    auto getString = [](GLenum name) {
+        auto str = reinterpret_cast<const char*>(glGetString(name));
+        return std::string{ str == nullptr ? "" : str };
+    };
+
+    // '\0' never appears in sources, so it separates the parts unambiguously.
+    std::string keySource = getString(GL_RENDERER);
+    keySource += '\0';
+    keySource += getString(GL_VERSION);
+    for (const auto& source : sources)
+    {
+        keySource += '\0';
+        keySource += std::to_string(source.type);
+        keySource += '\0';
+        keySource += source.content;
+    }
+    return StringExtension::HashFNV1a(keySource);
+}
+
+std::filesystem::path ProgramBinaryCache::GetCachePath_(std::uint64_t key) const
+{
+    static constexpr const char* c_hexDigits = "0123456789abcdef";
+    std::string name(16, '0');
+    for (int i = 15; i >= 0; i--, key >>= 4)
+        name[i] = c_hexDigits[key & 0xF];
+    return directory_ / (name + ".bin");
+}
+
+GLuint ProgramBinaryCache::Load(std::uint64_t key)
+{
+    if (!IsEnabled())
+        return 0;
+
+    auto cachePath = GetCachePath_(key);
+    std::ifstream fin{ cachePath, std::ios::binary };
+    if (!fin.is_open())
+    {
+        missCount_++;
+        return 0;
+    }
+
+    ProgramBinaryHeader expected, actual;
+    expected.key = key;
+    fin.read(reinterpret_cast<char*>(&actual), sizeof(actual));
+    std::vector<char> binary;
+    if (fin && std::equal(std::begin(expected.magic), std::end(expected.magic),
+        actual.magic) && actual.version == expected.version && actual.key == key)
+    {
+        binary.resize(actual.binarySize);
+        fin.read(binary.data(), binary.size());
+    }
+    if (!fin || binary.empty()) [[unlikely]]
+    {
+        fin.close();
+        std::error_code error;
+        std::filesystem::remove(cachePath, error);
+        missCount_++;
+        return 0;
+    }
+    fin.close();
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, actual.binaryFormat, binary.data(),
+        static_cast<GLsizei>(binary.size()));
+    GLint linkSuccess = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &linkSuccess);
+    if (linkSuccess == GL_TRUE) [[likely]]
+    {
+        hitCount_++;
+        return program;
+    }
+
+    // Rejected, e.g. the driver is updated without changing GL_VERSION.
+    glDeleteProgram(program);
+    std::error_code error;
+    std::filesystem::remove(cachePath, error);
+    missCount_++;
+    return 0;
+}
+
+void ProgramBinaryCache::Store(std::uint64_t key, GLuint program)
+{
+    if (!IsEnabled())
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) [[unlikely]]
+        return;
+
+    ProgramBinaryHeader header;
+    header.key = key;
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+    header.binaryFormat = format;
+    header.binarySize = static_cast<std::uint32_t>(length);
+
+    std::error_code error;
+    std::filesystem::create_directories(directory_, error);
+    // Written to a temporary file first, so that programs in another process
+    // never read an incomplete binary.
+    auto cachePath = GetCachePath_(key);
+    auto tempPath = std::filesystem::path{ cachePath }.concat(".tmp");
+    {
+        std::ofstream fout{ tempPath, std::ios::binary };
+        fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        fout.write(binary.data(), header.binarySize);
+        if (!fout) [[unlikely]]
+        {
+            IOExtension::LogError("Fail to write program binary cache at path "
+                + tempPath.string());
+            fout.close();
+            std::filesystem::remove(tempPath, error);
+            return;
+        }
+    }
+    std::filesystem::rename(tempPath, cachePath, error);
+    if (error) [[unlikely]]
+        std::filesystem::remove(tempPath, error);
+    return;
+}
+
+} // namespace OpenGLFramework::Core
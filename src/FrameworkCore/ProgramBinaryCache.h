@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Shader.h"
+
+#include <glad/glad.h>
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace OpenGLFramework::Core
+{
+
+// Linked programs are saved by glGetProgramBinary, and named by the hash of
+// all sources together with GL_RENDERER and GL_VERSION, so that a modified
+// shader or an updated driver just misses the cache. Binaries rejected by
+// glProgramBinary are removed, and the program is compiled from sources.
+// It's opt-in; nothing is cached until a cache directory is set.
+class ProgramBinaryCache
+{
+public:
+    static ProgramBinaryCache& GetInstance();
+    ProgramBinaryCache(const ProgramBinaryCache&) = delete;
+    ProgramBinaryCache& operator=(const ProgramBinaryCache&) = delete;
+
+    // Should be set before shaders are compiled, e.g. a directory in the
+    // application config; empty disables the cache.
+    void SetCacheDirectory(const std::filesystem::path& directory) {
+        directory_ = directory;
+    }
+    const std::filesystem::path& GetCacheDirectory() const { return directory_; }
+    void SetEnabled(bool enabled) { enabled_ = enabled; }
+    // False if disabled, no directory is set or the driver doesn't support
+    // program binary.
+    bool IsEnabled() const;
+
+    std::uint64_t GetKey(std::span<const ShaderSource> sources) const;
+    // Return the linked program, or 0 if missed.
+    GLuint Load(std::uint64_t key);
+    // program should be linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT.
+    void Store(std::uint64_t key, GLuint program);
+
+    size_t GetHitCount() const { return hitCount_; }
+    size_t GetMissCount() const { return missCount_; }
+
+private:
+    std::filesystem::path directory_;
+    std::atomic<bool> enabled_ = true;
+    std::atomic<size_t> hitCount_ = 0, missCount_ = 0;
+
+    ProgramBinaryCache() = default;
+    ~ProgramBinaryCache() = default;
+    std::filesystem::path GetCachePath_(std::uint64_t key) const;
+};
+
+} // namespace OpenGLFramework::Core
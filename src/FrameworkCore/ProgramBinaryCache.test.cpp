@@ -0,0 +1,75 @@
+#include "ProgramBinaryCache.h"
+#include "Shader.h"
+#include "ContextManager.h"
+#include "MainWindow.h"
+#include "../Utility/IO/IniFile.h"
+#include "TestShader.test.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+
+#include <fstream>
+
+using namespace OpenGLFramework::Core;
+OpenGLFramework::IOExtension::IniFile config{ TEST_CONFIG_PATH };
+
+TEST_CASE("Program-Binary-Cache-Opt-In")
+{
+    auto& cache = ProgramBinaryCache::GetInstance();
+    REQUIRE(cache.GetCacheDirectory().empty());
+    REQUIRE(!cache.IsEnabled());
+
+    const size_t initialMiss = cache.GetMissCount();
+    Shader compiled = CreateShader(config);
+    REQUIRE(compiled.GetID() != 0);
+    REQUIRE(cache.GetMissCount() == initialMiss);
+}
+
+TEST_CASE("Program-Binary-Cache")
+{
+    auto& cache = ProgramBinaryCache::GetInstance();
+    std::filesystem::path directory = config.rootSection("cache_dir");
+    std::filesystem::remove_all(directory);
+    cache.SetCacheDirectory(directory);
+    if (!cache.IsEnabled())
+    {
+        WARN("Program binary isn't supported.");
+        return;
+    }
+
+    const size_t initialHit = cache.GetHitCount(),
+        initialMiss = cache.GetMissCount();
+    Shader compiled = CreateShader(config);
+    REQUIRE(compiled.GetID() != 0);
+    REQUIRE(cache.GetMissCount() == initialMiss + 1);
+    REQUIRE(std::distance(std::filesystem::directory_iterator{ directory },
+        std::filesystem::directory_iterator{}) == 1);
+
+    SECTION("Load from binary")
+    {
+        Shader loaded = CreateShader(config);
+        REQUIRE(loaded.GetID() != 0);
+        REQUIRE(cache.GetHitCount() == initialHit + 1);
+        REQUIRE(loaded.GetUniformLocation("model") ==
+            compiled.GetUniformLocation("model"));
+    }
+
+    SECTION("Fall back when binary is corrupted")
+    {
+        for (const auto& entry : std::filesystem::directory_iterator{ directory })
+            std::ofstream{ entry.path(), std::ios::binary } << "corrupted";
+
+        Shader recompiled = CreateShader(config);
+        REQUIRE(recompiled.GetID() != 0);
+        REQUIRE(cache.GetHitCount() == initialHit);
+        REQUIRE(cache.GetMissCount() == initialMiss + 2);
+    }
+}
+
+int main()
+{
+    [[maybe_unused]] ContextManager& manager = ContextManager::GetInstance();
+    MainWindow useForContextWindow{ 50, 50, "test", false };
+    auto result = Catch::Session().run();
+    return result;
+}
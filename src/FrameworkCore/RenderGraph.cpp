@@ -0,0 +1,365 @@
+#include "RenderGraph.h"
+#include "GLStateCache.h"
+#include "Utility/IO/IOExtension.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace OpenGLFramework::Core
+{
+
+RenderGraph::ResourceHandle RenderGraph::PassBuilder::Create(
+    std::string_view name, FramebufferDesc desc)
+{
+    return Write(graph_.Create(name, std::move(desc)));
+}
+
+RenderGraph::ResourceHandle RenderGraph::PassBuilder::Read(ResourceHandle resource)
+{
+    graph_.passes_[passIndex_].reads.push_back(resource.index);
+    return resource;
+}
+
+RenderGraph::ResourceHandle RenderGraph::PassBuilder::Write(ResourceHandle resource)
+{
+    graph_.passes_[passIndex_].writes.push_back(resource.index);
+    graph_.resources_[resource.index].writers.push_back(passIndex_);
+    return resource;
+}
+
+void RenderGraph::PassBuilder::SetSideEffect()
+{
+    graph_.passes_[passIndex_].hasSideEffect = true;
+    return;
+}
+
+const Framebuffer* RenderGraph::PassContext::GetFramebuffer(
+    ResourceHandle resource) const
+{
+    const auto& currResource = graph_.resources_[resource.index];
+    if (currResource.imported)
+        return currResource.importedFramebuffer;
+    return &graph_.physicals_[currResource.physical].framebuffer.Get();
+}
+
+void RenderGraph::PassContext::UseAsRenderTarget(ResourceHandle resource) const
+{
+    if (auto framebuffer = GetFramebuffer(resource); framebuffer != nullptr)
+        framebuffer->UseAsRenderTarget();
+    else
+        GLStateCache::GetInstance().BindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    const auto [width, height] = GetSize(resource);
+    glViewport(0, 0, width, height);
+    return;
+}
+
+std::pair<unsigned int, unsigned int> RenderGraph::PassContext::GetSize(
+    ResourceHandle resource) const
+{
+    if (auto framebuffer = GetFramebuffer(resource); framebuffer != nullptr)
+        return { framebuffer->GetWidth(), framebuffer->GetHeight() };
+    return { graph_.screenWidth_, graph_.screenHeight_ };
+}
+
+RenderGraph::ResourceHandle RenderGraph::Import(std::string_view name,
+    const Framebuffer* framebuffer)
+{
+    const auto index = static_cast<std::uint32_t>(resources_.size());
+    resources_.push_back({ .name = std::string{ name }, .imported = true,
+        .importedFramebuffer = framebuffer });
+    compiled_ = false;
+    return ResourceHandle{ index };
+}
+
+RenderGraph::ResourceHandle RenderGraph::Create(std::string_view name,
+    FramebufferDesc desc)
+{
+    const auto index = static_cast<std::uint32_t>(resources_.size());
+    resources_.push_back({ .name = std::string{ name }, .desc = std::move(desc) });
+    compiled_ = false;
+    return ResourceHandle{ index };
+}
+
+void RenderGraph::AddPass(std::string_view name, const SetupFunc& setup,
+    ExecuteFunc execute)
+{
+    const auto index = static_cast<std::uint32_t>(passes_.size());
+    passes_.push_back({ .name = std::string{ name },
+        .execute = std::move(execute) });
+    PassBuilder builder{ *this, index };
+    setup(builder);
+    compiled_ = false;
+    return;
+}
+
+void RenderGraph::SetScreenSize(unsigned int width, unsigned int height)
+{
+    if (width == screenWidth_ && height == screenHeight_)
+        return;
+    screenWidth_ = width, screenHeight_ = height;
+    compiled_ = false;
+    return;
+}
+
+bool RenderGraph::Compile()
+{
+    CullPasses_(CollectDependencies_(false));
+    if (!SortPasses_(CollectDependencies_(true))) [[unlikely]]
+    {
+        IOExtension::LogError("Cyclic dependencies in render graph.");
+        executionOrder_.clear();
+        return false;
+    }
+    AllocateFramebuffers_();
+    compiled_ = true;
+    return true;
+}
+
+void RenderGraph::Execute()
+{
+    if (!compiled_ && !Compile()) [[unlikely]]
+        return;
+
+    PassContext context{ *this };
+    for (std::uint32_t order = 0; order < executionOrder_.size(); order++)
+    {
+        passes_[executionOrder_[order]].execute(context);
+        for (const auto& resource : resources_)
+        {
+            if (!resource.imported && resource.lastUse == order)
+                physicals_[resource.physical].framebuffer->Invalidate();
+        }
+    }
+    return;
+}
+
+void RenderGraph::Clear()
+{
+    passes_.clear();
+    resources_.clear();
+    executionOrder_.clear();
+    compiled_ = false;
+    return;
+}
+
+bool RenderGraph::IsCulled(std::string_view passName) const
+{
+    auto it = std::ranges::find(passes_, passName, &Pass_::name);
+    return it == passes_.end() || it->culled;
+}
+
+std::vector<std::string_view> RenderGraph::GetExecutionOrder() const
+{
+    std::vector<std::string_view> result;
+    result.reserve(executionOrder_.size());
+    for (auto passIndex : executionOrder_)
+        result.push_back(passes_[passIndex].name);
+    return result;
+}
+
+std::vector<std::vector<std::uint32_t>> RenderGraph::CollectDependencies_(
+    bool withAntiDependencies) const
+{
+    std::vector<std::vector<std::uint32_t>> dependencies(passes_.size());
+    for (std::uint32_t i = 0; i < passes_.size(); i++)
+    {
+        for (auto resource : passes_[i].reads)
+        {
+            // Writers are in declaration order; nextWriter is the first one
+            // overwriting what the pass reads.
+            const auto& writers = resources_[resource].writers;
+            auto nextWriter = std::ranges::lower_bound(writers, i);
+            if (nextWriter != writers.begin())
+                dependencies[i].push_back(*std::prev(nextWriter));
+            else if (!resources_[resource].imported)
+            {
+                // Contents of transient framebuffers are undefined until
+                // written, so read the output of a pass declared later.
+                nextWriter = std::ranges::upper_bound(writers, i);
+                if (nextWriter != writers.end())
+                    dependencies[i].push_back(*nextWriter++);
+            }
+
+            if (nextWriter != writers.end() && *nextWriter == i)
+                nextWriter++;
+            if (withAntiDependencies && nextWriter != writers.end())
+                dependencies[*nextWriter].push_back(i);
+        }
+        // Writes are in declaration order.
+        for (auto resource : passes_[i].writes)
+        {
+            for (auto writer : resources_[resource].writers)
+            {
+                if (writer < i)
+                    dependencies[i].push_back(writer);
+            }
+        }
+    }
+
+    for (auto& currDependencies : dependencies)
+    {
+        std::ranges::sort(currDependencies);
+        auto [last, end] = std::ranges::unique(currDependencies);
+        currDependencies.erase(last, end);
+    }
+    return dependencies;
+}
+
+void RenderGraph::CullPasses_(
+    const std::vector<std::vector<std::uint32_t>>& dependencies)
+{
+    std::vector<std::uint32_t> neededPasses;
+    for (std::uint32_t i = 0; i < passes_.size(); i++)
+    {
+        auto& pass = passes_[i];
+        pass.culled = !pass.hasSideEffect && std::ranges::none_of(pass.writes,
+            [this](auto resource) { return resources_[resource].imported; });
+        if (!pass.culled)
+            neededPasses.push_back(i);
+    }
+
+    while (!neededPasses.empty())
+    {
+        auto passIndex = neededPasses.back();
+        neededPasses.pop_back();
+        for (auto dependency : dependencies[passIndex])
+        {
+            if (passes_[dependency].culled)
+            {
+                passes_[dependency].culled = false;
+                neededPasses.push_back(dependency);
+            }
+        }
+    }
+    return;
+}
+
+bool RenderGraph::SortPasses_(
+    const std::vector<std::vector<std::uint32_t>>& dependencies)
+{
+    // Kahn's algorithm, preferring the declaration order among ready passes.
+    std::vector<std::uint32_t> unresolvedNum(passes_.size());
+    std::vector<bool> executed(passes_.size());
+    size_t passNum = 0;
+    for (std::uint32_t i = 0; i < passes_.size(); i++)
+    {
+        if (passes_[i].culled)
+            continue;
+        passNum++;
+        // Culled passes are only depended on by anti-dependencies.
+        unresolvedNum[i] = static_cast<std::uint32_t>(std::ranges::count_if(
+            dependencies[i], [this](auto dependency) { return !passes_[dependency].culled; }));
+    }
+
+    executionOrder_.clear();
+    while (executionOrder_.size() < passNum)
+    {
+        std::uint32_t readyPass = 0;
+        while (readyPass < passes_.size() && (passes_[readyPass].culled ||
+            executed[readyPass] || unresolvedNum[readyPass] != 0))
+            readyPass++;
+        if (readyPass == passes_.size())
+            return false;
+
+        executed[readyPass] = true;
+        executionOrder_.push_back(readyPass);
+        for (std::uint32_t i = 0; i < passes_.size(); i++)
+        {
+            if (std::ranges::binary_search(dependencies[i], readyPass))
+                unresolvedNum[i]--;
+        }
+    }
+    return true;
+}
+
+RenderGraph::FramebufferDesc RenderGraph::ResolveDesc_(
+    const FramebufferDesc& desc) const
+{
+    auto result = desc;
+    if (result.width == 0)
+        result.width = screenWidth_;
+    if (result.height == 0)
+        result.height = screenHeight_;
+    return result;
+}
+
+void RenderGraph::AllocateFramebuffers_()
+{
+    // Lifetime of a transient framebuffer is from its first to its last use.
+    constexpr auto c_never = c_invalidIndex_;
+    std::vector<std::uint32_t> firstUse(resources_.size(), c_never),
+        lastUse(resources_.size(), 0);
+    for (std::uint32_t order = 0; order < executionOrder_.size(); order++)
+    {
+        const auto& pass = passes_[executionOrder_[order]];
+        for (const auto& accesses : { std::cref(pass.reads), std::cref(pass.writes) })
+        {
+            for (auto resource : accesses.get())
+            {
+                firstUse[resource] = std::min(firstUse[resource], order);
+                lastUse[resource] = std::max(lastUse[resource], order);
+            }
+        }
+    }
+
+    for (auto& physical : physicals_)
+        physical.inUse = false;
+    for (std::uint32_t i = 0; i < resources_.size(); i++)
+    {
+        resources_[i].physical = c_invalidIndex_;
+        resources_[i].lastUse = firstUse[i] == c_never ? c_invalidIndex_ : lastUse[i];
+    }
+    std::vector<bool> used(physicals_.size());
+    for (std::uint32_t order = 0; order < executionOrder_.size(); order++)
+    {
+        for (std::uint32_t i = 0; i < resources_.size(); i++)
+        {
+            auto& resource = resources_[i];
+            if (resource.imported || firstUse[i] != order)
+                continue;
+
+            auto desc = ResolveDesc_(resource.desc);
+            auto it = std::ranges::find_if(physicals_, [&desc](const auto& physical) {
+                return !physical.inUse && physical.framebuffer.GetDesc() == desc;
+            });
+            resource.physical = static_cast<std::uint32_t>(it - physicals_.begin());
+            if (it == physicals_.end())
+            {
+                physicals_.push_back({ FramebufferPool::GetInstance().Acquire(desc) });
+                used.push_back(false);
+            }
+            physicals_[resource.physical].inUse = true;
+            used[resource.physical] = true;
+        }
+
+        for (std::uint32_t i = 0; i < resources_.size(); i++)
+        {
+            auto& resource = resources_[i];
+            if (!resource.imported && firstUse[i] != c_never && lastUse[i] == order)
+                physicals_[resource.physical].inUse = false;
+        }
+    }
+
+    // Release framebuffers that are no longer needed, e.g. after resizing.
+    std::vector<std::uint32_t> remap(physicals_.size(), c_invalidIndex_);
+    std::uint32_t keptNum = 0;
+    for (std::uint32_t i = 0; i < physicals_.size(); i++)
+    {
+        if (!used[i])
+            continue;
+        remap[i] = keptNum;
+        if (i != keptNum)
+            physicals_[keptNum] = std::move(physicals_[i]);
+        keptNum++;
+    }
+    physicals_.erase(physicals_.begin() + keptNum, physicals_.end());
+    for (auto& resource : resources_)
+    {
+        if (resource.physical != c_invalidIndex_)
+            resource.physical = remap[resource.physical];
+    }
+    return;
+}
+
+} // namespace OpenGLFramework::Core
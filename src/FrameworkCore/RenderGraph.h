@@ -0,0 +1,145 @@
+#pragma once
+
+#include "FramebufferPool.h"
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace OpenGLFramework::Core
+{
+
+// Passes declare framebuffers they read and write. A read sees the last write
+// declared before it, e.g. ping-pong between two framebuffers; if there is
+// none, a transient framebuffer is read from its first writer declared after,
+// while an imported one keeps its contents from outside, e.g. the last frame.
+// When compiling, passes are ordered by these dependencies, and a write waits
+// for reads of the previous contents; passes whose outputs are never used are
+// culled, and transient framebuffers whose lifetimes don't overlap share the
+// same physical framebuffer if they have the same description.
+class RenderGraph
+{
+    static constexpr std::uint32_t c_invalidIndex_ =
+        std::numeric_limits<std::uint32_t>::max();
+public:
+    struct ResourceHandle
+    {
+        std::uint32_t index = c_invalidIndex_;
+        bool IsValid() const { return index != c_invalidIndex_; }
+    };
+
+    // Width or height being 0 means the screen size(see SetScreenSize).
+    using FramebufferDesc = Core::FramebufferDesc;
+
+    class PassBuilder
+    {
+        friend class RenderGraph;
+    public:
+        ResourceHandle Create(std::string_view name, FramebufferDesc desc);
+        ResourceHandle Read(ResourceHandle resource);
+        ResourceHandle Write(ResourceHandle resource);
+        // e.g. readback or ImGui, so that the pass is never culled.
+        void SetSideEffect();
+    private:
+        RenderGraph& graph_;
+        std::uint32_t passIndex_;
+        PassBuilder(RenderGraph& graph, std::uint32_t passIndex) :
+            graph_{ graph }, passIndex_{ passIndex } {};
+    };
+
+    class PassContext
+    {
+        friend class RenderGraph;
+    public:
+        // nullptr means the default framebuffer.
+        const Framebuffer* GetFramebuffer(ResourceHandle resource) const;
+        // Bind as render target and set the viewport to its size.
+        void UseAsRenderTarget(ResourceHandle resource) const;
+        std::pair<unsigned int, unsigned int> GetSize(ResourceHandle resource) const;
+    private:
+        const RenderGraph& graph_;
+        explicit PassContext(const RenderGraph& graph) : graph_{ graph } {};
+    };
+
+    using SetupFunc = std::function<void(PassBuilder&)>;
+    using ExecuteFunc = std::function<void(const PassContext&)>;
+
+    RenderGraph() = default;
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    // Imported framebuffers are outputs of the graph, so their writers are
+    // never culled; nullptr means the default framebuffer.
+    ResourceHandle Import(std::string_view name, const Framebuffer* framebuffer = nullptr);
+    // Transient framebuffer written by passes later, so that passes may be
+    // added in any order; PassBuilder::Create also makes the pass write it.
+    ResourceHandle Create(std::string_view name, FramebufferDesc desc);
+    void AddPass(std::string_view name, const SetupFunc& setup, ExecuteFunc execute);
+    // Framebuffers depending on the screen size are reallocated when it
+    // changes; physical framebuffers are acquired from FramebufferPool.
+    void SetScreenSize(unsigned int width, unsigned int height);
+
+    // Return false if passes can't be ordered by their dependencies.
+    bool Compile();
+    // Compile first if needed; should be called on the context thread.
+    // Transient framebuffers are invalidated after their last use, so their
+    // contents needn't be written back to memory.
+    void Execute();
+    // Remove all passes and resources; physical framebuffers are kept to be
+    // reused by the next compilation.
+    void Clear();
+
+    bool IsCulled(std::string_view passName) const;
+    std::vector<std::string_view> GetExecutionOrder() const;
+    size_t GetPhysicalFramebufferNum() const { return physicals_.size(); }
+
+private:
+    struct Pass_
+    {
+        std::string name;
+        ExecuteFunc execute;
+        std::vector<std::uint32_t> reads{};
+        std::vector<std::uint32_t> writes{};
+        bool hasSideEffect = false;
+        bool culled = false;
+    };
+    struct Resource_
+    {
+        std::string name;
+        FramebufferDesc desc{};
+        bool imported = false;
+        const Framebuffer* importedFramebuffer = nullptr;
+        // Indices of passes in declaration order.
+        std::vector<std::uint32_t> writers{};
+        std::uint32_t physical = c_invalidIndex_;
+        // Order of the last pass using it, after which it's invalidated.
+        std::uint32_t lastUse = c_invalidIndex_;
+    };
+    struct Physical_
+    {
+        PooledFramebuffer framebuffer;
+        bool inUse = false;
+    };
+
+    std::vector<Pass_> passes_;
+    std::vector<Resource_> resources_;
+    std::vector<Physical_> physicals_;
+    std::vector<std::uint32_t> executionOrder_;
+    unsigned int screenWidth_ = 1, screenHeight_ = 1;
+    bool compiled_ = false;
+
+    // Anti-dependencies, i.e. writes waiting for reads of previous contents,
+    // only constrain the order and don't keep readers from being culled.
+    std::vector<std::vector<std::uint32_t>> CollectDependencies_(
+        bool withAntiDependencies) const;
+    bool SortPasses_(const std::vector<std::vector<std::uint32_t>>& dependencies);
+    void CullPasses_(const std::vector<std::vector<std::uint32_t>>& dependencies);
+    void AllocateFramebuffers_();
+    FramebufferDesc ResolveDesc_(const FramebufferDesc& desc) const;
+};
+
+} // namespace OpenGLFramework::Core
@@ -0,0 +1,273 @@
+#include "RenderGraph.h"
+#include "ContextManager.h"
+#include "MainWindow.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace OpenGLFramework::Core;
+
+using Handle = RenderGraph::ResourceHandle;
+
+static RenderGraph::ExecuteFunc Record(std::vector<std::string>& executed,
+    std::string name)
+{
+    return [&executed, name](const RenderGraph::PassContext&) {
+        executed.push_back(name);
+    };
+}
+
+TEST_CASE("Render-Graph-Order")
+{
+    RenderGraph graph;
+    graph.SetScreenSize(32, 32);
+    std::vector<std::string> executed;
+    Framebuffer shadowMapBuffer{ 16, 16 };
+    auto screen = graph.Import("screen");
+    auto shadowMap = graph.Import("shadow map", &shadowMapBuffer);
+    auto gBuffer = graph.Create("gBuffer", {});
+    auto lighting = graph.Create("lighting", {});
+
+    // Passes are declared before their producers, and the shadow map of the
+    // last frame is read before it's written.
+    graph.AddPass("final", [&](RenderGraph::PassBuilder& builder) {
+        builder.Read(lighting);
+        builder.Read(shadowMap);
+        builder.Write(screen);
+    }, Record(executed, "final"));
+    graph.AddPass("lighting", [&](RenderGraph::PassBuilder& builder) {
+        builder.Read(gBuffer);
+        builder.Write(lighting);
+    }, Record(executed, "lighting"));
+    graph.AddPass("geometry", [&](RenderGraph::PassBuilder& builder) {
+        builder.Write(gBuffer);
+    }, Record(executed, "geometry"));
+    graph.AddPass("shadow", [&](RenderGraph::PassBuilder& builder) {
+        builder.Write(shadowMap);
+    }, Record(executed, "shadow"));
+
+    REQUIRE(graph.Compile());
+    graph.Execute();
+    REQUIRE(executed == std::vector<std::string>{ "geometry", "lighting",
+        "final", "shadow" });
+    REQUIRE(glGetError() == GL_NO_ERROR);
+}
+
+TEST_CASE("Render-Graph-Cycle")
+{
+    RenderGraph graph;
+    graph.SetScreenSize(32, 32);
+    std::vector<std::string> executed;
+    auto screen = graph.Import("screen");
+    auto x = graph.Create("x", {});
+    auto y = graph.Create("y", {});
+
+    graph.AddPass("a", [&](RenderGraph::PassBuilder& builder) {
+        builder.Read(x);
+        builder.Write(y);
+    }, Record(executed, "a"));
+    graph.AddPass("b", [&](RenderGraph::PassBuilder& builder) {
+        builder.Read(y);
+        builder.Write(x);
+        builder.Write(screen);
+    }, Record(executed, "b"));
+
+    REQUIRE(!graph.Compile());
+    graph.Execute();
+    REQUIRE(executed.empty());
+}
+
+TEST_CASE("Render-Graph-Ping-Pong")
+{
+    RenderGraph graph;
+    graph.SetScreenSize(32, 32);
+    std::vector<std::string> executed;
+    auto screen = graph.Import("screen");
+    Handle ping, pong;
+
+    graph.AddPass("scene", [&](RenderGraph::PassBuilder& builder) {
+        ping = builder.Create("ping", {});
+    }, Record(executed, "scene"));
+    graph.AddPass("blur horizontal", [&](RenderGraph::PassBuilder& builder) {
+        builder.Read(ping);
+        pong = builder.Create("pong", {});
+    }, Record(executed, "blur horizontal"));
+    graph.AddPass("blur vertical", [&](RenderGraph::PassBuilder& builder) {
+        builder.Read(pong);
+        builder.Write(ping);
+    }, Record(executed, "blur vertical"));
+    graph.AddPass("present", [&](RenderGraph::PassBuilder& builder) {
+        builder.Read(ping);
+        builder.Write(screen);
+    }, Record(executed, "present"));
+
+    REQUIRE(graph.Compile());
+    graph.Execute();
+    REQUIRE(executed == std::vector<std::string>{ "scene", "blur horizontal",
+        "blur vertical", "present" });
+    REQUIRE(graph.GetPhysicalFramebufferNum() == 2);
+    REQUIRE(glGetError() == GL_NO_ERROR);
+}
+
+TEST_CASE("Render-Graph-Read-Modify-Write")
+{
+    RenderGraph graph;
+    graph.SetScreenSize(32, 32);
+    std::vector<std::string> executed;
+    auto screen = graph.Import("screen");
+    Handle scene;
+
+    graph.AddPass("scene", [&](RenderGraph::PassBuilder& builder) {
+        scene = builder.Create("scene", {});
+    }, Record(executed, "scene"));
+    graph.AddPass("decal", [&](RenderGraph::PassBuilder& builder) {
+        builder.Read(scene);
+        builder.Write(scene);
+    }, Record(executed, "decal"));
+    graph.AddPass("fog", [&](RenderGraph::PassBuilder& builder) {
+        builder.Read(scene);
+        builder.Write(scene);
+    }, Record(executed, "fog"));
+    graph.AddPass("present", [&](RenderGraph::PassBuilder& builder) {
+        builder.Read(scene);
+        builder.Write(screen);
+    }, Record(executed, "present"));
+
+    REQUIRE(graph.Compile());
+    graph.Execute();
+    REQUIRE(executed == std::vector<std::string>{ "scene", "decal", "fog",
+        "present" });
+    REQUIRE(glGetError() == GL_NO_ERROR);
+}
+
+TEST_CASE("Render-Graph-Cull")
+{
+    RenderGraph graph;
+    graph.SetScreenSize(32, 32);
+    auto screen = graph.Import("screen");
+    Handle scene;
+
+    graph.AddPass("scene", [&](RenderGraph::PassBuilder& builder) {
+        scene = builder.Create("scene", {});
+    }, [](const RenderGraph::PassContext&) {});
+    graph.AddPass("debug", [&](RenderGraph::PassBuilder& builder) {
+        builder.Read(scene);
+        builder.Create("debug view", {});
+    }, [](const RenderGraph::PassContext&) {});
+    graph.AddPass("present", [&](RenderGraph::PassBuilder& builder) {
+        builder.Read(scene);
+        builder.Write(screen);
+    }, [](const RenderGraph::PassContext&) {});
+    graph.AddPass("readback", [&](RenderGraph::PassBuilder& builder) {
+        builder.SetSideEffect();
+    }, [](const RenderGraph::PassContext&) {});
+
+    REQUIRE(graph.Compile());
+    REQUIRE(graph.IsCulled("debug"));
+    REQUIRE_FALSE(graph.IsCulled("scene"));
+    REQUIRE_FALSE(graph.IsCulled("present"));
+    REQUIRE_FALSE(graph.IsCulled("readback"));
+    REQUIRE(graph.GetExecutionOrder().size() == 3);
+    REQUIRE(graph.GetPhysicalFramebufferNum() == 1);
+}
+
+TEST_CASE("Render-Graph-Alias")
+{
+    RenderGraph graph;
+    graph.SetScreenSize(32, 32);
+    auto screen = graph.Import("screen");
+    Handle first, second, third;
+    const Framebuffer *firstBuffer = nullptr, *thirdBuffer = nullptr;
+
+    graph.AddPass("first", [&](RenderGraph::PassBuilder& builder) {
+        first = builder.Create("first", {});
+    }, [&](const RenderGraph::PassContext& context) {
+        firstBuffer = context.GetFramebuffer(first);
+    });
+    graph.AddPass("second", [&](RenderGraph::PassBuilder& builder) {
+        builder.Read(first);
+        second = builder.Create("second", {});
+    }, [](const RenderGraph::PassContext&) {});
+    // first is dead here, so third can take its place.
+    graph.AddPass("third", [&](RenderGraph::PassBuilder& builder) {
+        builder.Read(second);
+        third = builder.Create("third", {});
+    }, [&](const RenderGraph::PassContext& context) {
+        thirdBuffer = context.GetFramebuffer(third);
+    });
+    graph.AddPass("present", [&](RenderGraph::PassBuilder& builder) {
+        builder.Read(third);
+        builder.Write(screen);
+    }, [&](const RenderGraph::PassContext& context) {
+        REQUIRE(context.GetFramebuffer(screen) == nullptr);
+        REQUIRE(context.GetSize(screen) == std::pair{ 32u, 32u });
+    });
+
+    graph.Execute();
+    REQUIRE(graph.GetPhysicalFramebufferNum() == 2);
+    REQUIRE(firstBuffer == thirdBuffer);
+
+    SECTION("Different description")
+    {
+        graph.Clear();
+        graph.AddPass("small", [&](RenderGraph::PassBuilder& builder) {
+            first = builder.Create("small", { .width = 8, .height = 8 });
+        }, [](const RenderGraph::PassContext&) {});
+        graph.AddPass("large", [&](RenderGraph::PassBuilder& builder) {
+            builder.Read(first);
+            second = builder.Create("large", {});
+        }, [](const RenderGraph::PassContext&) {});
+        graph.AddPass("present", [&](RenderGraph::PassBuilder& builder) {
+            builder.Read(second);
+            builder.SetSideEffect();
+        }, [&](const RenderGraph::PassContext& context) {
+            REQUIRE(context.GetSize(first) == std::pair{ 8u, 8u });
+            REQUIRE(context.GetSize(second) == std::pair{ 32u, 32u });
+        });
+        graph.Execute();
+        REQUIRE(graph.GetPhysicalFramebufferNum() == 2);
+    }
+
+    SECTION("Resize")
+    {
+        graph.SetScreenSize(64, 48);
+        graph.Execute();
+        REQUIRE(graph.GetPhysicalFramebufferNum() == 2);
+        REQUIRE(firstBuffer->GetWidth() == 64);
+        REQUIRE(firstBuffer->GetHeight() == 48);
+    }
+    REQUIRE(glGetError() == GL_NO_ERROR);
+}
+
+TEST_CASE("Render-Graph-Feedback")
+{
+    RenderGraph graph;
+    graph.SetScreenSize(32, 32);
+    auto screen = graph.Import("screen");
+    auto a = graph.Import("a", nullptr), b = graph.Import("b", nullptr);
+
+    // pass1 reads b of the last frame, so it isn't a cycle.
+    graph.AddPass("pass1", [&](RenderGraph::PassBuilder& builder) {
+        builder.Read(b);
+        builder.Write(a);
+    }, [](const RenderGraph::PassContext&) {});
+    graph.AddPass("pass2", [&](RenderGraph::PassBuilder& builder) {
+        builder.Read(a);
+        builder.Write(b);
+        builder.Write(screen);
+    }, [](const RenderGraph::PassContext&) {});
+
+    REQUIRE(graph.Compile());
+    REQUIRE(graph.GetExecutionOrder() == std::vector<std::string_view>{ "pass1", "pass2" });
+}
+
+int main()
+{
+    [[maybe_unused]] ContextManager& manager = ContextManager::GetInstance();
+    MainWindow useForContextWindow{ 50, 50, "test", false };
+    auto result = Catch::Session().run();
+    return result;
+}
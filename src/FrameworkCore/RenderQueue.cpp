@@ -0,0 +1,164 @@
+#include "RenderQueue.h"
+#include "GLStateCache.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <utility>
+
+namespace OpenGLFramework::Core
+{
+
+std::uint64_t RenderQueue::MakeSortKey(std::uint32_t programIndex,
+    std::uint32_t materialIndex, float depth)
+{
+    // Indices beyond the bits only make grouping worse, so just saturate.
+    constexpr std::uint32_t programMask = (1u << c_programBits_) - 1,
+        materialMask = (1u << c_materialBits_) - 1;
+    programIndex = std::min(programIndex, programMask);
+    materialIndex = std::min(materialIndex, materialMask);
+
+    // Flip bits of floats so that they're ordered as unsigned integers.
+    auto depthBits = std::bit_cast<std::uint32_t>(depth);
+    depthBits ^= (depthBits & 0x80000000u) ? 0xFFFFFFFFu : 0x80000000u;
+
+    return (static_cast<std::uint64_t>(programIndex) << (64 - c_programBits_)) |
+        (static_cast<std::uint64_t>(materialIndex) << 32) | depthBits;
+}
+
+void RenderQueue::Push(const Shader& shader, const BasicTriRenderModel& model,
+    const glm::mat4& view)
+{
+    const auto transform = model.transform.GetModelMatrix();
+    for (auto& mesh : model.meshes)
+        Push(shader, mesh, transform, view);
+    return;
+}
+
+void RenderQueue::Push(const Shader& shader, const BasicTriRenderMesh& mesh,
+    const glm::mat4& transform, const glm::mat4& view)
+{
+    // Camera looks at -z in view space.
+    const auto viewPos = view * transform * glm::vec4{ mesh.boundCenter_, 1.0f };
+    Push(DrawPacket{
+        .shader = &shader, .material = mesh.GetMaterial_(shader),
+        .vertexArray = mesh.VAO,
+        .indexNum = static_cast<GLsizei>(mesh.triangles.size() * 3),
+        .depth = -viewPos.z, .transform = transform
+    });
+    return;
+}
+
+void RenderQueue::Push(const DrawPacket& packet)
+{
+    const auto index = static_cast<std::uint32_t>(packets_.size());
+    auto programIt = programIndices_.try_emplace(packet.shader->GetSerial(),
+        static_cast<std::uint32_t>(programIndices_.size())).first;
+    auto materialIt = materialIndices_.try_emplace(packet.material.get(),
+        static_cast<std::uint32_t>(materialIndices_.size())).first;
+
+    packets_.push_back(packet);
+    sortedItems_.push_back({ MakeSortKey(programIt->second, materialIt->second,
+        packet.depth), index });
+    return;
+}
+
+void RenderQueue::Sort()
+{
+    // LSD radix sort by bytes, which is stable and linear; passes where all
+    // keys share the same byte are skipped, e.g. high bytes of few programs.
+    constexpr int c_radixBits = 8, c_passNum = 64 / c_radixBits;
+    std::array<std::array<std::uint32_t, 256>, c_passNum> histograms{};
+    for (const auto& item : sortedItems_)
+    {
+        for (int pass = 0; pass < c_passNum; pass++)
+            histograms[pass][(item.key >> (pass * c_radixBits)) & 0xFF]++;
+    }
+
+    const auto itemNum = static_cast<std::uint32_t>(sortedItems_.size());
+    sortBuffer_.resize(sortedItems_.size());
+    for (int pass = 0; pass < c_passNum; pass++)
+    {
+        auto& histogram = histograms[pass];
+        if (std::ranges::find(histogram, itemNum) != histogram.end())
+            continue;
+
+        std::uint32_t offset = 0;
+        for (auto& count : histogram)
+            offset += std::exchange(count, offset);
+        for (const auto& item : sortedItems_)
+        {
+            auto& dst = histogram[(item.key >> (pass * c_radixBits)) & 0xFF];
+            sortBuffer_[dst++] = item;
+        }
+        sortedItems_.swap(sortBuffer_);
+    }
+    return;
+}
+
+void RenderQueue::Submit(UniformID modelUniform,
+    const std::function<void(int, const Shader&)>& preprocess) const
+{
+    auto& stateCache = GLStateCache::GetInstance();
+    const Shader* currShader = nullptr;
+    const Material* currMaterial = nullptr;
+    for (const auto& item : sortedItems_)
+    {
+        const auto& packet = packets_[item.index];
+        if (packet.shader != currShader)
+        {
+            currShader = packet.shader;
+            currShader->Activate();
+            currMaterial = nullptr;
+        }
+        if (packet.material.get() != currMaterial)
+        {
+            currMaterial = packet.material.get();
+            int textureCnt = currMaterial->Apply(*currShader);
+            if (preprocess)
+                preprocess(textureCnt, *currShader);
+        }
+
+        currShader->SetMat4(modelUniform, packet.transform);
+        stateCache.BindVertexArray(packet.vertexArray);
+        glDrawElements(GL_TRIANGLES, packet.indexNum, GL_UNSIGNED_INT, 0);
+    }
+    return;
+}
+
+void RenderQueue::Record(CommandBuffer& buffer, UniformID modelUniform,
+    const std::function<void(int, const Shader&)>* preprocess) const
+{
+    const Shader* currShader = nullptr;
+    const Material* currMaterial = nullptr;
+    for (const auto& item : sortedItems_)
+    {
+        const auto& packet = packets_[item.index];
+        if (packet.shader != currShader)
+        {
+            currShader = packet.shader;
+            buffer.Record(Commands::UseShader{ currShader });
+            currMaterial = nullptr;
+        }
+        if (packet.material.get() != currMaterial)
+        {
+            currMaterial = packet.material.get();
+            buffer.Record(Commands::ApplyMaterial{ packet.material, preprocess });
+        }
+
+        buffer.Record(Commands::SetMat4{ modelUniform, packet.transform });
+        buffer.Record(Commands::DrawIndexed{ packet.vertexArray, packet.indexNum });
+    }
+    return;
+}
+
+void RenderQueue::Clear()
+{
+    packets_.clear();
+    sortedItems_.clear();
+    programIndices_.clear();
+    materialIndices_.clear();
+    return;
+}
+
+} // namespace OpenGLFramework::Core
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Shader.h"
+#include "Material.h"
+#include "Model.h"
+#include "CommandBuffer.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace OpenGLFramework::Core
+{
+
+struct DrawPacket
+{
+    const Shader* shader = nullptr;
+    // Shared with the mesh, so that it stays valid until the packet is drawn.
+    std::shared_ptr<const Material> material;
+    GLuint vertexArray = 0;
+    GLsizei indexNum = 0;
+    // Distance along the view direction, used to draw front-to-back.
+    float depth = 0.0f;
+    glm::mat4 transform{ 1.0f };
+};
+
+// Draws are recorded into a flat array instead of being issued immediately,
+// then sorted by 64-bit keys so that draws of the same program and material
+// are grouped, and front-to-back inside a group to benefit early-z. Keys are
+// laid out as | program(12) | material(20) | depth(32) |, where program and
+// material are indices assigned in the order they're first pushed.
+class RenderQueue
+{
+    static constexpr int c_programBits_ = 12;
+    static constexpr int c_materialBits_ = 20;
+public:
+    // Push every mesh of the model; depth is computed from bounding centers.
+    void Push(const Shader& shader, const BasicTriRenderModel& model,
+        const glm::mat4& view);
+    void Push(const Shader& shader, const BasicTriRenderMesh& mesh,
+        const glm::mat4& transform, const glm::mat4& view);
+    void Push(const DrawPacket& packet);
+
+    void Sort();
+    // Packets are drawn in sorted order; transform is uploaded as modelUniform.
+    // preprocess is called when the material changes, to bind extra textures
+    // from the given texture unit, e.g. shadow maps.
+    void Submit(UniformID modelUniform = "model"_uniform,
+        const std::function<void(int, const Shader&)>& preprocess = nullptr) const;
+    // Same as Submit but only records commands, so that it can be called on
+    // worker threads; preprocess should be alive until execution.
+    void Record(CommandBuffer& buffer, UniformID modelUniform = "model"_uniform,
+        const std::function<void(int, const Shader&)>* preprocess = nullptr) const;
+    // Keep the capacity, so that the next frame needn't allocate.
+    void Clear();
+
+    size_t GetSize() const { return packets_.size(); }
+    // Valid after Sort.
+    const DrawPacket& GetSortedPacket(size_t index) const {
+        return packets_[sortedItems_[index].index];
+    }
+    std::uint64_t GetSortedKey(size_t index) const {
+        return sortedItems_[index].key;
+    }
+
+    static std::uint64_t MakeSortKey(std::uint32_t programIndex,
+        std::uint32_t materialIndex, float depth);
+
+private:
+    struct SortItem_
+    {
+        std::uint64_t key;
+        std::uint32_t index;
+    };
+    std::vector<DrawPacket> packets_;
+    std::vector<SortItem_> sortedItems_;
+    std::vector<SortItem_> sortBuffer_;
+    std::unordered_map<std::uint64_t, std::uint32_t> programIndices_;
+    std::unordered_map<const Material*, std::uint32_t> materialIndices_;
+};
+
+} // namespace OpenGLFramework::Core
@@ -0,0 +1,242 @@
+#include "RenderQueue.h"
+#include "ContextManager.h"
+#include "MainWindow.h"
+#include "SpecialModels/SpecialModel.h"
+#include "../Utility/IO/IniFile.h"
+#include "TestShader.test.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <random>
+#include <unordered_map>
+
+using namespace OpenGLFramework::Core;
+OpenGLFramework::IOExtension::IniFile config{ TEST_CONFIG_PATH };
+
+static const char* c_vertShader = R"(#version 330 core
+layout(location = 0) in vec3 position;
+uniform mat4 model;
+uniform mat4 view;
+void main() { gl_Position = view * model * vec4(position, 1.0); }
+)";
+
+static const char* c_fragShader = R"(#version 330 core
+out vec4 FragColor;
+uniform vec4 color;
+void main() { FragColor = color; }
+)";
+
+static std::vector<glm::mat4> GetTransforms(size_t num)
+{
+    std::mt19937 generator{ 42 };
+    std::uniform_real_distribution<float> distribution{ -50.0f, 50.0f };
+    std::vector<glm::mat4> transforms(num, glm::mat4{ 1.0f });
+    for (auto& transform : transforms)
+    {
+        transform[3] = glm::vec4{ distribution(generator),
+            distribution(generator), distribution(generator), 1.0f };
+    }
+    return transforms;
+}
+
+TEST_CASE("Sort-Key")
+{
+    REQUIRE(RenderQueue::MakeSortKey(0, 5, 100.0f) <
+        RenderQueue::MakeSortKey(1, 0, 1.0f));
+    REQUIRE(RenderQueue::MakeSortKey(0, 0, 100.0f) <
+        RenderQueue::MakeSortKey(0, 1, 1.0f));
+    REQUIRE(RenderQueue::MakeSortKey(0, 0, -2.0f) <
+        RenderQueue::MakeSortKey(0, 0, -1.0f));
+    REQUIRE(RenderQueue::MakeSortKey(0, 0, -1.0f) <
+        RenderQueue::MakeSortKey(0, 0, 0.5f));
+    REQUIRE(RenderQueue::MakeSortKey(0, 0, 0.5f) <
+        RenderQueue::MakeSortKey(0, 0, 2.0f));
+}
+
+TEST_CASE("Render-Queue")
+{
+    std::array<Shader, 2> shaders{ CreateShader(c_vertShader, c_fragShader),
+        CreateShader(c_vertShader, c_fragShader) };
+    std::vector<std::shared_ptr<const Material>> materials;
+    for (int i = 0; i < 16; i++)
+        materials.push_back(std::make_shared<const Material>());
+    const auto transforms = GetTransforms(4096);
+
+    RenderQueue queue;
+    std::mt19937 generator{ 0 };
+    std::uniform_real_distribution<float> depthDistribution{ -10.0f, 100.0f };
+    for (size_t i = 0; i < transforms.size(); i++)
+    {
+        queue.Push(DrawPacket{ .shader = &shaders[i % shaders.size()],
+            .material = materials[i % materials.size()],
+            .depth = depthDistribution(generator), .transform = transforms[i] });
+    }
+    queue.Sort();
+    REQUIRE(queue.GetSize() == transforms.size());
+
+    std::vector<std::uint64_t> keys(queue.GetSize());
+    for (size_t i = 0; i < keys.size(); i++)
+        keys[i] = queue.GetSortedKey(i);
+    REQUIRE(std::ranges::is_sorted(keys));
+
+    // Every program and material forms one contiguous group.
+    size_t shaderChanges = 0, materialChanges = 0;
+    for (size_t i = 1; i < queue.GetSize(); i++)
+    {
+        const auto& prev = queue.GetSortedPacket(i - 1);
+        const auto& curr = queue.GetSortedPacket(i);
+        shaderChanges += prev.shader != curr.shader;
+        materialChanges += prev.material != curr.material;
+        if (prev.material == curr.material)
+            REQUIRE(prev.depth <= curr.depth);
+    }
+    REQUIRE(shaderChanges == shaders.size() - 1);
+    REQUIRE(materialChanges == materials.size() - 1);
+
+    queue.Clear();
+    REQUIRE(queue.GetSize() == 0);
+}
+
+TEST_CASE("Render-Queue-Submit")
+{
+    std::array<Shader, 2> shaders{ CreateShader(c_vertShader, c_fragShader),
+        CreateShader(c_vertShader, c_fragShader) };
+    auto cube = Cube::GetBasicTriRenderModel();
+    const auto transforms = GetTransforms(256);
+    const glm::mat4 view{ 1.0f };
+    auto& stateCache = GLStateCache::GetInstance();
+
+    RenderQueue queue;
+    for (size_t i = 0; i < transforms.size(); i++)
+    {
+        queue.Push(shaders[i % shaders.size()], cube.meshes[0], transforms[i],
+            view);
+    }
+
+    // Unsorted queue is drawn in push order, i.e. programs alternate.
+    stateCache.EndFrame();
+    queue.Submit();
+    const auto unsortedCalls = stateCache.GetCurrFrameStatistics().issuedCalls;
+
+    queue.Sort();
+    stateCache.EndFrame();
+    queue.Submit();
+    const auto sortedCalls = stateCache.GetCurrFrameStatistics().issuedCalls;
+    REQUIRE(sortedCalls < unsortedCalls);
+    REQUIRE(glGetError() == GL_NO_ERROR);
+}
+
+TEST_CASE("Render-Queue-Material-Cache")
+{
+    std::vector<Shader> shaders;
+    for (int i = 0; i < 12; i++)
+        shaders.push_back(CreateShader(c_vertShader, c_fragShader));
+    auto cube = Cube::GetBasicTriRenderModel();
+    const glm::mat4 transform{ 1.0f }, view{ 1.0f };
+
+    RenderQueue queue;
+    queue.Push(shaders[0], cube.meshes[0], transform, view);
+    queue.Push(shaders[0], cube.meshes[0], transform, view);
+    queue.Sort();
+    const auto material = queue.GetSortedPacket(0).material;
+    REQUIRE(queue.GetSortedPacket(1).material == material);
+
+    // Textures change, so a new material is made while queued packets keep
+    // the one they're pushed with.
+    auto& path = config.rootSection.GetEntry("texture_path")->get();
+    cube.AttachTexture(std::filesystem::path{
+        reinterpret_cast<const char8_t*>(path.c_str()) }, { 0 });
+    queue.Push(shaders[0], cube.meshes[0], transform, view);
+    queue.Sort();
+    REQUIRE(queue.GetSortedPacket(0).material == material);
+    REQUIRE(queue.GetSortedPacket(2).material != material);
+    queue.Submit();
+
+    // More shaders than the cache holds; evicted materials are still alive
+    // and created for the shader of their packets.
+    queue.Clear();
+    for (auto& shader : shaders)
+        queue.Push(shader, cube.meshes[0], transform, view);
+    queue.Sort();
+    for (size_t i = 0; i < queue.GetSize(); i++)
+    {
+        const auto& packet = queue.GetSortedPacket(i);
+        REQUIRE(packet.material->IsCreatedFor(*packet.shader));
+    }
+    queue.Submit();
+    REQUIRE(glGetError() == GL_NO_ERROR);
+}
+
+TEST_CASE("Render-Queue-Benchmark")
+{
+    constexpr size_t c_meshNum = 4096, c_shaderNum = 4;
+    std::vector<Shader> shaders;
+    for (size_t i = 0; i < c_shaderNum; i++)
+        shaders.push_back(CreateShader(c_vertShader, c_fragShader));
+
+    std::unordered_map<size_t, BasicTriRenderModel> models;
+    const auto transforms = GetTransforms(c_meshNum);
+    for (size_t i = 0; i < c_meshNum; i++)
+    {
+        auto [it, _] = models.try_emplace(i, Cube::GetBasicTriRenderModel());
+        it->second.transform.position = glm::vec3{ transforms[i][3] };
+    }
+    const glm::mat4 view{ 1.0f };
+
+    BENCHMARK("Immediate draw in hash-map order")
+    {
+        for (auto& [id, model] : models)
+        {
+            auto& shader = shaders[id % c_shaderNum];
+            shader.Activate();
+            shader.SetMat4("model"_uniform, model.transform.GetModelMatrix());
+            model.Draw(shader);
+        }
+        glFinish();
+    };
+
+    RenderQueue queue;
+    BENCHMARK("Push, radix sort and submit")
+    {
+        queue.Clear();
+        for (auto& [id, model] : models)
+            queue.Push(shaders[id % c_shaderNum], model, view);
+        queue.Sort();
+        queue.Submit();
+        glFinish();
+    };
+
+    BENCHMARK("Push and radix sort")
+    {
+        queue.Clear();
+        for (auto& [id, model] : models)
+            queue.Push(shaders[id % c_shaderNum], model, view);
+        queue.Sort();
+        return queue.GetSortedKey(0);
+    };
+
+    std::vector<std::uint64_t> keys(c_meshNum);
+    BENCHMARK("Push and std::sort")
+    {
+        queue.Clear();
+        for (auto& [id, model] : models)
+            queue.Push(shaders[id % c_shaderNum], model, view);
+        for (size_t i = 0; i < keys.size(); i++)
+            keys[i] = queue.GetSortedKey(i);
+        std::ranges::sort(keys);
+        return keys[0];
+    };
+}
+
+int main()
+{
+    [[maybe_unused]] ContextManager& manager = ContextManager::GetInstance();
+    MainWindow useForContextWindow{ 50, 50, "test", false };
+    auto result = Catch::Session().run();
+    return result;
+}
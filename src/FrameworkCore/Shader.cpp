@@ -1,6 +1,10 @@
 #include "Shader.h"
+#include "UniformBuffer.h"
+#include "ProgramBinaryCache.h"
 #include "Utility/IO/IOExtension.h"
+#include <atomic>
 #include <vector>
+#include <string>
 
 namespace OpenGLFramework::Core
 {
@@ -8,15 +12,11 @@ namespace OpenGLFramework::Core
 Shader::Shader(const std::filesystem::path& vertexShaderFilePath, 
     const std::filesystem::path& fragmentShaderPath)
 {
-    std::array<unsigned int, 2> shaders;
-
-    std::string fileContent = IOExtension::ReadAll(vertexShaderFilePath);
-    shaders[0] = CompileShader_(fileContent, GL_VERTEX_SHADER);
-
-    fileContent = IOExtension::ReadAll(fragmentShaderPath);
-    shaders[1] = CompileShader_(fileContent, GL_FRAGMENT_SHADER);
-
-    LinkShaders_(shaders);
+    std::array<ShaderSource, 2> sources{ {
+        { GL_VERTEX_SHADER, IOExtension::ReadAll(vertexShaderFilePath) },
+        { GL_FRAGMENT_SHADER, IOExtension::ReadAll(fragmentShaderPath) }
+    } };
+    BuildProgram_(sources);
     return;
 };
 
@@ -24,20 +24,41 @@ Shader::Shader(const std::filesystem::path& vertexShaderFilePath,
     const std::filesystem::path& geometryShaderPath, 
     const std::filesystem::path& fragmentShaderPath)
 {
-    std::array<unsigned int, 3> shaders;
-
-    std::string fileContent = IOExtension::ReadAll(vertexShaderFilePath);
-    shaders[0] = CompileShader_(fileContent, GL_VERTEX_SHADER);
+    std::array<ShaderSource, 3> sources{ {
+        { GL_VERTEX_SHADER, IOExtension::ReadAll(vertexShaderFilePath) },
+        { GL_GEOMETRY_SHADER, IOExtension::ReadAll(geometryShaderPath) },
+        { GL_FRAGMENT_SHADER, IOExtension::ReadAll(fragmentShaderPath) }
+    } };
+    BuildProgram_(sources);
+    return;
+};
 
-    fileContent = IOExtension::ReadAll(geometryShaderPath);
-    shaders[1] = CompileShader_(fileContent, GL_GEOMETRY_SHADER);
+void Shader::BuildProgram_(std::span<const ShaderSource> sources)
+{
+    auto& cache = ProgramBinaryCache::GetInstance();
+    const bool useCache = cache.IsEnabled();
+    std::uint64_t key = 0;
+    if (useCache)
+    {
+        key = cache.GetKey(sources);
+        if (GLuint program = cache.Load(key); program != 0)
+        {
+            shaderID_ = program;
+            OnLinked_();
+            return;
+        }
+    }
 
-    fileContent = IOExtension::ReadAll(fragmentShaderPath);
-    shaders[2] = CompileShader_(fileContent, GL_FRAGMENT_SHADER);
+    std::vector<unsigned int> shaders;
+    shaders.reserve(sources.size());
+    for (const auto& source : sources)
+        shaders.push_back(CompileShader_(source.content, source.type));
+    LinkShaders_(shaders, useCache);
 
-    LinkShaders_(shaders);
+    if (useCache && shaderID_ != 0)
+        cache.Store(key, shaderID_);
     return;
-};
+}
 
 unsigned int Shader::CompileShader_(std::string_view shaderContent, 
     const GLenum shaderType)
@@ -52,17 +73,33 @@ unsigned int Shader::CompileShader_(std::string_view shaderContent,
     if (compileSuccess == GL_TRUE) [[likely]]
         return newShader;
     // Else compile fails.
-    GLint length = 0;
-    glGetShaderiv(newShader, GL_INFO_LOG_LENGTH, &length);
-    std::vector<GLchar> errorLog(length);
-    GLchar* logPtr = errorLog.data();
-    glGetShaderInfoLog(newShader, length - 1, &length, logPtr);
-    IOExtension::LogError(std::string_view{logPtr});
-
+    LogShaderError_(newShader);
     glDeleteShader(newShader);
     return 0;
 };
 
+void Shader::LogShaderError_(GLuint shader)
+{
+    GLint length = 0;
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+    std::vector<GLchar> errorLog(length + 1);
+    GLchar* logPtr = errorLog.data();
+    glGetShaderInfoLog(shader, length, &length, logPtr);
+    IOExtension::LogError(std::string_view{ logPtr });
+    return;
+}
+
+void Shader::LogProgramError_(GLuint program)
+{
+    GLint length = 0;
+    glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+    std::vector<GLchar> errorLog(length + 1);
+    GLchar* logPtr = errorLog.data();
+    glGetProgramInfoLog(program, length, &length, logPtr);
+    IOExtension::LogError(std::string_view{ logPtr });
+    return;
+}
+
 void Shader::ClearShaders_(std::span<unsigned int> shaders)
 {
     for (auto& shader : shaders)
@@ -70,13 +107,18 @@ void Shader::ClearShaders_(std::span<unsigned int> shaders)
     return;
 }
 
-void Shader::LinkShaders_(std::span<unsigned int> shaders)
+void Shader::LinkShaders_(std::span<unsigned int> shaders, bool retrievable)
 {
     GLuint newShaderAssembly = glCreateProgram();
     for (auto& shader : shaders)
     {
         glAttachShader(newShaderAssembly, shader);
     }
+    if (retrievable)
+    {
+        glProgramParameteri(newShaderAssembly, 
+            GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     glLinkProgram(newShaderAssembly);
 
     GLint linkSuccess = 0;
@@ -85,19 +127,86 @@ void Shader::LinkShaders_(std::span<unsigned int> shaders)
     {
         shaderID_ = newShaderAssembly;
         ClearShaders_(shaders);
+        OnLinked_();
         return;
     }
     // Else link fails.
-    GLint length = 0;
-    glGetProgramiv(newShaderAssembly, GL_INFO_LOG_LENGTH, &length);
-    std::vector<GLchar> errorLog(length);
-    GLchar* logPtr = errorLog.data();
-    glGetProgramInfoLog(newShaderAssembly, length - 1, &length, logPtr);
-    IOExtension::LogError(std::string_view{ logPtr });
-
+    LogProgramError_(newShaderAssembly);
     glDeleteProgram(newShaderAssembly);
     ClearShaders_(shaders);
     return;
 }
 
+void Shader::OnLinked_()
+{
+    static std::atomic<std::uint64_t> s_serialCounter = 0;
+    serial_ = ++s_serialCounter;
+    CollectUniforms_();
+    BindUniformBlocks_();
+    return;
+}
+
+void Shader::CollectUniforms_()
+{
+    GLint uniformNum = 0, maxNameLen = 0;
+    glGetProgramiv(shaderID_, GL_ACTIVE_UNIFORMS, &uniformNum);
+    glGetProgramiv(shaderID_, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLen);
+
+    std::vector<GLchar> nameBuffer(maxNameLen + 1);
+    auto addUniform = [this](const std::string& name, GLenum type) {
+        GLint location = glGetUniformLocation(shaderID_, name.c_str());
+        // Members of uniform blocks have no location.
+        if (location < 0)
+            return std::uint32_t(-1);
+        auto index = static_cast<std::uint32_t>(uniformSlots_.size());
+        uniformSlots_.push_back({ .location = location, .type = type });
+        uniformIndices_.emplace(StringExtension::HashFNV1a(name), index);
+        return index;
+    };
+
+    for (GLint i = 0; i < uniformNum; i++)
+    {
+        GLsizei nameLen = 0;
+        GLint arraySize = 0;
+        GLenum type = 0;
+        glGetActiveUniform(shaderID_, static_cast<GLuint>(i), maxNameLen,
+            &nameLen, &arraySize, &type, nameBuffer.data());
+        std::string name{ nameBuffer.data(), static_cast<size_t>(nameLen) };
+
+        // Arrays are reported as "arr[0]" with size; register every element.
+        if (name.ends_with("[0]"))
+        {
+            auto baseName = name.substr(0, name.size() - 3);
+            auto index = addUniform(name, type);
+            if (index != std::uint32_t(-1))
+                uniformIndices_.emplace(StringExtension::HashFNV1a(baseName), index);
+            for (GLint element = 1; element < arraySize; element++)
+                addUniform(baseName + "[" + std::to_string(element) + "]", type);
+        }
+        else
+            addUniform(name, type);
+    }
+    return;
+}
+
+void Shader::BindUniformBlocks_()
+{
+    GLint blockNum = 0, maxNameLen = 0;
+    glGetProgramiv(shaderID_, GL_ACTIVE_UNIFORM_BLOCKS, &blockNum);
+    glGetProgramiv(shaderID_, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxNameLen);
+
+    std::vector<GLchar> nameBuffer(maxNameLen + 1);
+    auto& binding = UniformBlockBinding::GetInstance();
+    for (GLint i = 0; i < blockNum; i++)
+    {
+        GLsizei nameLen = 0;
+        glGetActiveUniformBlockName(shaderID_, static_cast<GLuint>(i), 
+            maxNameLen, &nameLen, nameBuffer.data());
+        glUniformBlockBinding(shaderID_, static_cast<GLuint>(i), 
+            binding.GetBindingPoint({ nameBuffer.data(), 
+                static_cast<size_t>(nameLen) }));
+    }
+    return;
+}
+
 } // namespace OpenGLFramework::Core
\ No newline at end of file
@@ -3,101 +3,257 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include "GLStateCache.h"
+#include "Utility/String/StringExtension.h"
+
 #include <filesystem>
 #include <array>
+#include <string>
 #include <string_view>
 #include <span>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <unordered_map>
+#include <vector>
 
 namespace OpenGLFramework::Core
 {
 
+// Uniform name hashed by FNV-1a; use "name"_uniform to hash at compile time,
+// so that no string is processed when setting uniforms.
+struct UniformID
+{
+    std::uint64_t hash;
+    constexpr explicit UniformID(std::string_view name) :
+        hash{ StringExtension::HashFNV1a(name) } {};
+    constexpr bool operator==(const UniformID&) const = default;
+};
+
+struct ShaderSource
+{
+    GLenum type;
+    std::string content;
+};
+
+inline namespace UniformLiterals
+{
+consteval UniformID operator""_uniform(const char* name, size_t len)
+{
+    return UniformID{ std::string_view{ name, len } };
+}
+} // namespace UniformLiterals
+
 class Shader
 {
+    friend class ShaderBatch;
+    friend class ShaderVariants;
 public:
     Shader(const std::filesystem::path& vertexShaderFilePath, 
         const std::filesystem::path& fragmentShaderPath);
     Shader(const std::filesystem::path& vertexShaderFilePath, 
         const std::filesystem::path& geometryShaderPath, 
         const std::filesystem::path& fragmentShaderPath);
+    // e.g. sources processed by ShaderPreprocessor.
+    explicit Shader(std::span<const ShaderSource> sources) {
+        BuildProgram_(sources);
+    }
     Shader(const Shader& another) = delete;
     Shader& operator=(const Shader& another) = delete;
-    Shader(Shader&& another) noexcept :shaderID_{another.shaderID_} {
+    Shader(Shader&& another) noexcept : shaderID_{ another.shaderID_ },
+        serial_{ std::exchange(another.serial_, 0) },
+        uniformIndices_{ std::move(another.uniformIndices_) },
+        uniformSlots_{ std::move(another.uniformSlots_) },
+        skipRedundantUpload_{ another.skipRedundantUpload_ }
+    {
         another.shaderID_ = 0;
     };
     Shader& operator=(Shader&& another) noexcept { 
         if (&another == this) [[unlikely]]
             return *this;
         
+        GLStateCache::GetInstance().OnProgramDeleted(shaderID_);
         glDeleteProgram(shaderID_);
         shaderID_ = another.shaderID_;
         another.shaderID_ = 0;
+        serial_ = std::exchange(another.serial_, 0);
+        uniformIndices_ = std::move(another.uniformIndices_);
+        uniformSlots_ = std::move(another.uniformSlots_);
+        skipRedundantUpload_ = another.skipRedundantUpload_;
+        return *this;
     }
     ~Shader() {
+        GLStateCache::GetInstance().OnProgramDeleted(shaderID_);
         glDeleteProgram(shaderID_);
         return;
     };
 
-    void Activate() const { glUseProgram(shaderID_); };
+    void Activate() const { GLStateCache::GetInstance().UseProgram(shaderID_); };
+    GLuint GetID() const { return shaderID_; }
+    // Unique among all linked shaders, while GL may reuse IDs of deleted
+    // programs; 0 for invalid shaders. Used to key per-shader caches.
+    std::uint64_t GetSerial() const { return serial_; }
 
+    // Locations are collected by glGetActiveUniform when linking; -1 if the
+    // uniform doesn't exist or is optimized out.
+    GLint GetUniformLocation(UniformID id) const {
+        auto it = uniformIndices_.find(id.hash);
+        return it == uniformIndices_.end() ? -1 : uniformSlots_[it->second].location;
+    }
+    GLint GetUniformLocation(const char* name) const {
+        return GetUniformLocation(UniformID{ name });
+    }
+
+    // Uploads are skipped if the value is same as the last one set by this
+    // shader. NOTICE: values set by glUniform* directly aren't tracked.
+    void SetSkipRedundantUpload(bool skip) {
+        skipRedundantUpload_ = skip;
+        for (auto& slot : uniformSlots_)
+            slot.cached = false;
+    }
+
+    void SetBool(UniformID id, const bool value) const {
+        SetInt(id, static_cast<int>(value));
+    }
     void SetBool(const char* name, const bool value) const {
-        glUniform1i(glGetUniformLocation(shaderID_, name), (int)value);
+        SetBool(UniformID{ name }, value);
     }
 
+    void SetInt(UniformID id, const int value) const {
+        if (auto location = PrepareUpload_(id, value); location >= 0)
+            glUniform1i(location, value);
+    }
     void SetInt(const char* name, const int value) const {
-        glUniform1i(glGetUniformLocation(shaderID_, name), value);
+        SetInt(UniformID{ name }, value);
     }
 
+    void SetFloat(UniformID id, const float value) const {
+        if (auto location = PrepareUpload_(id, value); location >= 0)
+            glUniform1f(location, value);
+    }
     void SetFloat(const char* name, const float value) const {
-        glUniform1f(glGetUniformLocation(shaderID_, name), value);
+        SetFloat(UniformID{ name }, value);
     }
 
+    void SetVec2(UniformID id, const glm::vec2 value) const {
+        if (auto location = PrepareUpload_(id, value); location >= 0)
+            glUniform2fv(location, 1, &value[0]);
+    }
     void SetVec2(const char* name, const glm::vec2 value) const {
-        glUniform2fv(glGetUniformLocation(shaderID_, name), 1, &value[0]);
+        SetVec2(UniformID{ name }, value);
     }
     void SetVec2(const char* name, const float x, const float y) const {
-        glUniform2f(glGetUniformLocation(shaderID_, name), x, y);
+        SetVec2(UniformID{ name }, glm::vec2{ x, y });
     }
 
+    void SetVec3(UniformID id, const glm::vec3& value) const {
+        if (auto location = PrepareUpload_(id, value); location >= 0)
+            glUniform3fv(location, 1, &value[0]);
+    }
     void SetVec3(const char* name, const glm::vec3& value) const {
-        glUniform3fv(glGetUniformLocation(shaderID_, name), 1, &value[0]);
+        SetVec3(UniformID{ name }, value);
     }
     void SetVec3(const char* name, const float x, const float y, 
         const float z) const 
     {
-        glUniform3f(glGetUniformLocation(shaderID_, name), x, y, z);
+        SetVec3(UniformID{ name }, glm::vec3{ x, y, z });
     }
 
+    void SetVec4(UniformID id, const glm::vec4& value) const {
+        if (auto location = PrepareUpload_(id, value); location >= 0)
+            glUniform4fv(location, 1, &value[0]);
+    }
     void SetVec4(const char* name, const glm::vec4& value) const {
-        glUniform4fv(glGetUniformLocation(shaderID_, name), 1, &value[0]);
+        SetVec4(UniformID{ name }, value);
     }
     void SetVec4(const char* name, const float x, const float y,
         const float z, const float w) const 
     {
-        glUniform4f(glGetUniformLocation(shaderID_, name), x, y, z, w);
+        SetVec4(UniformID{ name }, glm::vec4{ x, y, z, w });
     }
 
+    void SetMat2(UniformID id, const glm::mat2& mat) const {
+        if (auto location = PrepareUpload_(id, mat); location >= 0)
+            glUniformMatrix2fv(location, 1, GL_FALSE, &mat[0][0]);
+    }
     void SetMat2(const char* name, const glm::mat2& mat) const {
-        glUniformMatrix2fv(glGetUniformLocation(shaderID_, name), 1, 
-            GL_FALSE, &mat[0][0]);
+        SetMat2(UniformID{ name }, mat);
     }
 
+    void SetMat3(UniformID id, const glm::mat3& mat) const {
+        if (auto location = PrepareUpload_(id, mat); location >= 0)
+            glUniformMatrix3fv(location, 1, GL_FALSE, &mat[0][0]);
+    }
     void SetMat3(const char* name, const glm::mat3& mat) const {
-        glUniformMatrix3fv(glGetUniformLocation(shaderID_, name), 1, 
-            GL_FALSE, &mat[0][0]);
+        SetMat3(UniformID{ name }, mat);
     }
 
+    void SetMat4(UniformID id, const glm::mat4& mat) const {
+        if (auto location = PrepareUpload_(id, mat); location >= 0)
+            glUniformMatrix4fv(location, 1, GL_FALSE, &mat[0][0]);
+    }
     void SetMat4(const char* name, const glm::mat4& mat) const {
-        glUniformMatrix4fv(glGetUniformLocation(shaderID_, name), 1, 
-            GL_FALSE, &mat[0][0]);
+        SetMat4(UniformID{ name }, mat);
     }
 
 private:
     // Here shaderID actually means OpenGL's program.
-    GLuint shaderID_;
+    GLuint shaderID_ = 0;
+    std::uint64_t serial_ = 0;
+
+    struct UniformSlot_
+    {
+        GLint location;
+        GLenum type;
+        bool cached = false;
+        // large enough for mat4.
+        alignas(float) std::array<unsigned char, 64> value{};
+    };
+    // Array elements are registered as both "arr" and "arr[0]", which share
+    // the same slot so that the cached value is consistent.
+    std::unordered_map<std::uint64_t, std::uint32_t> uniformIndices_;
+    mutable std::vector<UniformSlot_> uniformSlots_;
+    bool skipRedundantUpload_ = false;
+
+    // Return the location to upload, or -1 if the upload can be skipped.
+    template<typename T>
+    GLint PrepareUpload_(UniformID id, const T& value) const
+    {
+        static_assert(std::is_trivially_copyable_v<T> && 
+            sizeof(T) <= sizeof(UniformSlot_::value));
+        auto it = uniformIndices_.find(id.hash);
+        if (it == uniformIndices_.end())
+            return -1;
+
+        auto& slot = uniformSlots_[it->second];
+        if (skipRedundantUpload_)
+        {
+            if (slot.cached && std::memcmp(slot.value.data(), &value, sizeof(T)) == 0)
+                return -1;
+            std::memcpy(slot.value.data(), &value, sizeof(T));
+            slot.cached = true;
+        }
+        return slot.location;
+    }
+
+    // Take ownership of a linked program, or an invalid shader if it's 0.
+    explicit Shader(GLuint linkedProgram) : shaderID_{ linkedProgram } {
+        if (shaderID_ != 0)
+            OnLinked_();
+    }
+
+    // Try the program binary cache first, otherwise compile and link.
+    void BuildProgram_(std::span<const ShaderSource> sources);
     unsigned int CompileShader_(std::string_view shaderContent,
         const GLenum shaderType);
-    void LinkShaders_(std::span<unsigned int> shaders);
+    void LinkShaders_(std::span<unsigned int> shaders, bool retrievable = false);
     void ClearShaders_(std::span<unsigned int> shaders);
+    void OnLinked_();
+    static void LogShaderError_(GLuint shader);
+    static void LogProgramError_(GLuint program);
+    void CollectUniforms_();
+    void BindUniformBlocks_();
 };
 
 } // namespace OpenGLFramework::Core
@@ -0,0 +1,192 @@
+#include "ShaderBatch.h"
+#include "Utility/IO/IOExtension.h"
+#include "Utility/GLHelper/GLFeature.h"
+
+#include <GLFW/glfw3.h>
+
+#include <array>
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+namespace OpenGLFramework::Core
+{
+
+// Loaded by name since the extension is absent in the GL 3.3 loader.
+static void SetMaxShaderCompilerThreads()
+{
+    static const bool set = [] {
+        using MaxThreadsFunc = void (*)(GLuint);
+        auto func = reinterpret_cast<MaxThreadsFunc>(
+            glfwGetProcAddress("glMaxShaderCompilerThreadsKHR"));
+        if (func == nullptr)
+        {
+            func = reinterpret_cast<MaxThreadsFunc>(
+                glfwGetProcAddress("glMaxShaderCompilerThreadsARB"));
+        }
+        // 0xFFFFFFFF means implementation-specific maximum.
+        if (func != nullptr)
+            func(0xFFFFFFFF);
+        return true;
+    }();
+    (void)set;
+    return;
+}
+
+ShaderBatch::ShaderBatch() : 
+    parallelCompile_{ GLHelper::SupportParallelShaderCompile() }
+{
+    if (parallelCompile_)
+        SetMaxShaderCompilerThreads();
+    return;
+}
+
+ShaderBatch::~ShaderBatch()
+{
+    for (auto& entry : entries_)
+    {
+        for (auto stage : entry.stages)
+            glDeleteShader(stage);
+        // Finished programs are owned by shader.
+        if (entry.state == State::Compiling)
+            glDeleteProgram(entry.program);
+    }
+    return;
+}
+
+size_t ShaderBatch::Add(std::span<const ShaderSource> sources)
+{
+    auto& entry = entries_.emplace_back();
+    auto& cache = ProgramBinaryCache::GetInstance();
+    entry.useCache = cache.IsEnabled();
+    if (entry.useCache)
+    {
+        entry.cacheKey = cache.GetKey(sources);
+        if (GLuint program = cache.Load(entry.cacheKey); program != 0)
+        {
+            entry.program = program;
+            entry.state = State::Ready;
+            entry.shader.emplace(Shader{ program });
+            return entries_.size() - 1;
+        }
+    }
+
+    // No status is queried here, which would wait for the compiler.
+    entry.program = glCreateProgram();
+    for (const auto& source : sources)
+    {
+        GLuint stage = glCreateShader(source.type);
+        const char* contentPtr = source.content.c_str();
+        glShaderSource(stage, 1, &contentPtr, nullptr);
+        glCompileShader(stage);
+        glAttachShader(entry.program, stage);
+        entry.stages.push_back(stage);
+    }
+    if (entry.useCache)
+    {
+        glProgramParameteri(entry.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+            GL_TRUE);
+    }
+    glLinkProgram(entry.program);
+    return entries_.size() - 1;
+}
+
+size_t ShaderBatch::Add(const std::filesystem::path& vertexShaderPath,
+    const std::filesystem::path& fragmentShaderPath)
+{
+    std::array<ShaderSource, 2> sources{ {
+        { GL_VERTEX_SHADER, IOExtension::ReadAll(vertexShaderPath) },
+        { GL_FRAGMENT_SHADER, IOExtension::ReadAll(fragmentShaderPath) }
+    } };
+    return Add(sources);
+}
+
+size_t ShaderBatch::Add(const std::filesystem::path& vertexShaderPath,
+    const std::filesystem::path& geometryShaderPath,
+    const std::filesystem::path& fragmentShaderPath)
+{
+    std::array<ShaderSource, 3> sources{ {
+        { GL_VERTEX_SHADER, IOExtension::ReadAll(vertexShaderPath) },
+        { GL_GEOMETRY_SHADER, IOExtension::ReadAll(geometryShaderPath) },
+        { GL_FRAGMENT_SHADER, IOExtension::ReadAll(fragmentShaderPath) }
+    } };
+    return Add(sources);
+}
+
+ShaderBatch::State ShaderBatch::GetState(size_t index)
+{
+    auto& entry = entries_[index];
+    if (entry.state != State::Compiling)
+        return entry.state;
+
+    if (parallelCompile_)
+    {
+        GLint completed = GL_FALSE;
+        glGetProgramiv(entry.program, GL_COMPLETION_STATUS_KHR, &completed);
+        if (completed == GL_FALSE)
+            return State::Compiling;
+    }
+    Finish_(entry);
+    return entry.state;
+}
+
+const Shader& ShaderBatch::GetOr(size_t index, const Shader& fallback)
+{
+    if (GetState(index) == State::Ready)
+        return *entries_[index].shader;
+    return fallback;
+}
+
+Shader& ShaderBatch::Get(size_t index)
+{
+    auto& entry = entries_[index];
+    if (entry.state == State::Compiling)
+        Finish_(entry);
+    return *entry.shader;
+}
+
+void ShaderBatch::WaitAll()
+{
+    for (auto& entry : entries_)
+    {
+        if (entry.state == State::Compiling)
+            Finish_(entry);
+    }
+    return;
+}
+
+void ShaderBatch::Finish_(Entry_& entry)
+{
+    GLint linkSuccess = 0;
+    glGetProgramiv(entry.program, GL_LINK_STATUS, &linkSuccess);
+    if (linkSuccess == GL_TRUE) [[likely]]
+    {
+        if (entry.useCache)
+            ProgramBinaryCache::GetInstance().Store(entry.cacheKey, entry.program);
+        entry.state = State::Ready;
+        entry.shader.emplace(Shader{ entry.program });
+    }
+    else
+    {
+        // Report the failed stages first, since their errors are the cause.
+        for (auto stage : entry.stages)
+        {
+            GLint compileSuccess = 0;
+            glGetShaderiv(stage, GL_COMPILE_STATUS, &compileSuccess);
+            if (compileSuccess != GL_TRUE)
+                Shader::LogShaderError_(stage);
+        }
+        Shader::LogProgramError_(entry.program);
+        glDeleteProgram(entry.program);
+        entry.state = State::Failed;
+        entry.shader.emplace(Shader{ 0 });
+    }
+
+    for (auto stage : entry.stages)
+        glDeleteShader(stage);
+    entry.stages.clear();
+    return;
+}
+
+} // namespace OpenGLFramework::Core
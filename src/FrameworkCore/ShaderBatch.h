@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Shader.h"
+#include "ProgramBinaryCache.h"
+
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace OpenGLFramework::Core
+{
+
+// Stages and programs are all submitted to the driver when added, and their
+// status is only queried later, so the driver can compile them concurrently.
+// With GL_KHR_parallel_shader_compile, readiness is checked without blocking,
+// so a fallback program can be drawn until the real one is ready; otherwise
+// checking a program waits for it.
+class ShaderBatch
+{
+public:
+    enum class State { Compiling, Ready, Failed };
+
+    ShaderBatch();
+    ShaderBatch(const ShaderBatch&) = delete;
+    ShaderBatch& operator=(const ShaderBatch&) = delete;
+    ~ShaderBatch();
+
+    // Return the index of program in the batch.
+    size_t Add(std::span<const ShaderSource> sources);
+    size_t Add(const std::filesystem::path& vertexShaderPath,
+        const std::filesystem::path& fragmentShaderPath);
+    size_t Add(const std::filesystem::path& vertexShaderPath,
+        const std::filesystem::path& geometryShaderPath,
+        const std::filesystem::path& fragmentShaderPath);
+    size_t GetSize() const { return entries_.size(); }
+
+    State GetState(size_t index);
+    bool IsReady(size_t index) { return GetState(index) == State::Ready; }
+    // The ready program, or fallback if it's still compiling or fails.
+    // References returned by GetOr and Get stay valid after adding more.
+    const Shader& GetOr(size_t index, const Shader& fallback);
+    // Block until finished; a failed program has ID 0. The shader can be
+    // moved out, e.g. std::move(batch.Get(index)).
+    Shader& Get(size_t index);
+    void WaitAll();
+
+private:
+    struct Entry_
+    {
+        std::vector<GLuint> stages;
+        GLuint program = 0;
+        std::uint64_t cacheKey = 0;
+        bool useCache = false;
+        State state = State::Compiling;
+        std::optional<Shader> shader;
+    };
+    // Deque so that adding doesn't move shaders already handed out.
+    std::deque<Entry_> entries_;
+    bool parallelCompile_;
+
+    void Finish_(Entry_& entry);
+};
+
+} // namespace OpenGLFramework::Core
@@ -0,0 +1,66 @@
+#include "ShaderBatch.h"
+#include "ContextManager.h"
+#include "MainWindow.h"
+#include "../Utility/IO/IniFile.h"
+#include "../Utility/IO/IOExtension.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+
+#include <array>
+
+using namespace OpenGLFramework::Core;
+OpenGLFramework::IOExtension::IniFile config{ TEST_CONFIG_PATH };
+
+TEST_CASE("Shader-Batch")
+{
+    // Always compile from sources here.
+    ProgramBinaryCache::GetInstance().SetEnabled(false);
+    auto getPath = [](const char* name) {
+        return std::filesystem::path{ config.rootSection(name) };
+    };
+    const std::array<ShaderSource, 2> brokenSources{ {
+        { GL_VERTEX_SHADER, OpenGLFramework::IOExtension::ReadAll(getPath("Vert_Shader")) },
+        { GL_FRAGMENT_SHADER, "#version 330 core\nnot glsl" }
+    } };
+
+    ShaderBatch batch;
+    const auto basic = batch.Add(getPath("Vert_Shader"), getPath("Frag_Shader"));
+    const auto blinnPhong = batch.Add(getPath("Blinn_Phong_Vert_Shader"),
+        getPath("Blinn_Phong_Frag_Shader"));
+    const auto broken = batch.Add(brokenSources);
+    REQUIRE(batch.GetSize() == 3);
+
+    Shader fallback{ getPath("Vert_Shader"), getPath("Frag_Shader") };
+    const Shader& current = batch.GetOr(blinnPhong, fallback);
+    if (batch.GetState(blinnPhong) != ShaderBatch::State::Ready)
+        REQUIRE(&current == &fallback);
+
+    batch.WaitAll();
+    REQUIRE(batch.IsReady(basic));
+    REQUIRE(batch.IsReady(blinnPhong));
+    REQUIRE(batch.GetState(broken) == ShaderBatch::State::Failed);
+    REQUIRE(&batch.GetOr(broken, fallback) == &fallback);
+    REQUIRE(batch.Get(broken).GetID() == 0);
+
+    // Adding more doesn't invalidate references handed out before.
+    const Shader& basicShader = batch.Get(basic);
+    const GLuint basicID = basicShader.GetID();
+    for (int i = 0; i < 16; i++)
+        batch.Add(getPath("Vert_Shader"), getPath("Frag_Shader"));
+    REQUIRE(&batch.Get(basic) == &basicShader);
+    REQUIRE(basicShader.GetID() == basicID);
+
+    Shader moved = std::move(batch.Get(basic));
+    REQUIRE(moved.GetID() != 0);
+    REQUIRE(moved.GetUniformLocation("model") >= 0);
+    ProgramBinaryCache::GetInstance().SetEnabled(true);
+}
+
+int main()
+{
+    [[maybe_unused]] ContextManager& manager = ContextManager::GetInstance();
+    MainWindow useForContextWindow{ 50, 50, "test", false };
+    auto result = Catch::Session().run();
+    return result;
+}
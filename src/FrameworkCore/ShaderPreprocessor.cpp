@@ -0,0 +1,189 @@
+#include "ShaderPreprocessor.h"
+#include "Utility/IO/IOExtension.h"
+#include "Utility/String/StringExtension.h"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+namespace OpenGLFramework::Core
+{
+
+// Return the rest of line if it's the directive, e.g. "#  include x" -> " x".
+static std::optional<std::string_view> MatchDirective(std::string_view line,
+    std::string_view directive)
+{
+    line = StringExtension::TrimBegin(line);
+    if (!line.starts_with('#'))
+        return std::nullopt;
+    line = StringExtension::TrimBegin(line.substr(1));
+    if (!line.starts_with(directive))
+        return std::nullopt;
+    auto rest = line.substr(directive.size());
+    if (!rest.empty() && !std::isspace(static_cast<unsigned char>(rest[0])) &&
+        rest[0] != '"' && rest[0] != '<')
+        return std::nullopt;
+    return rest;
+}
+
+// Tokens may be separated by any whitespace, e.g. "#  pragma\tonce // x".
+static bool IsPragmaOnce(std::string_view line)
+{
+    auto rest = MatchDirective(line, "pragma");
+    if (!rest.has_value())
+        return false;
+    auto tokens = StringExtension::Trim(*rest);
+    auto tokenEnd = std::ranges::find_if(tokens,
+        [](char ch) { return std::isspace(static_cast<unsigned char>(ch)) != 0; });
+    return std::string_view{ tokens.begin(), tokenEnd } == "once";
+}
+
+// The same file may be reached through different include paths, e.g.
+// relative to the includer, through an include directory or a symlink; both
+// recursion and #pragma once are checked by this key.
+static std::string GetFileKey(const std::filesystem::path& path)
+{
+    std::error_code error;
+    auto canonicalPath = std::filesystem::weakly_canonical(path, error);
+    return (error ? path.lexically_normal() : canonicalPath).string();
+}
+
+std::optional<std::string> ShaderPreprocessor::Process(
+    const std::filesystem::path& path, const ShaderDefines& defines)
+{
+    files_.clear();
+    includeStack_.clear();
+    onceFiles_.clear();
+
+    std::string output;
+    if (!Process_(path, &defines, output))
+        return std::nullopt;
+    return output;
+}
+
+std::string ShaderPreprocessor::GetDefinesKey(const ShaderDefines& defines)
+{
+    auto sortedDefines = defines;
+    std::ranges::sort(sortedDefines);
+    std::string key;
+    for (const auto& [name, value] : sortedDefines)
+        key += name + '=' + value + ';';
+    return key;
+}
+
+std::optional<std::filesystem::path> ShaderPreprocessor::Resolve_(
+    std::string_view name, const std::filesystem::path& includer) const
+{
+    std::error_code error;
+    auto candidate = includer.parent_path() / name;
+    if (std::filesystem::is_regular_file(candidate, error))
+        return candidate;
+    for (const auto& directory : includeDirectories_)
+    {
+        candidate = directory / name;
+        if (std::filesystem::is_regular_file(candidate, error))
+            return candidate;
+    }
+    return std::nullopt;
+}
+
+bool ShaderPreprocessor::Process_(const std::filesystem::path& path,
+    const ShaderDefines* defines, std::string& output)
+{
+    auto normalPath = path.lexically_normal();
+    auto fileKey = GetFileKey(normalPath);
+    if (std::ranges::find(includeStack_, fileKey) != includeStack_.end())
+        [[unlikely]]
+    {
+        IOExtension::LogError("Recursive include of " + normalPath.string());
+        return false;
+    }
+    std::error_code error;
+    if (!std::filesystem::is_regular_file(normalPath, error)) [[unlikely]]
+    {
+        IOExtension::LogError("Cannot open shader " + normalPath.string());
+        return false;
+    }
+
+    const auto fileIndex = std::to_string(files_.size());
+    files_.push_back(normalPath);
+    includeStack_.push_back(fileKey);
+
+    std::string source = IOExtension::ReadAll(normalPath);
+    std::istringstream content{ source };
+    std::string line;
+    // Defines are injected right after #version, which must come first, or
+    // at the beginning if there is no #version.
+    size_t defineLine = 0;
+    if (defines != nullptr)
+    {
+        std::istringstream versionFinder{ source };
+        for (size_t lineNum = 1; std::getline(versionFinder, line); lineNum++)
+        {
+            if (MatchDirective(line, "version").has_value())
+            {
+                defineLine = lineNum;
+                break;
+            }
+        }
+    }
+    auto injectDefines = [&](size_t nextLine) {
+        for (const auto& [name, value] : *defines)
+            output += "#define " + name + ' ' + value + '\n';
+        output += "#line " + std::to_string(nextLine) + ' ' + fileIndex + '\n';
+    };
+    if (defines != nullptr && defineLine == 0)
+        injectDefines(1);
+
+    for (size_t lineNum = 1; std::getline(content, line); lineNum++)
+    {
+        if (IsPragmaOnce(line))
+        {
+            onceFiles_.insert(fileKey);
+            output += '\n';
+            continue;
+        }
+
+        auto includeRest = MatchDirective(line, "include");
+        if (!includeRest.has_value())
+        {
+            output += line;
+            output += '\n';
+            if (lineNum == defineLine)
+                injectDefines(lineNum + 1);
+            continue;
+        }
+
+        auto name = StringExtension::Trim(*includeRest);
+        if (name.size() < 2 || !((name.front() == '"' && name.back() == '"') ||
+            (name.front() == '<' && name.back() == '>'))) [[unlikely]]
+        {
+            IOExtension::LogError("Invalid include in " + normalPath.string() +
+                " at line " + std::to_string(lineNum));
+            return false;
+        }
+        name = name.substr(1, name.size() - 2);
+
+        auto includePath = Resolve_(name, normalPath);
+        if (!includePath.has_value()) [[unlikely]]
+        {
+            IOExtension::LogError("Cannot find " + std::string{ name } +
+                " included by " + normalPath.string());
+            return false;
+        }
+        if (onceFiles_.contains(GetFileKey(*includePath)))
+        {
+            output += '\n';
+            continue;
+        }
+        output += "#line 1 " + std::to_string(files_.size()) + '\n';
+        if (!Process_(*includePath, nullptr, output))
+            return false;
+        output += "#line " + std::to_string(lineNum + 1) + ' ' + fileIndex + '\n';
+    }
+
+    includeStack_.pop_back();
+    return true;
+}
+
+} // namespace OpenGLFramework::Core
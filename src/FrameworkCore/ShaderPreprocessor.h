@@ -0,0 +1,51 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace OpenGLFramework::Core
+{
+
+// Pairs of name and value, e.g. { "SHADOW_OPTION", "2" }; value may be empty.
+using ShaderDefines = std::vector<std::pair<std::string, std::string>>;
+
+// Expand #include "file" (or <file>) and inject #define after #version.
+// Included files are searched in the directory of the includer and then in
+// the include directories; #pragma once is respected. #line directives are
+// inserted, where the source string number is the index in GetFiles() of
+// the last processing, so errors reported by the driver can be located.
+// NOTICE: conditionals aren't evaluated, so #include in #if is expanded too.
+class ShaderPreprocessor
+{
+public:
+    void AddIncludeDirectory(const std::filesystem::path& directory) {
+        includeDirectories_.push_back(directory);
+    }
+
+    // nullopt if any file cannot be read or includes recursively.
+    std::optional<std::string> Process(const std::filesystem::path& path,
+        const ShaderDefines& defines = {});
+    const std::vector<std::filesystem::path>& GetFiles() const { return files_; }
+
+    // Canonical key of defines, independent of their order.
+    static std::string GetDefinesKey(const ShaderDefines& defines);
+
+private:
+    std::vector<std::filesystem::path> includeDirectories_;
+    std::vector<std::filesystem::path> files_;
+    // Keys of files(see GetFileKey in the source).
+    std::vector<std::string> includeStack_;
+    std::unordered_set<std::string> onceFiles_;
+
+    bool Process_(const std::filesystem::path& path, const ShaderDefines* defines,
+        std::string& output);
+    std::optional<std::filesystem::path> Resolve_(std::string_view name,
+        const std::filesystem::path& includer) const;
+};
+
+} // namespace OpenGLFramework::Core
@@ -0,0 +1,105 @@
+#include "ShaderPreprocessor.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <fstream>
+
+using namespace OpenGLFramework::Core;
+
+static void WriteFile(const std::filesystem::path& path, std::string_view content)
+{
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream{ path } << content;
+    return;
+}
+
+TEST_CASE("Include-And-Define")
+{
+    const std::filesystem::path root = "ShaderPreprocessor.test";
+    WriteFile(root / "main.frag", "// comment\n#version 330 core\n"
+        "#include \"common.glsl\"\n#include <lib/light.glsl>\n"
+        "#include \"common.glsl\"\nvoid main() {}\n");
+    WriteFile(root / "common.glsl", "#pragma once\nfloat common;\n");
+    WriteFile(root / "include/lib/light.glsl", "vec3 light;\n");
+
+    ShaderPreprocessor preprocessor;
+    preprocessor.AddIncludeDirectory(root / "include");
+    auto result = preprocessor.Process(root / "main.frag",
+        { { "SHADOW_OPTION", "2" }, { "USE_PCF", "" } });
+    REQUIRE(result.has_value());
+    REQUIRE(preprocessor.GetFiles().size() == 3);
+
+    const auto& source = *result;
+    auto versionPos = source.find("#version 330 core");
+    REQUIRE(versionPos != std::string::npos);
+    REQUIRE(source.find("#define SHADOW_OPTION 2") > versionPos);
+    REQUIRE(source.find("#define USE_PCF") > versionPos);
+    REQUIRE(source.find("#include") == std::string::npos);
+    REQUIRE(source.find("vec3 light;") != std::string::npos);
+    // Included only once due to #pragma once.
+    auto commonPos = source.find("float common;");
+    REQUIRE(commonPos != std::string::npos);
+    REQUIRE(source.find("float common;", commonPos + 1) == std::string::npos);
+    REQUIRE(source.find("void main() {}") > commonPos);
+
+    SECTION("Recursive include")
+    {
+        WriteFile(root / "a.glsl", "#include \"b.glsl\"\n");
+        WriteFile(root / "b.glsl", "#include \"a.glsl\"\n");
+        REQUIRE_FALSE(preprocessor.Process(root / "a.glsl").has_value());
+    }
+
+    SECTION("Once through different paths")
+    {
+        // Found relative to the includer and through an absolute directory.
+        preprocessor.AddIncludeDirectory(std::filesystem::absolute(root));
+        WriteFile(root / "sub/twice.frag", "#include \"../common.glsl\"\n"
+            "#include <common.glsl>\n");
+        auto twice = preprocessor.Process(root / "sub/twice.frag");
+        REQUIRE(twice.has_value());
+        auto pos = twice->find("float common;");
+        REQUIRE(pos != std::string::npos);
+        REQUIRE(twice->find("float common;", pos + 1) == std::string::npos);
+    }
+
+    SECTION("Recursive include through a symlink")
+    {
+        std::error_code error;
+        std::filesystem::remove(root / "alias", error);
+        std::filesystem::create_directory_symlink(".", root / "alias", error);
+        if (!error)
+        {
+            // root/alias/loop.glsl, root/alias/alias/loop.glsl... are the
+            // same file, although lexically different.
+            WriteFile(root / "loop.glsl", "#include \"alias/loop.glsl\"\n");
+            REQUIRE_FALSE(preprocessor.Process(root / "loop.glsl").has_value());
+        }
+    }
+
+    SECTION("Pragma once with other whitespace")
+    {
+        WriteFile(root / "spaced.glsl", "  #  pragma\tonce  // comment\r\n"
+            "float spaced;\n");
+        WriteFile(root / "spaced.frag", "#include \"spaced.glsl\"\n"
+            "#include \"spaced.glsl\"\n");
+        auto spaced = preprocessor.Process(root / "spaced.frag");
+        REQUIRE(spaced.has_value());
+        auto pos = spaced->find("float spaced;");
+        REQUIRE(pos != std::string::npos);
+        REQUIRE(spaced->find("float spaced;", pos + 1) == std::string::npos);
+    }
+
+    SECTION("Missing include")
+    {
+        WriteFile(root / "missing.frag", "#include \"none.glsl\"\n");
+        REQUIRE_FALSE(preprocessor.Process(root / "missing.frag").has_value());
+    }
+}
+
+TEST_CASE("Defines-Key")
+{
+    REQUIRE(ShaderPreprocessor::GetDefinesKey({ { "A", "1" }, { "B", "" } }) ==
+        ShaderPreprocessor::GetDefinesKey({ { "B", "" }, { "A", "1" } }));
+    REQUIRE(ShaderPreprocessor::GetDefinesKey({ { "A", "1" } }) !=
+        ShaderPreprocessor::GetDefinesKey({ { "A", "2" } }));
+}
@@ -0,0 +1,114 @@
+#include "Shader.h"
+#include "ContextManager.h"
+#include "MainWindow.h"
+#include "../Utility/IO/IniFile.h"
+#include "TestShader.test.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <string>
+
+using namespace OpenGLFramework::Core;
+OpenGLFramework::IOExtension::IniFile config{ TEST_CONFIG_PATH };
+
+static glm::mat4 GetUniformMat4(const Shader& shader, const char* name)
+{
+    glm::mat4 result;
+    glGetUniformfv(shader.GetID(), glGetUniformLocation(shader.GetID(), name),
+        &result[0][0]);
+    return result;
+}
+
+TEST_CASE("Uniform-Location")
+{
+    Shader shader = CreateShader(config);
+    const auto id = shader.GetID();
+
+    REQUIRE(shader.GetUniformLocation("view"_uniform) ==
+        glGetUniformLocation(id, "view"));
+    REQUIRE(shader.GetUniformLocation("environmentSH") ==
+        glGetUniformLocation(id, "environmentSH[0]"));
+    REQUIRE(shader.GetUniformLocation("environmentSH[8]"_uniform) ==
+        glGetUniformLocation(id, "environmentSH[8]"));
+    REQUIRE(shader.GetUniformLocation("nonExist"_uniform) == -1);
+}
+
+TEST_CASE("Uniform-Upload")
+{
+    Shader shader = CreateShader(config);
+    shader.Activate();
+
+    const glm::mat4 projection{ 2.0f };
+    shader.SetMat4("projection"_uniform, projection);
+    REQUIRE(GetUniformMat4(shader, "projection") == projection);
+
+    for (int i = 0; i < 9; i++)
+    {
+        auto name = "environmentSH[" + std::to_string(i) + "]";
+        shader.SetVec3(name.c_str(), glm::vec3{ static_cast<float>(i) });
+    }
+    glm::vec3 element;
+    glGetUniformfv(shader.GetID(),
+        glGetUniformLocation(shader.GetID(), "environmentSH[5]"), &element[0]);
+    REQUIRE(element == glm::vec3{ 5.0f });
+
+    SECTION("Skip redundant upload")
+    {
+        shader.SetSkipRedundantUpload(true);
+        shader.SetMat4("projection"_uniform, projection);
+        // Modify behind the cache, so a skipped upload can be observed.
+        const glm::mat4 identity{ 1.0f };
+        glUniformMatrix4fv(shader.GetUniformLocation("projection"_uniform), 1,
+            GL_FALSE, glm::value_ptr(identity));
+        shader.SetMat4("projection"_uniform, projection);
+        REQUIRE(GetUniformMat4(shader, "projection") == identity);
+
+        const glm::mat4 another{ 3.0f };
+        shader.SetMat4("projection"_uniform, another);
+        REQUIRE(GetUniformMat4(shader, "projection") == another);
+    }
+}
+
+TEST_CASE("Uniform-Benchmark")
+{
+    Shader shader = CreateShader(config);
+    shader.Activate();
+    glm::mat4 view{ 1.0f };
+
+    BENCHMARK("glGetUniformLocation every time")
+    {
+        view[3][0] += 1.0f;
+        glUniformMatrix4fv(glGetUniformLocation(shader.GetID(), "view"), 1,
+            GL_FALSE, glm::value_ptr(view));
+    };
+
+    BENCHMARK("Hash name at runtime")
+    {
+        view[3][0] += 1.0f;
+        shader.SetMat4("view", view);
+    };
+
+    BENCHMARK("Hash name at compile time")
+    {
+        view[3][0] += 1.0f;
+        shader.SetMat4("view"_uniform, view);
+    };
+
+    shader.SetSkipRedundantUpload(true);
+    BENCHMARK("Skip redundant upload")
+    {
+        shader.SetMat4("view"_uniform, view);
+    };
+    glFinish();
+}
+
+int main()
+{
+    [[maybe_unused]] ContextManager& manager = ContextManager::GetInstance();
+    MainWindow useForContextWindow{ 50, 50, "test", false };
+    auto result = Catch::Session().run();
+    return result;
+}
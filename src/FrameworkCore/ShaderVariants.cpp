@@ -0,0 +1,42 @@
+#include "ShaderVariants.h"
+
+namespace OpenGLFramework::Core
+{
+
+ShaderVariants::ShaderVariants(const std::filesystem::path& vertexShaderPath,
+    const std::filesystem::path& fragmentShaderPath,
+    ShaderPreprocessor preprocessor) :
+    stages_{ { GL_VERTEX_SHADER, vertexShaderPath },
+        { GL_FRAGMENT_SHADER, fragmentShaderPath } },
+    preprocessor_{ std::move(preprocessor) }
+{}
+
+ShaderVariants::ShaderVariants(const std::filesystem::path& vertexShaderPath,
+    const std::filesystem::path& geometryShaderPath,
+    const std::filesystem::path& fragmentShaderPath,
+    ShaderPreprocessor preprocessor) :
+    stages_{ { GL_VERTEX_SHADER, vertexShaderPath },
+        { GL_GEOMETRY_SHADER, geometryShaderPath },
+        { GL_FRAGMENT_SHADER, fragmentShaderPath } },
+    preprocessor_{ std::move(preprocessor) }
+{}
+
+Shader& ShaderVariants::Get(const ShaderDefines& defines)
+{
+    auto key = ShaderPreprocessor::GetDefinesKey(defines);
+    if (auto it = variants_.find(key); it != variants_.end()) [[likely]]
+        return it->second;
+
+    std::vector<ShaderSource> sources;
+    sources.reserve(stages_.size());
+    for (const auto& [type, path] : stages_)
+    {
+        auto content = preprocessor_.Process(path, defines);
+        if (!content.has_value()) [[unlikely]]
+            return variants_.emplace(std::move(key), Shader{ 0 }).first->second;
+        sources.push_back({ type, std::move(*content) });
+    }
+    return variants_.emplace(std::move(key), Shader{ sources }).first->second;
+}
+
+} // namespace OpenGLFramework::Core
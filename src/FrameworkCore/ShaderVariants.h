@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Shader.h"
+#include "ShaderPreprocessor.h"
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace OpenGLFramework::Core
+{
+
+// Programs specialized by defines, so that options known before drawing
+// are resolved at compile time instead of branching on uniforms. Variants
+// are compiled on first request and kept; they also go through the program
+// binary cache, whose key covers the injected defines.
+class ShaderVariants
+{
+public:
+    ShaderVariants(const std::filesystem::path& vertexShaderPath,
+        const std::filesystem::path& fragmentShaderPath,
+        ShaderPreprocessor preprocessor = {});
+    ShaderVariants(const std::filesystem::path& vertexShaderPath,
+        const std::filesystem::path& geometryShaderPath,
+        const std::filesystem::path& fragmentShaderPath,
+        ShaderPreprocessor preprocessor = {});
+
+    // A failed variant is still cached, with ID 0.
+    Shader& Get(const ShaderDefines& defines);
+    size_t GetVariantNum() const { return variants_.size(); }
+
+private:
+    std::vector<std::pair<GLenum, std::filesystem::path>> stages_;
+    ShaderPreprocessor preprocessor_;
+    std::unordered_map<std::string, Shader> variants_;
+};
+
+} // namespace OpenGLFramework::Core
@@ -0,0 +1,46 @@
+#include "ShaderVariants.h"
+#include "ContextManager.h"
+#include "MainWindow.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+
+#include <fstream>
+
+using namespace OpenGLFramework::Core;
+
+TEST_CASE("Shader-Variants")
+{
+    const std::filesystem::path root = "ShaderVariants.test";
+    std::filesystem::create_directories(root);
+    std::ofstream{ root / "common.glsl" } << "#pragma once\nuniform vec4 color;\n";
+    std::ofstream{ root / "test.vert" } << "#version 330 core\n"
+        "void main() { gl_Position = vec4(0.0); }\n";
+    std::ofstream{ root / "test.frag" } << "#version 330 core\n"
+        "#include \"common.glsl\"\nout vec4 FragColor;\n"
+        "#ifdef USE_SCALE\nuniform float scale;\n#endif\n"
+        "void main() {\n#ifdef USE_SCALE\n    FragColor = color * scale;\n"
+        "#else\n    FragColor = color;\n#endif\n}\n";
+
+    ShaderVariants variants{ root / "test.vert", root / "test.frag" };
+    Shader& plain = variants.Get({});
+    Shader& scaled = variants.Get({ { "USE_SCALE", "" } });
+    REQUIRE(variants.GetVariantNum() == 2);
+    REQUIRE(plain.GetID() != 0);
+    REQUIRE(scaled.GetID() != 0);
+    REQUIRE(plain.GetUniformLocation("scale") == -1);
+    REQUIRE(scaled.GetUniformLocation("scale") >= 0);
+    REQUIRE(scaled.GetUniformLocation("color") >= 0);
+
+    // Cached instead of compiled again.
+    REQUIRE(&variants.Get({ { "USE_SCALE", "" } }) == &scaled);
+    REQUIRE(variants.GetVariantNum() == 2);
+}
+
+int main()
+{
+    [[maybe_unused]] ContextManager& manager = ContextManager::GetInstance();
+    MainWindow useForContextWindow{ 50, 50, "test", false };
+    auto result = Catch::Session().run();
+    return result;
+}
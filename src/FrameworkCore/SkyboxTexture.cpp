@@ -1,22 +1,68 @@
 #include "SkyboxTexture.h"
+#include "GLStateCache.h"
 #include "Shader.h"
+#include "Utility/IO/IOExtension.h"
+#include "Utility/Threading/JobSystem.h"
 
 #include <stb_image.h>
 
 #include <cassert>
+#include <algorithm>
 #include <functional>
 #include <cstring>
+#include <optional>
 
 namespace OpenGLFramework::Core
 {
 
+template<int channelNum>
+static void ReverseRowImpl(unsigned char* dst, const unsigned char* src,
+    int pixelNum)
+{
+    // Moving a whole pixel with constant size lets the compiler vectorize
+    // the loop as shuffles, instead of copying channels one by one.
+    unsigned char* dstPixel = dst + static_cast<size_t>(pixelNum) * channelNum;
+    for (int i = 0; i < pixelNum; i++, src += channelNum)
+    {
+        dstPixel -= channelNum;
+        std::memcpy(dstPixel, src, channelNum);
+    }
+    return;
+}
+
+static void ReverseRow(unsigned char* dst, const unsigned char* src,
+    int pixelNum, int channelNum)
+{
+    switch (channelNum)
+    {
+    case STBI_grey:
+        std::reverse_copy(src, src + pixelNum, dst);
+        break;
+    case STBI_grey_alpha:
+        ReverseRowImpl<STBI_grey_alpha>(dst, src, pixelNum);
+        break;
+    case STBI_rgb:
+        ReverseRowImpl<STBI_rgb>(dst, src, pixelNum);
+        break;
+    case STBI_rgb_alpha:
+        ReverseRowImpl<STBI_rgb_alpha>(dst, src, pixelNum);
+        break;
+    default: [[unlikely]]
+        for (int col = 0; col < pixelNum; col++)
+            std::memcpy(dst + static_cast<size_t>(pixelNum - col - 1) * channelNum,
+                src + static_cast<size_t>(col) * channelNum, channelNum);
+        break;
+    }
+    return;
+}
+
 SkyBoxTexture::SkyBoxTexture(const std::filesystem::path& path,
     TextureSegmentType type, const TextureParamConfig& config)
 {
     GenerateAndBindSkyBox_();
-    AttachAllInOneTexture_(path, type);
+    AttachAllInOneTexture_(path, type, config);
     config.Apply();
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    GLStateCache::GetInstance().BindTexture(GL_TEXTURE_CUBE_MAP, 0);
     return;
 };
 
@@ -28,15 +74,13 @@ SkyBoxTexture::SkyBoxTexture(const std::filesystem::path& path,
     auto root = path.parent_path() / path.stem();
     auto extension = path.extension().native();
     
-    const int lastID = c_skyboxFacetNum_ - 1;
-    for (int i = 0; i < lastID; i++)
-        AttachFacetTexture_(i, 
-            std::filesystem::path{ root }.concat(append[i]).concat(extension));
-    // To reduce overhead.
-    AttachFacetTexture_(lastID, 
-        root.concat(append[lastID]).concat(std::move(extension)));
+    std::array<std::filesystem::path, c_skyboxFacetNum_> texturePaths;
+    for (int i = 0; i < c_skyboxFacetNum_; i++)
+        texturePaths[i] = 
+            std::filesystem::path{ root }.concat(append[i]).concat(extension);
+    AttachFacetTextures_(texturePaths, config);
     config.Apply();
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    GLStateCache::GetInstance().BindTexture(GL_TEXTURE_CUBE_MAP, 0);
     return;
 };
 
@@ -44,10 +88,9 @@ SkyBoxTexture::SkyBoxTexture(const std::array<std::filesystem::path,
     c_skyboxFacetNum_>& texturePaths, const TextureParamConfig& config)
 {
     GenerateAndBindSkyBox_();
-    for (int i = 0; i < c_skyboxFacetNum_; i++)
-        AttachFacetTexture_(i, texturePaths[i]);
+    AttachFacetTextures_(texturePaths, config);
     config.Apply();
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    GLStateCache::GetInstance().BindTexture(GL_TEXTURE_CUBE_MAP, 0);
     return;
 };
 
@@ -73,7 +116,7 @@ SkyBoxTexture::~SkyBoxTexture()
 CPUTextureData SkyBoxTexture::GetCPUData(int idx) const
 {
     int width = 0, height = 0;
-    glBindTexture(GL_TEXTURE_CUBE_MAP, skyboxID_);
+    GLStateCache::GetInstance().BindTexture(GL_TEXTURE_CUBE_MAP, skyboxID_);
     glGetTexLevelParameteriv(GL_TEXTURE_CUBE_MAP_POSITIVE_X, 0,
         GL_TEXTURE_WIDTH, &width);
     glGetTexLevelParameteriv(GL_TEXTURE_CUBE_MAP_POSITIVE_X, 0,
@@ -86,6 +129,7 @@ CPUTextureData SkyBoxTexture::GetCPUData(int idx) const
 
 void SkyBoxTexture::ReleaseResources_()
 {
+    GLStateCache::GetInstance().OnTextureDeleted(skyboxID_);
     glDeleteTextures(1, &skyboxID_);
     return;
 };
@@ -93,23 +137,28 @@ void SkyBoxTexture::ReleaseResources_()
 void SkyBoxTexture::GenerateAndBindSkyBox_()
 {
     glGenTextures(1, &skyboxID_);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, skyboxID_);
+    GLStateCache::GetInstance().BindTexture(GL_TEXTURE_CUBE_MAP, skyboxID_);
     return;
 }
 
 void SkyBoxTexture::AttachAllInOneTexture_(const std::filesystem::path& path,
-    TextureSegmentType type)
+    TextureSegmentType type, const TextureParamConfig& config)
 {
     CPUTextureData textureData{ path };
+    if (textureData.texturePtr == nullptr) [[unlikely]]
+        return;
     cpuChannel_ = textureData.channels;
 
     int segmentWidth = textureData.width / 4,
         segmentHeight = textureData.height / 3,
         channelNum = textureData.channels;
 
-    std::vector<unsigned char> segment(segmentWidth *
-        segmentHeight * channelNum);
-    unsigned char* segmentRawPtr = segment.data();
+    // All segments are placed in one buffer so that they can be extracted
+    // concurrently and uploaded afterwards.
+    const size_t segmentSize = static_cast<size_t>(segmentWidth) *
+        segmentHeight * channelNum;
+    std::vector<unsigned char> segments(segmentSize * c_segmentNum_);
+    unsigned char* segmentsRawPtr = segments.data();
 
     assert(type == TextureSegmentType::HorizontalLeft);
     // These two arrays are only for HorizontalLeft.
@@ -121,53 +170,85 @@ void SkyBoxTexture::AttachAllInOneTexture_(const std::filesystem::path& path,
         &HorizontalFlipSegment_,&HorizontalFlipSegment_
     };
 
+    // Every segment is a chunk of its own.
+    Threading::ParallelFor(0, c_segmentNum_, [&](size_t i) {
+        std::invoke(handles[i], segmentsRawPtr + segmentSize * i, segmentWidth,
+            segmentHeight, textureData, arr[i]);
+    }, 1);
+
     GLenum gpuChannel = GetGPUChannelFromCPUChannel(textureData.channels);
     TextureGenConfig genConfig = GetDefaultTextureGenConfig(gpuChannel);
+    genConfig.AllocateStorage(TextureType::CubeMap, config.needMIPMAP ?
+        GetMIPMAPLevels(segmentWidth, segmentHeight) : 1,
+        segmentWidth, segmentHeight);
 
     for (int i = 0; i < c_segmentNum_; i++)
     {
-        std::invoke(handles[i], segmentRawPtr, segmentWidth, segmentHeight,
-            textureData, arr[i]);
-        genConfig.Apply(static_cast<TextureType>(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i),
-            segmentWidth, segmentHeight, segmentRawPtr);
+        genConfig.ApplySubImage(
+            static_cast<TextureType>(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i),
+            segmentWidth, segmentHeight, segmentsRawPtr + segmentSize * i);
     }
 }
 
-void SkyBoxTexture::AttachFacetTexture_(int facetID, const std::filesystem::path& path)
+void SkyBoxTexture::AttachFacetTextures_(const std::array<std::filesystem::path,
+    c_skyboxFacetNum_>& paths, const TextureParamConfig& config)
 {
-    CPUTextureData textureData{ path };
-    cpuChannel_ = textureData.channels;
+    // Decoding is the most expensive part, so all facets are decoded
+    // concurrently; only uploading happens on the context thread.
+    std::array<std::optional<CPUTextureData>, c_skyboxFacetNum_> facets;
+    Threading::ParallelFor(0, c_skyboxFacetNum_, [&facets, &paths](size_t i) {
+        facets[i].emplace(paths[i]);
+    }, 1);
 
-    GLenum gpuChannel = GetGPUChannelFromCPUChannel(textureData.channels);
+    const auto& firstFacet = *facets[0];
+    for (const auto& facet : facets)
+    {
+        if (facet->texturePtr == nullptr || facet->width != firstFacet.width ||
+            facet->height != firstFacet.height ||
+            facet->channels != firstFacet.channels) [[unlikely]]
+        {
+            IOExtension::LogError("All facets of skybox should be loaded "
+                "successfully with the same size and channels.");
+            return;
+        }
+    }
+    cpuChannel_ = firstFacet.channels;
+
+    GLenum gpuChannel = GetGPUChannelFromCPUChannel(firstFacet.channels);
     auto genConfig = GetDefaultTextureGenConfig(gpuChannel);
-    genConfig.Apply(static_cast<TextureType>(GL_TEXTURE_CUBE_MAP_POSITIVE_X + facetID),
-        textureData);
+    genConfig.AllocateStorage(TextureType::CubeMap, config.needMIPMAP ?
+        GetMIPMAPLevels(firstFacet.width, firstFacet.height) : 1,
+        firstFacet.width, firstFacet.height);
+
+    for (int i = 0; i < c_skyboxFacetNum_; i++)
+    {
+        genConfig.ApplySubImage(
+            static_cast<TextureType>(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i),
+            firstFacet.width, firstFacet.height, facets[i]->texturePtr);
+    }
     return;
 }
 
 void SkyBoxTexture::HorizontalFlipSegment_(unsigned char* segmentPtr,
-    int segmentWidth, int segmentHeight, CPUTextureData& textureData,
-    std::pair<int, int>& segPos)
+    int segmentWidth, int segmentHeight, const CPUTextureData& textureData,
+    const std::pair<int, int>& segPos)
 {
     int beginRow = segmentHeight * segPos.first,
         beginCol = segmentWidth * segPos.second,
         channelNum = textureData.channels;
 
     for (int row = 0; row < segmentHeight; row++) {
-        // This can be simplified in C++23 by channel_num reverse_copy.
-        for (int col = 0; col < segmentWidth; col++) {
-            auto newIdx = ((row + 1) * segmentWidth - col - 1) * channelNum,
-                oldIdx = ((row + beginRow) * textureData.width + beginCol + col) * channelNum;
-            for (int k = 0; k < channelNum; k++)
-                segmentPtr[newIdx + k] = textureData.texturePtr[oldIdx + k];
-        }
+        ReverseRow(segmentPtr + static_cast<size_t>(row) * segmentWidth * channelNum,
+            textureData.texturePtr + channelNum *
+            (static_cast<size_t>(row + beginRow) * textureData.width + beginCol),
+            segmentWidth, channelNum);
     }
     return;
 };
 
 void SkyBoxTexture::VerticalFlipSegment_(unsigned char* segmentPtr,
-    int segmentWidth, int segmentHeight, CPUTextureData& textureData,
-    std::pair<int, int>& segPos)
+    int segmentWidth, int segmentHeight, const CPUTextureData& textureData,
+    const std::pair<int, int>& segPos)
 {
     int beginRow = segmentHeight * segPos.first,
         beginCol = segmentWidth * segPos.second,
@@ -185,9 +266,9 @@ void SkyBoxTexture::VerticalFlipSegment_(unsigned char* segmentPtr,
 void SkyBoxTexture::BindTextureOnShader(unsigned int activateID, 
     const char* name, const Shader& shader, unsigned int textureID)
 {
-    glActiveTexture(GL_TEXTURE0 + activateID);
     shader.SetInt(name, activateID);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+    GLStateCache::GetInstance().BindTexture(activateID, GL_TEXTURE_CUBE_MAP,
+        textureID);
 };
 
 }
\ No newline at end of file
@@ -53,12 +53,15 @@ private:
     int cpuChannel_;
     void GenerateAndBindSkyBox_();
     static void HorizontalFlipSegment_(unsigned char* segmentPtr, int segmentWidth,
-        int segmentHeight, CPUTextureData& data, std::pair<int, int>& segPos);
+        int segmentHeight, const CPUTextureData& data,
+        const std::pair<int, int>& segPos);
     static void VerticalFlipSegment_(unsigned char* segmentPtr, int segmentWidth,
-        int segmentHeight, CPUTextureData& data, std::pair<int, int>& segPos);
+        int segmentHeight, const CPUTextureData& data,
+        const std::pair<int, int>& segPos);
     void AttachAllInOneTexture_(const std::filesystem::path& path,
-        TextureSegmentType type);
-    void AttachFacetTexture_(int facetID, const std::filesystem::path& path);
+        TextureSegmentType type, const TextureParamConfig& config);
+    void AttachFacetTextures_(const std::array<std::filesystem::path, 
+        c_skyboxFacetNum_>& paths, const TextureParamConfig& config);
     void ReleaseResources_();
 };
 
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Shader.h"
+#include "../Utility/IO/IniFile.h"
+
+#include <array>
+
+namespace OpenGLFramework::Core
+{
+
+// Shared by tests; sources are compiled in memory, so nothing is written
+// into the working directory.
+inline Shader CreateShader(const char* vertShader, const char* fragShader)
+{
+    const std::array<ShaderSource, 2> sources{ {
+        { GL_VERTEX_SHADER, vertShader },
+        { GL_FRAGMENT_SHADER, fragShader }
+    } };
+    return Shader{ sources };
+}
+
+// Paths are given by Vert_Shader and Frag_Shader of the test config.
+inline Shader CreateShader(const IOExtension::IniFile<>& config)
+{
+    return Shader{ config.rootSection.GetEntry("Vert_Shader")->get(),
+        config.rootSection.GetEntry("Frag_Shader")->get() };
+}
+
+} // namespace OpenGLFramework::Core
@@ -1,6 +1,8 @@
 #include "Texture.h"
+#include "GLStateCache.h"
 #include "Framebuffer.h"
 #include "Shader.h"
+#include "AsyncReadback.h"
 #include "Utility/IO/IOExtension.h"
 
 #define STBI_WINDOWS_UTF8
@@ -99,14 +101,10 @@ CPUTextureData GetCPUDataFromAnyTexture(int width, int height, int cpuChannel,
 
     GLenum gpuChannel = GetGPUChannelFromCPUChannel(cpuChannel);
 
-    unsigned int tempFrameBuffer = 0;
-    glGenFramebuffers(1, &tempFrameBuffer);
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, tempFrameBuffer);
-    glBindTexture(gpuBindTextureType, bindTextureID);
-
-    glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
-        gpuSubTextureType, bindTextureID, 0);
-    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    auto& readback = AsyncReadback::GetInstance();
+    auto& stateCache = GLStateCache::GetInstance();
+    stateCache.BindTexture(gpuBindTextureType, bindTextureID);
+    readback.BindTextureAsReadFramebuffer(bindTextureID, gpuSubTextureType);
 
     int initialAlignment;
     glGetIntegerv(GL_PACK_ALIGNMENT, &initialAlignment);
@@ -115,9 +113,8 @@ CPUTextureData GetCPUDataFromAnyTexture(int width, int height, int cpuChannel,
     glReadPixels(0, 0, width, height, gpuChannel, GL_UNSIGNED_BYTE, buffer);
     glPixelStorei(GL_PACK_ALIGNMENT, initialAlignment);
 
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
-    glBindTexture(gpuBindTextureType, 0);
-    glDeleteFramebuffers(1, &tempFrameBuffer);
+    readback.UnbindReadFramebuffer();
+    stateCache.BindTexture(gpuBindTextureType, 0);
 
     return { buffer, width, height, cpuChannel };
 }
@@ -134,22 +131,22 @@ Texture::Texture(const std::filesystem::path& path,
     TextureGenConfig genConfig = GetDefaultTextureGenConfig(gpuChannel);
 
     glGenTextures(1, &ID_);
-    glBindTexture(GL_TEXTURE_2D, ID_);
+    GLStateCache::GetInstance().BindTexture(GL_TEXTURE_2D, ID_);
 
     genConfig.Apply(TextureType::Texture2D, cpuTextureData);
     paramConfig.Apply();
     
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLStateCache::GetInstance().BindTexture(GL_TEXTURE_2D, 0);
     return;
 };
 
 std::pair<int, int> Texture::GetWidthAndHeight() const
 {
     int width = 0, height = 0;
-    glBindTexture(GL_TEXTURE_2D, ID_);
+    GLStateCache::GetInstance().BindTexture(GL_TEXTURE_2D, ID_);
     glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
     glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLStateCache::GetInstance().BindTexture(GL_TEXTURE_2D, 0);
     return { width, height };
 };
 
@@ -160,12 +157,18 @@ CPUTextureData Texture::GetCPUData() const
         GL_TEXTURE_2D, ID_, GL_TEXTURE_2D);
 }
 
+ReadbackHandle Texture::GetCPUDataAsync() const
+{
+    auto [width, height] = GetWidthAndHeight();
+    return AsyncReadback::GetInstance().RequestTexture(width, height,
+        cpuChannel_, ID_, GL_TEXTURE_2D);
+}
+
 void Texture::BindTextureOnShader(unsigned int activateID, const char* name,
     const Core::Shader& shader, unsigned int textureID)
 {
-    glActiveTexture(GL_TEXTURE0 + activateID);
     shader.SetInt(name, activateID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+    GLStateCache::GetInstance().BindTexture(activateID, GL_TEXTURE_2D, textureID);
 };
 
 } // namespace OpenGLFramework::Core
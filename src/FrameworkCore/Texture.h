@@ -1,6 +1,8 @@
 #pragma once
 
 #include "ConfigHelpers/TextureConfig.h"
+#include "AsyncReadback.h"
+#include "GLStateCache.h"
 
 #include <glad/glad.h>
 
@@ -56,6 +58,7 @@ public:
         if (&another == this)
             return *this;
 
+        GLStateCache::GetInstance().OnTextureDeleted(ID_);
         glDeleteTextures(1, &ID_);
         ID_ = std::exchange(another.ID_, 0);
         cpuChannel_ = std::exchange(another.cpuChannel_, 0);
@@ -63,11 +66,13 @@ public:
         return *this;
     };
     ~Texture() {
+        GLStateCache::GetInstance().OnTextureDeleted(ID_);
         glDeleteTextures(1, &ID_);
         return;
     };
     std::pair<int, int> GetWidthAndHeight() const;
     CPUTextureData GetCPUData() const;
+    ReadbackHandle GetCPUDataAsync() const;
     static void BindTextureOnShader(unsigned int activateID, const char* name,
         const Shader& shader, unsigned int textureID);
 private:
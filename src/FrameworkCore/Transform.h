@@ -46,4 +46,15 @@ public:
     }
 };
 
+// Interpolate from transform1 to transform2, e.g. between fixed update steps.
+inline Transform Interpolate(const Transform& transform1,
+    const Transform& transform2, float factor)
+{
+    return Transform{
+        .position = glm::mix(transform1.position, transform2.position, factor),
+        .scale = glm::mix(transform1.scale, transform2.scale, factor),
+        .rotation = glm::slerp(transform1.rotation, transform2.rotation, factor)
+    };
+}
+
 } // namespace OpenGLFramework
@@ -0,0 +1,127 @@
+#include "UniformBuffer.h"
+#include "Utility/IO/IOExtension.h"
+
+namespace OpenGLFramework::Core
+{
+
+UniformBlockBinding& UniformBlockBinding::GetInstance()
+{
+    static UniformBlockBinding binding{};
+    return binding;
+}
+
+GLuint UniformBlockBinding::GetBindingPoint(std::string_view blockName)
+{
+    std::string name{ blockName };
+    if (auto it = bindingPoints_.find(name); it != bindingPoints_.end())
+        return it->second;
+
+    GLint maxBindings = 0;
+    glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &maxBindings);
+    auto bindingPoint = static_cast<GLuint>(bindingPoints_.size());
+    if (bindingPoint >= static_cast<GLuint>(maxBindings)) [[unlikely]]
+    {
+        IOExtension::LogError("Too many uniform blocks, " + name +
+            " shares the last binding point.");
+        return static_cast<GLuint>(maxBindings - 1);
+    }
+    bindingPoints_.emplace(std::move(name), bindingPoint);
+    return bindingPoint;
+}
+
+UniformBufferBase::UniformBufferBase(std::string_view blockName, size_t size) :
+    bindingPoint_{ UniformBlockBinding::GetInstance().GetBindingPoint(blockName) },
+    blockName_{ blockName }
+{
+    glGenBuffers(1, &bufferID_);
+    glBindBuffer(GL_UNIFORM_BUFFER, bufferID_);
+    glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    Bind();
+    return;
+}
+
+UniformBufferBase::UniformBufferBase(UniformBufferBase&& another) noexcept :
+    bufferID_{ another.bufferID_ }, bindingPoint_{ another.bindingPoint_ },
+    blockName_{ std::move(another.blockName_) }
+{
+    another.bufferID_ = 0;
+    return;
+}
+
+UniformBufferBase& UniformBufferBase::operator=(UniformBufferBase&& another) noexcept
+{
+    if (&another == this) [[unlikely]]
+        return *this;
+
+    ReleaseResources_();
+    bufferID_ = another.bufferID_, another.bufferID_ = 0;
+    bindingPoint_ = another.bindingPoint_;
+    blockName_ = std::move(another.blockName_);
+    return *this;
+}
+
+void UniformBufferBase::ReleaseResources_()
+{
+    glDeleteBuffers(1, &bufferID_);
+    bufferID_ = 0;
+    return;
+}
+
+void UniformBufferBase::Update_(const void* data, size_t size)
+{
+    glBindBuffer(GL_UNIFORM_BUFFER, bufferID_);
+    glBufferData(GL_UNIFORM_BUFFER, size, data, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    return;
+}
+
+bool UniformBufferBase::CheckLayout_(const Shader& shader, size_t size,
+    std::initializer_list<std::pair<const char*, size_t>> memberOffsets) const
+{
+    const GLuint program = shader.GetID();
+    GLuint blockIndex = glGetUniformBlockIndex(program, blockName_.c_str());
+    if (blockIndex == GL_INVALID_INDEX)
+    {
+        IOExtension::LogError("Uniform block " + blockName_ + 
+            " isn't active in the program.");
+        return false;
+    }
+
+    bool result = true;
+    GLint blockSize = 0;
+    glGetActiveUniformBlockiv(program, blockIndex, GL_UNIFORM_BLOCK_DATA_SIZE,
+        &blockSize);
+    if (static_cast<size_t>(blockSize) != size)
+    {
+        IOExtension::LogError("Size of uniform block " + blockName_ + " is " +
+            std::to_string(blockSize) + ", but " + std::to_string(size) +
+            " in C++.");
+        result = false;
+    }
+
+    for (const auto& [name, offset] : memberOffsets)
+    {
+        GLuint index = GL_INVALID_INDEX;
+        glGetUniformIndices(program, 1, &name, &index);
+        if (index == GL_INVALID_INDEX)
+        {
+            IOExtension::LogError(std::string{ "Member " } + name + 
+                " of uniform block " + blockName_ + " isn't active.");
+            continue;
+        }
+
+        GLint glOffset = 0;
+        glGetActiveUniformsiv(program, 1, &index, GL_UNIFORM_OFFSET, &glOffset);
+        if (static_cast<size_t>(glOffset) != offset) [[unlikely]]
+        {
+            IOExtension::LogError(std::string{ "Offset of " } + name + " is " +
+                std::to_string(glOffset) + ", but " + std::to_string(offset) +
+                " in C++.");
+            result = false;
+        }
+    }
+    return result;
+}
+
+} // namespace OpenGLFramework::Core
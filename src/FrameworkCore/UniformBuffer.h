@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Shader.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace OpenGLFramework::Core
+{
+
+// Base alignment of std140 members that have the same layout in C++.
+// mat2 / mat3 and scalar arrays have a stride of vec4 in std140, so they
+// aren't supported; use vec4 / mat4 instead.
+template<typename T>
+constexpr size_t c_std140Alignment = [] {
+    static_assert(sizeof(T) == 0, "Type doesn't have the same layout in std140.");
+    return 0;
+}();
+template<> inline constexpr size_t c_std140Alignment<float> = 4;
+template<> inline constexpr size_t c_std140Alignment<int> = 4;
+template<> inline constexpr size_t c_std140Alignment<unsigned int> = 4;
+template<> inline constexpr size_t c_std140Alignment<glm::vec2> = 8;
+template<> inline constexpr size_t c_std140Alignment<glm::ivec2> = 8;
+template<> inline constexpr size_t c_std140Alignment<glm::vec3> = 16;
+template<> inline constexpr size_t c_std140Alignment<glm::ivec3> = 16;
+template<> inline constexpr size_t c_std140Alignment<glm::vec4> = 16;
+template<> inline constexpr size_t c_std140Alignment<glm::ivec4> = 16;
+template<> inline constexpr size_t c_std140Alignment<glm::mat4> = 16;
+
+// Used as static_assert(IsStd140Member<glm::mat4>(offsetof(Block, member)));
+template<typename T>
+consteval bool IsStd140Member(size_t offset)
+{
+    return offset % c_std140Alignment<T> == 0;
+}
+
+// Blocks with the same name share a binding point in all programs, which is
+// assigned on first request; Shader binds its active blocks after linking.
+class UniformBlockBinding
+{
+public:
+    static UniformBlockBinding& GetInstance();
+    UniformBlockBinding(const UniformBlockBinding&) = delete;
+    UniformBlockBinding& operator=(const UniformBlockBinding&) = delete;
+
+    GLuint GetBindingPoint(std::string_view blockName);
+private:
+    std::unordered_map<std::string, GLuint> bindingPoints_;
+    UniformBlockBinding() = default;
+    ~UniformBlockBinding() = default;
+};
+
+class UniformBufferBase
+{
+public:
+    UniformBufferBase(const UniformBufferBase&) = delete;
+    UniformBufferBase& operator=(const UniformBufferBase&) = delete;
+    UniformBufferBase(UniformBufferBase&& another) noexcept;
+    UniformBufferBase& operator=(UniformBufferBase&& another) noexcept;
+    ~UniformBufferBase() { ReleaseResources_(); }
+
+    GLuint GetID() const { return bufferID_; }
+    GLuint GetBindingPoint() const { return bindingPoint_; }
+    const std::string& GetBlockName() const { return blockName_; }
+    // Rebind if the binding point is occupied by other buffers.
+    void Bind() const { glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint_, bufferID_); }
+
+protected:
+    UniformBufferBase(std::string_view blockName, size_t size);
+    void Update_(const void* data, size_t size);
+    bool CheckLayout_(const Shader& shader, size_t size,
+        std::initializer_list<std::pair<const char*, size_t>> memberOffsets) const;
+
+private:
+    GLuint bufferID_ = 0;
+    GLuint bindingPoint_ = 0;
+    std::string blockName_;
+    void ReleaseResources_();
+};
+
+// T should be laid out as the std140 block, which can be checked by
+// IsStd140Member at compile time and CheckLayout at runtime.
+template<typename T>
+class UniformBuffer : public UniformBufferBase
+{
+    static_assert(std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T>);
+    static_assert(sizeof(T) % 16 == 0, "std140 block size is a multiple of vec4.");
+public:
+    UniformBuffer(std::string_view blockName) :
+        UniformBufferBase{ blockName, sizeof(T) } {};
+    UniformBuffer(std::string_view blockName, const T& initData) :
+        UniformBuffer{ blockName } 
+    {
+        Update(initData);
+    }
+
+    // The whole block is respecified, so that the driver can orphan the old
+    // storage instead of waiting for draw calls that still use it.
+    void Update(const T& data) { Update_(&data, sizeof(T)); }
+
+    // Compare size of block and offsets of members(e.g. {"view", offsetof(
+    // Block, view)}) with the program; errors are logged if unmatched.
+    bool CheckLayout(const Shader& shader, 
+        std::initializer_list<std::pair<const char*, size_t>> memberOffsets = {}) const
+    {
+        return CheckLayout_(shader, sizeof(T), memberOffsets);
+    }
+};
+
+} // namespace OpenGLFramework::Core
@@ -0,0 +1,95 @@
+#include "UniformBuffer.h"
+#include "ContextManager.h"
+#include "MainWindow.h"
+#include "TestShader.test.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+
+#include <cstddef>
+
+using namespace OpenGLFramework::Core;
+
+struct TestBlock
+{
+    glm::mat4 view;
+    glm::vec3 position;
+    float scale;
+    glm::vec2 offset;
+    float padding_[2]{};
+};
+static_assert(IsStd140Member<glm::vec3>(offsetof(TestBlock, position)));
+static_assert(IsStd140Member<glm::vec2>(offsetof(TestBlock, offset)));
+
+static const char* c_vertShader = R"(#version 330 core
+layout(std140) uniform TestBlock
+{
+    mat4 view;
+    vec3 position;
+    float scale;
+    vec2 offset;
+};
+void main() { gl_Position = view * vec4(position * scale, 1.0) + vec4(offset, 0, 0); }
+)";
+
+static const char* c_fragShader = R"(#version 330 core
+out vec4 FragColor;
+layout(std140) uniform TestBlock
+{
+    mat4 view;
+    vec3 position;
+    float scale;
+    vec2 offset;
+};
+void main() { FragColor = vec4(position, scale); }
+)";
+
+TEST_CASE("Uniform-Buffer")
+{
+    Shader shader = CreateShader(c_vertShader, c_fragShader);
+    UniformBuffer<TestBlock> buffer{ "TestBlock" };
+    auto& binding = UniformBlockBinding::GetInstance();
+    REQUIRE(binding.GetBindingPoint("TestBlock") == buffer.GetBindingPoint());
+    REQUIRE(binding.GetBindingPoint("AnotherBlock") != buffer.GetBindingPoint());
+
+    SECTION("Bound after linking")
+    {
+        GLint bindingPoint = -1;
+        glGetActiveUniformBlockiv(shader.GetID(), 
+            glGetUniformBlockIndex(shader.GetID(), "TestBlock"),
+            GL_UNIFORM_BLOCK_BINDING, &bindingPoint);
+        REQUIRE(static_cast<GLuint>(bindingPoint) == buffer.GetBindingPoint());
+    }
+
+    SECTION("Layout")
+    {
+        REQUIRE(buffer.CheckLayout(shader, {
+            { "position", offsetof(TestBlock, position) },
+            { "scale", offsetof(TestBlock, scale) },
+            { "offset", offsetof(TestBlock, offset) }
+        }));
+    }
+
+    SECTION("Update")
+    {
+        const TestBlock data{ .view = glm::mat4{ 2.0f }, 
+            .position = { 1, 2, 3 }, .scale = 4, .offset = { 5, 6 } };
+        buffer.Update(data);
+
+        TestBlock result{};
+        glBindBuffer(GL_UNIFORM_BUFFER, buffer.GetID());
+        glGetBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(TestBlock), &result);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        REQUIRE(result.view == data.view);
+        REQUIRE(result.position == data.position);
+        REQUIRE(result.offset == data.offset);
+    }
+}
+
+int main()
+{
+    [[maybe_unused]] ContextManager& manager = ContextManager::GetInstance();
+    MainWindow useForContextWindow{ 50, 50, "test", false };
+    auto result = Catch::Session().run();
+    return result;
+}
@@ -0,0 +1,143 @@
+#include "UploadWorker.h"
+#include "Utility/IO/IOExtension.h"
+
+#include <GLFW/glfw3.h>
+
+#include <vector>
+
+namespace OpenGLFramework::Core
+{
+
+static thread_local bool s_isUploadWorkerThread = false;
+
+UploadWorker::UploadWorker()
+{
+    GLFWwindow* sharedWindow = glfwGetCurrentContext();
+    if (sharedWindow == nullptr) [[unlikely]]
+    {
+        IOExtension::LogError("Upload worker needs a current context to share.");
+        return;
+    }
+
+    // Window hints are global, so the visibility is restored for others.
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    window_ = glfwCreateWindow(1, 1, "Upload worker", nullptr, sharedWindow);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+    if (window_ == nullptr) [[unlikely]]
+    {
+        IOExtension::LogError("Fail to create shared context for upload worker.");
+        return;
+    }
+    thread_ = std::jthread{ [this](std::stop_token token) { Run_(token); } };
+    return;
+}
+
+UploadWorker::~UploadWorker()
+{
+    {
+        std::scoped_lock lock{ mutex_ };
+        jobs_.clear();
+    }
+    if (thread_.joinable())
+    {
+        thread_.request_stop();
+        thread_.join();
+    }
+    // Results of dropped uploads are released here on the main context.
+    for (auto& uploaded : uploaded_)
+        glDeleteSync(uploaded.fence);
+    uploaded_.clear();
+    if (window_ != nullptr)
+        glfwDestroyWindow(window_);
+    return;
+}
+
+void UploadWorker::Submit(UploadFunc upload, ReadyFunc onReady)
+{
+    if (window_ == nullptr) [[unlikely]]
+    {
+        // Fall back to upload on the current context.
+        upload();
+        if (onReady)
+            onReady();
+        return;
+    }
+
+    {
+        std::scoped_lock lock{ mutex_ };
+        jobs_.push_back({ std::move(upload), std::move(onReady) });
+    }
+    jobAvailable_.notify_one();
+    return;
+}
+
+size_t UploadWorker::Poll()
+{
+    std::vector<ReadyFunc> readyFuncs;
+    {
+        std::scoped_lock lock{ mutex_ };
+        while (!uploaded_.empty())
+        {
+            auto& uploaded = uploaded_.front();
+            const GLenum result = glClientWaitSync(uploaded.fence, 0, 0);
+            if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+                break;
+            glDeleteSync(uploaded.fence);
+            readyFuncs.push_back(std::move(uploaded.onReady));
+            uploaded_.pop_front();
+        }
+    }
+
+    // Called without the lock, since they may submit new uploads.
+    for (auto& onReady : readyFuncs)
+    {
+        if (onReady)
+            onReady();
+    }
+    return readyFuncs.size();
+}
+
+size_t UploadWorker::GetPendingNum() const
+{
+    std::scoped_lock lock{ mutex_ };
+    return jobs_.size() + runningNum_ + uploaded_.size();
+}
+
+bool UploadWorker::IsWorkerThread()
+{
+    return s_isUploadWorkerThread;
+}
+
+void UploadWorker::Run_(std::stop_token token)
+{
+    s_isUploadWorkerThread = true;
+    glfwMakeContextCurrent(window_);
+    while (true)
+    {
+        Job_ job;
+        {
+            std::unique_lock lock{ mutex_ };
+            if (!jobAvailable_.wait(lock, token, [this]() { return !jobs_.empty(); }))
+                break;
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+            runningNum_++;
+        }
+
+        job.upload();
+        job.upload = nullptr;
+        // Flushed so that the fence can be signaled without this context
+        // doing anything else. Objects should be bound again on the main
+        // context after the fence to see the new contents, which drawing does.
+        GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+
+        std::scoped_lock lock{ mutex_ };
+        runningNum_--;
+        uploaded_.push_back({ fence, std::move(job.onReady) });
+    }
+    glfwMakeContextCurrent(nullptr);
+    return;
+}
+
+} // namespace OpenGLFramework::Core
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+
+struct GLFWwindow;
+
+namespace OpenGLFramework::Core
+{
+
+// Thread with a hidden window whose context shares objects with the main
+// one, so that buffers and textures are created and filled without stalling
+// rendering. Every upload is followed by a fence, and the main thread hands
+// the result over only after the fence is signaled(see Poll). VAOs,
+// framebuffers and other container objects aren't shared, which should be
+// created on the main thread when the upload is ready.
+// Owned by ContextManager(see ContextManager::GetUploadWorker).
+class UploadWorker
+{
+public:
+    using UploadFunc = std::function<void(void)>;
+    using ReadyFunc = std::function<void(void)>;
+
+    // Should be called on the main thread with the context to share current.
+    UploadWorker();
+    UploadWorker(const UploadWorker&) = delete;
+    UploadWorker& operator=(const UploadWorker&) = delete;
+    // Uploads not finished are dropped.
+    ~UploadWorker();
+
+    // upload runs on the worker, and onReady runs on the main thread in Poll
+    // after the GPU finishes the upload; results are handed over in order.
+    void Submit(UploadFunc upload, ReadyFunc onReady = nullptr);
+
+    // create() runs on the worker and its result is given to onReady on the
+    // main thread, e.g. [path]() { return Texture{ path }; }.
+    template<typename CreateFunc, typename OnReadyFunc>
+    void Upload(CreateFunc create, OnReadyFunc onReady)
+    {
+        using ResultType = std::invoke_result_t<CreateFunc&>;
+        auto result = std::make_shared<std::optional<ResultType>>();
+        Submit([result, create = std::move(create)]() mutable {
+            result->emplace(create());
+        }, [result, onReady = std::move(onReady)]() mutable {
+            onReady(std::move(**result));
+            result->reset();
+        });
+        return;
+    }
+
+    // Called on the main thread every frame(see MainWindow::MainLoop);
+    // return the number of uploads handed over.
+    size_t Poll();
+    // Number of uploads submitted but not handed over yet.
+    size_t GetPendingNum() const;
+
+    static bool IsWorkerThread();
+
+private:
+    struct Job_
+    {
+        UploadFunc upload;
+        ReadyFunc onReady;
+    };
+    struct Uploaded_
+    {
+        GLsync fence;
+        ReadyFunc onReady;
+    };
+
+    GLFWwindow* window_ = nullptr;
+    mutable std::mutex mutex_;
+    std::condition_variable_any jobAvailable_;
+    std::deque<Job_> jobs_;
+    std::deque<Uploaded_> uploaded_;
+    size_t runningNum_ = 0;
+    std::jthread thread_;
+
+    void Run_(std::stop_token token);
+};
+
+} // namespace OpenGLFramework::Core
@@ -0,0 +1,103 @@
+#include "UploadWorker.h"
+#include "ContextManager.h"
+#include "MainWindow.h"
+#include "Model.h"
+#include "Texture.h"
+#include "../Utility/IO/IniFile.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_session.hpp>
+
+#include <array>
+#include <chrono>
+#include <thread>
+
+using namespace OpenGLFramework::Core;
+OpenGLFramework::IOExtension::IniFile config{ TEST_CONFIG_PATH };
+
+// Poll as the main loop does until all uploads are handed over.
+static bool WaitForUploads(UploadWorker& worker)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 10 };
+    while (worker.GetPendingNum() != 0)
+    {
+        if (std::chrono::steady_clock::now() > deadline)
+            return false;
+        worker.Poll();
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+    }
+    return true;
+}
+
+TEST_CASE("Upload-Buffer")
+{
+    auto& worker = ContextManager::GetInstance().GetUploadWorker();
+    const std::array<int, 4> data{ 1, 2, 3, 4 };
+    GLuint buffer = 0;
+    bool uploadedOnWorker = false, readyOnMain = false;
+
+    worker.Submit([&]() {
+        uploadedOnWorker = UploadWorker::IsWorkerThread();
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, sizeof(data), data.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }, [&]() { readyOnMain = !UploadWorker::IsWorkerThread(); });
+    REQUIRE(WaitForUploads(worker));
+    REQUIRE(uploadedOnWorker);
+    REQUIRE(readyOnMain);
+
+    std::array<int, 4> result{};
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(result), result.data());
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glDeleteBuffers(1, &buffer);
+    REQUIRE(result == data);
+    REQUIRE(glGetError() == GL_NO_ERROR);
+}
+
+TEST_CASE("Upload-Texture")
+{
+    auto& path = config.rootSection.GetEntry("texture_path")->get();
+    std::filesystem::path unicodePath{
+        reinterpret_cast<const char8_t*>(path.c_str())
+    };
+    REQUIRE(std::filesystem::exists(unicodePath));
+
+    auto& worker = ContextManager::GetInstance().GetUploadWorker();
+    std::optional<Texture> texture;
+    worker.Upload([unicodePath]() { return Texture{ unicodePath }; },
+        [&texture](Texture uploaded) { texture.emplace(std::move(uploaded)); });
+    REQUIRE(WaitForUploads(worker));
+    REQUIRE(texture.has_value());
+
+    CPUTextureData cpuTex{ unicodePath };
+    auto [width, height] = texture->GetWidthAndHeight();
+    REQUIRE(width == cpuTex.width);
+    REQUIRE(height == cpuTex.height);
+    REQUIRE(glGetError() == GL_NO_ERROR);
+}
+
+TEST_CASE("Load-Model-Async")
+{
+    auto path = config.rootSection.GetEntry("Cube_Model");
+    REQUIRE((path.has_value() && std::filesystem::exists(path->get())));
+
+    std::optional<BasicTriRenderModel> model;
+    BasicTriRenderModel::LoadAsync(path->get(), [&model](BasicTriRenderModel loaded) {
+        model.emplace(std::move(loaded));
+    });
+    REQUIRE(WaitForUploads(ContextManager::GetInstance().GetUploadWorker()));
+    REQUIRE(model.has_value());
+    REQUIRE(model->meshes.size() == 1);
+    REQUIRE(model->meshes[0].triangles.size() == 12);
+    REQUIRE(glGetError() == GL_NO_ERROR);
+}
+
+int main()
+{
+    [[maybe_unused]] ContextManager& manager = ContextManager::GetInstance();
+    MainWindow useForContextWindow{ 50, 50, "test", false };
+    auto result = Catch::Session().run();
+    return result;
+}
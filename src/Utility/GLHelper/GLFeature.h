@@ -0,0 +1,71 @@
+#pragma once
+#include <glad/glad.h>
+
+#include <functional>
+#include <set>
+#include <string>
+#include <string_view>
+
+namespace OpenGLFramework::GLHelper
+{
+
+// NOTICE: results are cached in function-local statics, which is valid since
+// we only have one GL context(see MainWindow::singletonFlag_). They should be
+// called only after the context is created.
+inline bool HasExtension(std::string_view name)
+{
+    static const std::set<std::string, std::less<>> extensions = [] {
+        std::set<std::string, std::less<>> result;
+        int extensionNum = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensionNum);
+        for (int i = 0; i < extensionNum; i++)
+        {
+            auto extension = reinterpret_cast<const char*>(
+                glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+            if (extension != nullptr)
+                result.emplace(extension);
+        }
+        return result;
+    }();
+    return extensions.contains(name);
+}
+
+// glTexStorage2D, core since 4.2.
+inline bool SupportTextureStorage()
+{
+    static const bool support = GLAD_GL_VERSION_4_2 ||
+        HasExtension("GL_ARB_texture_storage");
+    return support;
+}
+
+// glInvalidateFramebuffer, core since 4.3.
+inline bool SupportInvalidateFramebuffer()
+{
+    static const bool support = GLAD_GL_VERSION_4_3 ||
+        HasExtension("GL_ARB_invalidate_subdata");
+    return support;
+}
+
+// glGetProgramBinary, core since 4.1; drivers may still support no format.
+inline bool SupportProgramBinary()
+{
+    static const bool support = [] {
+        if (!GLAD_GL_VERSION_4_1 && !HasExtension("GL_ARB_get_program_binary"))
+            return false;
+        int formatNum = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatNum);
+        return formatNum > 0;
+    }();
+    return support;
+}
+
+// Compile and link in driver threads, with GL_COMPLETION_STATUS_KHR to query
+// without blocking. Not core in any version.
+inline bool SupportParallelShaderCompile()
+{
+    static const bool support = HasExtension("GL_KHR_parallel_shader_compile") ||
+        HasExtension("GL_ARB_parallel_shader_compile");
+    return support;
+}
+
+} // namespace OpenGLFramework::GLHelper
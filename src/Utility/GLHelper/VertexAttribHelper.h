@@ -30,7 +30,8 @@ void CopyVertexAttributes(T&, const aiMesh*);
 class IVertexAttribContainer {
 private:
     std::any container_ = {};
-    void(*allocAndBind_)(std::any&, size_t, size_t) = nullptr;
+    void(*allocate_)(std::any&, size_t, size_t) = nullptr;
+    void(*bind_)(size_t, size_t) = nullptr;
     void(*copyFromMesh_)(std::any&, const aiMesh*) = nullptr;
 
 public:
@@ -42,15 +43,16 @@ public:
         container_{ std::move(obj) }
     {
         using VertexAttrib = typename Container::value_type;
-        allocAndBind_ = [](std::any& obj, size_t posSize, size_t vertexNum) {
+        allocate_ = [](std::any& obj, size_t posSize, size_t vertexNum) {
             size_t verticesPosSize = vertexNum * posSize;
             glBufferData(GL_ARRAY_BUFFER, verticesPosSize +
                 vertexNum * sizeof(VertexAttrib), nullptr, GL_STATIC_DRAW);
             auto& container = std::any_cast<Container&>(obj);
             glBufferSubData(GL_ARRAY_BUFFER, verticesPosSize,
                 vertexNum * sizeof(VertexAttrib), std::ranges::data(container));
-
-            VertexAttribHelper<VertexAttrib>::Bind(verticesPosSize);
+        };
+        bind_ = [](size_t posSize, size_t vertexNum) {
+            VertexAttribHelper<VertexAttrib>::Bind(vertexNum * posSize);
         };
         copyFromMesh_ = [](std::any& obj, const aiMesh* mesh) {
             CopyVertexAttributes(std::any_cast<Container&>(obj), mesh);
@@ -59,8 +61,17 @@ public:
 
     void AllocateAndBind(size_t singleSize, size_t vertexNum)
     {
-        allocAndBind_(container_, singleSize, vertexNum);
+        Allocate(singleSize, vertexNum);
+        Bind(singleSize, vertexNum);
+    }
+
+    // Buffers can be filled on another context, while attribute pointers are
+    // states of the VAO, which isn't shared between contexts.
+    void Allocate(size_t singleSize, size_t vertexNum)
+    {
+        allocate_(container_, singleSize, vertexNum);
     }
+    void Bind(size_t singleSize, size_t vertexNum) { bind_(singleSize, vertexNum); }
 
     void CopyFromMesh(const aiMesh* mesh){ copyFromMesh_(container_, mesh); }
 };
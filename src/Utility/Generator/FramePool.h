@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace OpenGLFramework::Coroutine {
+
+// Free lists of coroutine frames by size class, so that short-lived tasks
+// started every frame don't go to the global allocator each time. Lists are
+// per thread without locks; frames freed on another thread, e.g. after
+// co_await ThreadPool(), just go to the list of that thread.
+class FramePool
+{
+public:
+    static void* Allocate(std::size_t size)
+    {
+        const std::size_t classIndex = GetClassIndex_(size);
+        if (classIndex >= c_classNum_) [[unlikely]]
+            return ::operator new(size);
+
+        auto& list = GetLists_()[classIndex];
+        if (list.head != nullptr) [[likely]]
+        {
+            Node_* node = list.head;
+            list.head = node->next;
+            list.cachedNum--;
+            return node;
+        }
+        // All frames in a class have the same size so that any can be reused.
+        return ::operator new((classIndex + 1) * c_granularity_);
+    }
+
+    static void Deallocate(void* ptr, std::size_t size) noexcept
+    {
+        const std::size_t classIndex = GetClassIndex_(size);
+        if (classIndex >= c_classNum_) [[unlikely]]
+        {
+            ::operator delete(ptr);
+            return;
+        }
+
+        auto& list = GetLists_()[classIndex];
+        if (list.cachedNum >= c_maxCachedNum_)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+        list.head = ::new (ptr) Node_{ list.head };
+        list.cachedNum++;
+        return;
+    }
+
+    // Number of frames cached by the current thread.
+    static std::size_t GetCachedNum()
+    {
+        std::size_t num = 0;
+        for (const auto& list : GetLists_())
+            num += list.cachedNum;
+        return num;
+    }
+
+private:
+    static constexpr std::size_t c_granularity_ = 64;
+    static constexpr std::size_t c_classNum_ = 16;
+    static constexpr std::size_t c_maxCachedNum_ = 64;
+
+    struct Node_
+    {
+        Node_* next;
+    };
+    struct FreeList_
+    {
+        Node_* head = nullptr;
+        std::size_t cachedNum = 0;
+
+        FreeList_() = default;
+        FreeList_(const FreeList_&) = delete;
+        FreeList_& operator=(const FreeList_&) = delete;
+        ~FreeList_()
+        {
+            while (head != nullptr)
+                ::operator delete(std::exchange(head, head->next));
+        }
+    };
+
+    static std::size_t GetClassIndex_(std::size_t size)
+    {
+        return (size + c_granularity_ - 1) / c_granularity_ - 1;
+    }
+
+    static std::array<FreeList_, c_classNum_>& GetLists_()
+    {
+        thread_local std::array<FreeList_, c_classNum_> lists;
+        return lists;
+    }
+};
+
+// Base of promises whose coroutine frames are allocated from FramePool.
+struct PooledFrame
+{
+    static void* operator new(std::size_t size)
+    {
+        return FramePool::Allocate(size);
+    }
+    static void operator delete(void* ptr, std::size_t size) noexcept
+    {
+        FramePool::Deallocate(ptr, size);
+    }
+};
+
+} // namespace OpenGLFramework::Coroutine
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "FramePool.h"
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace OpenGLFramework::Coroutine {
+
+namespace Details {
+
+struct TaskPromiseBase : PooledFrame
+{
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept { return false; }
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(
+            std::coroutine_handle<Promise> coroutine) noexcept
+        {
+            auto& promise = coroutine.promise();
+            if (promise.continuation)
+                return promise.continuation;
+            if (promise.detached)
+                coroutine.destroy();
+            return std::noop_coroutine();
+        }
+        void await_resume() const noexcept {}
+    };
+
+    static std::suspend_always initial_suspend() noexcept { return {}; }
+    static FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+    std::coroutine_handle<> continuation;
+    // Outermost coroutine of the awaiting chain, which owns all the others.
+    std::coroutine_handle<> root;
+    bool detached = false;
+    std::exception_ptr exception;
+};
+
+template<typename T>
+struct TaskPromise : TaskPromiseBase
+{
+    template<typename U = T>
+    void return_value(U&& value) { result.emplace(std::forward<U>(value)); }
+    T GetResult()
+    {
+        if (exception)
+            std::rethrow_exception(exception);
+        return std::move(*result);
+    }
+
+    std::optional<T> result;
+};
+
+template<>
+struct TaskPromise<void> : TaskPromiseBase
+{
+    void return_void() noexcept {}
+    void GetResult()
+    {
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+};
+
+} // namespace Details
+
+// Get the coroutine whose destruction destroys the whole chain that
+// coroutine belongs to; awaitables suspending tasks outside use it to
+// cancel them(e.g. Core::FrameScheduler::ReleaseResources).
+template<typename Promise>
+std::coroutine_handle<> GetRootCoroutine(std::coroutine_handle<Promise> coroutine)
+{
+    if constexpr (std::is_base_of_v<Details::TaskPromiseBase, Promise>)
+    {
+        if (coroutine.promise().root)
+            return coroutine.promise().root;
+    }
+    return coroutine;
+}
+
+// Lazy coroutine that starts when it's awaited or detached. Unlike
+// Generator, it may co_await, so work spanning several frames or threads
+// can be written sequentially. Exceptions are rethrown to the awaiter.
+template<typename T = void>
+class [[nodiscard]] Task
+{
+public:
+    struct promise_type : Details::TaskPromise<T>
+    {
+        Task<T> get_return_object()
+        {
+            return Task{ Handle::from_promise(*this) };
+        }
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    class Awaiter
+    {
+    public:
+        explicit Awaiter(const Handle coroutine) : coroutine_{ coroutine } {}
+
+        bool await_ready() const noexcept
+        {
+            return !coroutine_ || coroutine_.done();
+        }
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(
+            std::coroutine_handle<Promise> awaiting) noexcept
+        {
+            auto& promise = coroutine_.promise();
+            promise.continuation = awaiting;
+            promise.root = GetRootCoroutine(awaiting);
+            return coroutine_;
+        }
+        T await_resume() { return coroutine_.promise().GetResult(); }
+
+    private:
+        Handle coroutine_;
+    };
+
+    explicit Task(const Handle coroutine) : coroutine_{ coroutine } {}
+
+    Task() = default;
+    ~Task()
+    {
+        if (coroutine_)
+            coroutine_.destroy();
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    Task(Task&& other) noexcept : coroutine_{ std::exchange(other.coroutine_, {}) } {}
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (coroutine_)
+                coroutine_.destroy();
+            coroutine_ = std::exchange(other.coroutine_, {});
+        }
+        return *this;
+    }
+
+    Awaiter operator co_await() const noexcept { return Awaiter{ coroutine_ }; }
+
+    bool IsValid() const { return static_cast<bool>(coroutine_); }
+    bool IsDone() const { return !coroutine_ || coroutine_.done(); }
+
+    // Start the task, which then owns itself and is destroyed when finished.
+    // NOTICE: exceptions of detached tasks are dropped, so catch them inside.
+    void Detach()
+    {
+        if (!coroutine_) [[unlikely]]
+            return;
+        auto coroutine = std::exchange(coroutine_, {});
+        coroutine.promise().detached = true;
+        coroutine.resume();
+        return;
+    }
+
+private:
+    Handle coroutine_;
+};
+
+} // namespace OpenGLFramework::Coroutine
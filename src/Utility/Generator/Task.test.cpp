@@ -0,0 +1,159 @@
+#include "Task.h"
+#include <catch2/catch_test_macros.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace OpenGLFramework::Coroutine;
+
+// Suspend until Resume is called, like waiting for the next frame.
+struct ManualEvent
+{
+    struct Awaiter
+    {
+        ManualEvent& event;
+        bool await_ready() const noexcept { return false; }
+        template<typename Promise>
+        void await_suspend(std::coroutine_handle<Promise> coroutine)
+        {
+            event.waiting.push_back(coroutine);
+            event.roots.push_back(GetRootCoroutine(coroutine));
+        }
+        void await_resume() const noexcept {}
+    };
+
+    std::vector<std::coroutine_handle<>> waiting;
+    std::vector<std::coroutine_handle<>> roots;
+
+    Awaiter Wait() { return Awaiter{ *this }; }
+
+    void Resume()
+    {
+        auto coroutines = std::move(waiting);
+        waiting.clear();
+        roots.clear();
+        for (auto coroutine : coroutines)
+            coroutine.resume();
+    }
+};
+
+Task<int> Add(int a, int b)
+{
+    co_return a + b;
+}
+
+Task<std::string> Describe(ManualEvent& event)
+{
+    const int sum = co_await Add(1, 2);
+    co_await event.Wait();
+    co_return "sum = " + std::to_string(sum + co_await Add(3, 4));
+}
+
+Task<> Collect(ManualEvent& event, std::vector<std::string>& results)
+{
+    results.push_back(co_await Describe(event));
+    co_await event.Wait();
+    results.push_back("done");
+}
+
+TEST_CASE("Task-Nested")
+{
+    ManualEvent event;
+    std::vector<std::string> results;
+
+    auto task = Collect(event, results);
+    REQUIRE(!task.IsDone());
+    task.Detach();
+    REQUIRE(!task.IsValid());
+    REQUIRE(event.waiting.size() == 1);
+    REQUIRE(results.empty());
+
+    event.Resume();
+    REQUIRE(results == std::vector<std::string>{ "sum = 10" });
+    REQUIRE(event.waiting.size() == 1);
+
+    event.Resume();
+    REQUIRE(results == std::vector<std::string>{ "sum = 10", "done" });
+    REQUIRE(event.waiting.empty());
+}
+
+Task<int> Throw()
+{
+    throw std::runtime_error{ "error in task" };
+    co_return 0;
+}
+
+Task<> CatchThrown(bool& caught)
+{
+    try
+    {
+        co_await Throw();
+    }
+    catch (const std::runtime_error&)
+    {
+        caught = true;
+    }
+}
+
+TEST_CASE("Task-Exception")
+{
+    bool caught = false;
+    CatchThrown(caught).Detach();
+    REQUIRE(caught);
+}
+
+struct DestructionFlag
+{
+    bool& destroyed;
+    ~DestructionFlag() { destroyed = true; }
+};
+
+Task<> WaitInner(ManualEvent& event, bool& destroyed)
+{
+    DestructionFlag flag{ destroyed };
+    co_await event.Wait();
+}
+
+Task<> WaitOuter(ManualEvent& event, bool& innerDestroyed, bool& outerDestroyed)
+{
+    DestructionFlag flag{ outerDestroyed };
+    co_await WaitInner(event, innerDestroyed);
+}
+
+TEST_CASE("Task-Cancel-By-Root")
+{
+    ManualEvent event;
+    bool innerDestroyed = false, outerDestroyed = false;
+    WaitOuter(event, innerDestroyed, outerDestroyed).Detach();
+    REQUIRE(event.roots.size() == 1);
+    REQUIRE(event.roots[0] != event.waiting[0]);
+
+    // Destroying the root destroys the awaited tasks as well.
+    event.roots[0].destroy();
+    REQUIRE(innerDestroyed);
+    REQUIRE(outerDestroyed);
+}
+
+TEST_CASE("Task-Frame-Pool")
+{
+    ManualEvent event;
+    std::vector<std::string> results;
+    // Warm up so that frames of these coroutines are cached.
+    Collect(event, results).Detach();
+    event.Resume();
+    event.Resume();
+    const auto cachedNum = FramePool::GetCachedNum();
+    REQUIRE(cachedNum > 0);
+
+    void* frame = FramePool::Allocate(100);
+    FramePool::Deallocate(frame, 100);
+    REQUIRE(FramePool::Allocate(120) == frame);
+    FramePool::Deallocate(frame, 120);
+
+    Collect(event, results).Detach();
+    REQUIRE(FramePool::GetCachedNum() < cachedNum);
+    event.Resume();
+    event.Resume();
+    REQUIRE(FramePool::GetCachedNum() == cachedNum);
+}
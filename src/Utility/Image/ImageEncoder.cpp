@@ -0,0 +1,136 @@
+#include "ImageEncoder.h"
+#include "../IO/IOExtension.h"
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+
+namespace OpenGLFramework::ImageExtension
+{
+
+struct QOIPixel
+{
+    unsigned char r = 0, g = 0, b = 0, a = 255;
+    bool operator==(const QOIPixel&) const = default;
+    int GetHash() const { return (r * 3 + g * 5 + b * 7 + a * 11) % 64; }
+};
+
+static void PushBigEndian32(std::vector<unsigned char>& output, std::uint32_t value)
+{
+    output.push_back(static_cast<unsigned char>(value >> 24));
+    output.push_back(static_cast<unsigned char>(value >> 16));
+    output.push_back(static_cast<unsigned char>(value >> 8));
+    output.push_back(static_cast<unsigned char>(value));
+    return;
+}
+
+std::vector<unsigned char> EncodeQOI(const ImageView& image)
+{
+    constexpr unsigned char c_opIndex = 0x00, c_opDiff = 0x40, c_opLuma = 0x80,
+        c_opRun = 0xc0, c_opRGB = 0xfe, c_opRGBA = 0xff;
+    constexpr int c_maxRun = 62;
+
+    if (image.channelNum != 3 && image.channelNum != 4) [[unlikely]]
+    {
+        IOExtension::LogError("QOI only supports RGB and RGBA images.");
+        return {};
+    }
+
+    std::vector<unsigned char> output;
+    // Worst case is every pixel with a full tag, plus header and end marker.
+    output.reserve(14 + static_cast<size_t>(image.width) * image.height *
+        (image.channelNum + 1) + 8);
+    output.insert(output.end(), { 'q', 'o', 'i', 'f' });
+    PushBigEndian32(output, image.width);
+    PushBigEndian32(output, image.height);
+    output.push_back(static_cast<unsigned char>(image.channelNum));
+    output.push_back(0); // sRGB with linear alpha.
+
+    // The index starts as all zeros, unlike the previous pixel.
+    std::array<QOIPixel, 64> index;
+    index.fill(QOIPixel{ 0, 0, 0, 0 });
+    QOIPixel prev{}, curr{};
+    int run = 0;
+    for (int row = 0; row < image.height; row++)
+    {
+        const unsigned char* src = image.GetRow(row);
+        for (int col = 0; col < image.width; col++, src += image.channelNum)
+        {
+            curr.r = src[0], curr.g = src[1], curr.b = src[2];
+            if (image.channelNum == 4)
+                curr.a = src[3];
+
+            if (curr == prev)
+            {
+                if (++run == c_maxRun)
+                {
+                    output.push_back(c_opRun | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+
+            if (run > 0)
+            {
+                output.push_back(c_opRun | (run - 1));
+                run = 0;
+            }
+
+            const int hash = curr.GetHash();
+            if (index[hash] == curr)
+            {
+                output.push_back(c_opIndex | hash);
+                prev = curr;
+                continue;
+            }
+            index[hash] = curr;
+
+            if (curr.a != prev.a)
+            {
+                output.insert(output.end(), { c_opRGBA, curr.r, curr.g, curr.b, curr.a });
+                prev = curr;
+                continue;
+            }
+
+            const int dr = static_cast<signed char>(curr.r - prev.r),
+                dg = static_cast<signed char>(curr.g - prev.g),
+                db = static_cast<signed char>(curr.b - prev.b);
+            const int drdg = dr - dg, dbdg = db - dg;
+
+            if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1)
+            {
+                output.push_back(static_cast<unsigned char>(
+                    c_opDiff | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+            }
+            else if (drdg >= -8 && drdg <= 7 && dg >= -32 && dg <= 31 &&
+                dbdg >= -8 && dbdg <= 7)
+            {
+                output.push_back(static_cast<unsigned char>(c_opLuma | (dg + 32)));
+                output.push_back(static_cast<unsigned char>((drdg + 8) << 4 | (dbdg + 8)));
+            }
+            else
+                output.insert(output.end(), { c_opRGB, curr.r, curr.g, curr.b });
+            prev = curr;
+        }
+    }
+
+    if (run > 0)
+        output.push_back(c_opRun | (run - 1));
+    output.insert(output.end(), { 0, 0, 0, 0, 0, 0, 0, 1 });
+    return output;
+}
+
+bool WriteFile(const std::filesystem::path& path,
+    const std::vector<unsigned char>& content)
+{
+    std::ofstream fout{ path, std::ios::binary };
+    fout.write(reinterpret_cast<const char*>(content.data()), content.size());
+    if (!fout) [[unlikely]]
+    {
+        IOExtension::LogError("Fail to write image at path " + path.string());
+        return false;
+    }
+    return true;
+}
+
+} // namespace OpenGLFramework::ImageExtension
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+namespace OpenGLFramework::ImageExtension
+{
+
+// Pixels are tightly packed 8-bit channels, with the first row on the top
+// unless flipVertically is set(e.g. pixels read by glReadPixels).
+struct ImageView
+{
+    const unsigned char* pixels;
+    int width;
+    int height;
+    int channelNum;
+    bool flipVertically = false;
+
+    const unsigned char* GetRow(int row) const {
+        const int actualRow = flipVertically ? height - 1 - row : row;
+        return pixels + static_cast<size_t>(actualRow) * width * channelNum;
+    }
+};
+
+// https://qoiformat.org/qoi-specification.pdf, only 3 or 4 channels are
+// supported; empty result is returned otherwise.
+std::vector<unsigned char> EncodeQOI(const ImageView& image);
+
+bool WriteFile(const std::filesystem::path& path,
+    const std::vector<unsigned char>& content);
+
+} // namespace OpenGLFramework::ImageExtension
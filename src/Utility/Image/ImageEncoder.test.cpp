@@ -0,0 +1,125 @@
+#include "ImageEncoder.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <random>
+
+using namespace OpenGLFramework::ImageExtension;
+
+// Minimal decoder following the specification, only for verification.
+static std::vector<unsigned char> DecodeQOI(const std::vector<unsigned char>& data,
+    int& width, int& height, int& channelNum)
+{
+    auto readBigEndian32 = [&data](size_t pos) {
+        return static_cast<int>(data[pos] << 24 | data[pos + 1] << 16 |
+            data[pos + 2] << 8 | data[pos + 3]);
+    };
+    width = readBigEndian32(4), height = readBigEndian32(8);
+    channelNum = data[12];
+
+    std::vector<unsigned char> pixels;
+    std::array<std::array<unsigned char, 4>, 64> index{};
+    std::array<unsigned char, 4> pixel{ 0, 0, 0, 255 };
+    size_t pos = 14, pixelNum = static_cast<size_t>(width) * height;
+    int run = 0;
+    for (size_t i = 0; i < pixelNum; i++)
+    {
+        if (run > 0)
+            run--;
+        else
+        {
+            unsigned char tag = data[pos++];
+            if (tag == 0xfe)
+                pixel[0] = data[pos], pixel[1] = data[pos + 1],
+                pixel[2] = data[pos + 2], pos += 3;
+            else if (tag == 0xff)
+                pixel = { data[pos], data[pos + 1], data[pos + 2], data[pos + 3] },
+                pos += 4;
+            else if ((tag & 0xc0) == 0x00)
+                pixel = index[tag];
+            else if ((tag & 0xc0) == 0x40)
+            {
+                pixel[0] += ((tag >> 4) & 3) - 2;
+                pixel[1] += ((tag >> 2) & 3) - 2;
+                pixel[2] += (tag & 3) - 2;
+            }
+            else if ((tag & 0xc0) == 0x80)
+            {
+                unsigned char next = data[pos++];
+                int dg = (tag & 0x3f) - 32;
+                pixel[0] += dg - 8 + ((next >> 4) & 0xf);
+                pixel[1] += dg;
+                pixel[2] += dg - 8 + (next & 0xf);
+            }
+            else
+                run = tag & 0x3f;
+            index[(pixel[0] * 3 + pixel[1] * 5 + pixel[2] * 7 + pixel[3] * 11) % 64] = pixel;
+        }
+        pixels.insert(pixels.end(), pixel.begin(), pixel.begin() + channelNum);
+    }
+    return pixels;
+}
+
+TEST_CASE("QOI-RoundTrip")
+{
+    const int width = 37, height = 23;
+    std::mt19937 engine{ 42 };
+    std::uniform_int_distribution<int> distribution{ 0, 255 };
+
+    for (int channelNum : { 3, 4 })
+    {
+        std::vector<unsigned char> pixels(width * height * channelNum);
+        // Mix noise, gradient and flat region to cover all ops.
+        for (size_t i = 0; i < pixels.size(); i++)
+        {
+            if (i < pixels.size() / 3)
+                pixels[i] = static_cast<unsigned char>(distribution(engine));
+            else if (i < pixels.size() * 2 / 3)
+                pixels[i] = static_cast<unsigned char>(i / channelNum % 200);
+            else
+                pixels[i] = 77;
+        }
+
+        auto encoded = EncodeQOI({ pixels.data(), width, height, channelNum });
+        REQUIRE(encoded.size() > 22);
+        REQUIRE(encoded[0] == 'q');
+        REQUIRE(encoded.back() == 1);
+
+        int decodedWidth, decodedHeight, decodedChannelNum;
+        auto decoded = DecodeQOI(encoded, decodedWidth, decodedHeight,
+            decodedChannelNum);
+        REQUIRE(decodedWidth == width);
+        REQUIRE(decodedHeight == height);
+        REQUIRE(decodedChannelNum == channelNum);
+        REQUIRE(decoded == pixels);
+    }
+}
+
+TEST_CASE("QOI-Flip")
+{
+    const std::vector<unsigned char> pixels{ 1, 2, 3, 4, 5, 6 };
+    auto encoded = EncodeQOI({ pixels.data(), 1, 2, 3, true });
+    int width, height, channelNum;
+    auto decoded = DecodeQOI(encoded, width, height, channelNum);
+    REQUIRE(decoded == std::vector<unsigned char>{ 4, 5, 6, 1, 2, 3 });
+}
+
+TEST_CASE("QOI-Black-After-Other-Color")
+{
+    // Opaque black hashes to a slot that a spec decoder holds as transparent
+    // black, so it shouldn't be encoded as an index before it's seen.
+    const std::vector<unsigned char> pixels{
+        255, 0, 0,  0, 0, 0,  128, 128, 128,  255, 0, 0,  128, 128, 128
+    };
+    auto encoded = EncodeQOI({ pixels.data(), 5, 1, 3 });
+    int width, height, channelNum;
+    auto decoded = DecodeQOI(encoded, width, height, channelNum);
+    REQUIRE(decoded == pixels);
+}
+
+TEST_CASE("QOI-UnsupportedChannel")
+{
+    const std::vector<unsigned char> pixels{ 1, 2 };
+    REQUIRE(EncodeQOI({ pixels.data(), 1, 1, 2 }).empty());
+}
@@ -0,0 +1,401 @@
+#include "PNGEncoder.h"
+#include "../IO/IOExtension.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <thread>
+
+namespace OpenGLFramework::ImageExtension
+{
+
+static constexpr int c_minMatchLen = 3;
+static constexpr int c_maxMatchLen = 258;
+static constexpr int c_windowSize = 32768;
+static constexpr int c_hashBits = 15;
+static constexpr int c_maxChainLen = 16;
+static constexpr int c_minBandRows = 16;
+
+static const std::array<std::uint32_t, 256> c_crcTable = []() {
+    std::array<std::uint32_t, 256> table{};
+    for (std::uint32_t i = 0; i < 256; i++)
+    {
+        std::uint32_t crc = i;
+        for (int k = 0; k < 8; k++)
+            crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+        table[i] = crc;
+    }
+    return table;
+}();
+
+static std::uint32_t GetCRC32(const unsigned char* data, size_t len,
+    std::uint32_t crc = 0)
+{
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++)
+        crc = c_crcTable[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+static constexpr std::uint32_t c_adlerBase = 65521;
+
+static std::uint32_t GetAdler32(const unsigned char* data, size_t len)
+{
+    std::uint32_t a = 1, b = 0;
+    while (len > 0)
+    {
+        // 5552 is the largest n that b can't overflow before modulo.
+        const size_t blockLen = std::min<size_t>(len, 5552);
+        for (size_t i = 0; i < blockLen; i++)
+            a += data[i], b += a;
+        a %= c_adlerBase, b %= c_adlerBase;
+        data += blockLen, len -= blockLen;
+    }
+    return b << 16 | a;
+}
+
+// Same as adler32_combine of zlib, i.e. adler32 of concatenation.
+static std::uint32_t CombineAdler32(std::uint32_t adler1, std::uint32_t adler2,
+    size_t len2)
+{
+    const std::uint32_t remainder = static_cast<std::uint32_t>(len2 % c_adlerBase);
+    std::uint32_t sum1 = adler1 & 0xffff;
+    std::uint32_t sum2 = (remainder * sum1) % c_adlerBase;
+    sum1 += (adler2 & 0xffff) + c_adlerBase - 1;
+    sum2 += (adler1 >> 16) + (adler2 >> 16) + c_adlerBase - remainder;
+    if (sum1 >= c_adlerBase) sum1 -= c_adlerBase;
+    if (sum1 >= c_adlerBase) sum1 -= c_adlerBase;
+    if (sum2 >= 2 * c_adlerBase) sum2 -= 2 * c_adlerBase;
+    if (sum2 >= c_adlerBase) sum2 -= c_adlerBase;
+    return sum2 << 16 | sum1;
+}
+
+class BitWriter
+{
+public:
+    explicit BitWriter(std::vector<unsigned char>& output) : output_{ output } {}
+
+    // Bits are packed from LSB, see RFC 1951 3.1.1.
+    void Write(std::uint32_t bits, int bitNum) {
+        buffer_ |= static_cast<std::uint64_t>(bits) << bitNum_;
+        bitNum_ += bitNum;
+        while (bitNum_ >= 8)
+        {
+            output_.push_back(static_cast<unsigned char>(buffer_));
+            buffer_ >>= 8, bitNum_ -= 8;
+        }
+        return;
+    }
+
+    void AlignToByte() {
+        if (bitNum_ > 0)
+            Write(0, 8 - bitNum_);
+        return;
+    }
+
+private:
+    std::vector<unsigned char>& output_;
+    std::uint64_t buffer_ = 0;
+    int bitNum_ = 0;
+};
+
+struct HuffmanCode { std::uint16_t code; std::uint8_t len; };
+
+// Huffman codes are packed from MSB, so they're reversed in advance.
+static std::uint16_t ReverseBits(std::uint16_t code, int len)
+{
+    std::uint16_t result = 0;
+    for (int i = 0; i < len; i++, code >>= 1)
+        result = static_cast<std::uint16_t>(result << 1 | (code & 1));
+    return result;
+}
+
+static const std::array<HuffmanCode, 288> c_fixedLiteralCodes = []() {
+    std::array<HuffmanCode, 288> codes{};
+    for (int i = 0; i < 288; i++)
+    {
+        if (i < 144)
+            codes[i] = { ReverseBits(0x30 + i, 8), 8 };
+        else if (i < 256)
+            codes[i] = { ReverseBits(0x190 + i - 144, 9), 9 };
+        else if (i < 280)
+            codes[i] = { ReverseBits(i - 256, 7), 7 };
+        else
+            codes[i] = { ReverseBits(0xC0 + i - 280, 8), 8 };
+    }
+    return codes;
+}();
+
+static constexpr std::array<int, 29> c_lengthBases{
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static constexpr std::array<int, 29> c_lengthExtraBits{
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static constexpr std::array<int, 30> c_distanceBases{
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289,
+    16385, 24577
+};
+static constexpr std::array<int, 30> c_distanceExtraBits{
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+static void WriteMatch(BitWriter& writer, int length, int distance)
+{
+    const int lengthIdx = static_cast<int>(std::upper_bound(c_lengthBases.begin(),
+        c_lengthBases.end(), length) - c_lengthBases.begin()) - 1;
+    const auto& lengthCode = c_fixedLiteralCodes[257 + lengthIdx];
+    writer.Write(lengthCode.code, lengthCode.len);
+    writer.Write(length - c_lengthBases[lengthIdx], c_lengthExtraBits[lengthIdx]);
+
+    const int distanceIdx = static_cast<int>(std::upper_bound(
+        c_distanceBases.begin(), c_distanceBases.end(), distance) -
+        c_distanceBases.begin()) - 1;
+    writer.Write(ReverseBits(static_cast<std::uint16_t>(distanceIdx), 5), 5);
+    writer.Write(distance - c_distanceBases[distanceIdx],
+        c_distanceExtraBits[distanceIdx]);
+    return;
+}
+
+static std::uint32_t GetHash(const unsigned char* data)
+{
+    const std::uint32_t value = data[0] | data[1] << 8 | data[2] << 16;
+    return (value * 2654435761u) >> (32 - c_hashBits);
+}
+
+// One non-final fixed Huffman block with greedy LZ77, ended by sync flush.
+static void DeflateBand(const std::vector<unsigned char>& data,
+    std::vector<unsigned char>& output)
+{
+    BitWriter writer{ output };
+    writer.Write(0, 1); // BFINAL
+    writer.Write(1, 2); // BTYPE = fixed Huffman
+
+    std::vector<int> head(1 << c_hashBits, -1), prev(c_windowSize, -1);
+    const int len = static_cast<int>(data.size());
+    auto insert = [&](int pos) {
+        const auto hash = GetHash(data.data() + pos);
+        prev[pos % c_windowSize] = head[hash];
+        head[hash] = pos;
+    };
+
+    int pos = 0;
+    while (pos < len)
+    {
+        int bestLen = 0, bestDistance = 0;
+        if (pos + c_minMatchLen <= len)
+        {
+            const int maxLen = std::min(c_maxMatchLen, len - pos);
+            int candidate = head[GetHash(data.data() + pos)];
+            for (int chain = 0; chain < c_maxChainLen && candidate >= 0 &&
+                pos - candidate <= c_windowSize; chain++)
+            {
+                if (data[candidate + bestLen] == data[pos + bestLen])
+                {
+                    int matchLen = 0;
+                    while (matchLen < maxLen &&
+                        data[candidate + matchLen] == data[pos + matchLen])
+                        matchLen++;
+                    if (matchLen > bestLen)
+                    {
+                        bestLen = matchLen, bestDistance = pos - candidate;
+                        if (matchLen == maxLen)
+                            break;
+                    }
+                }
+                const int next = prev[candidate % c_windowSize];
+                // Slot may have been overwritten by a newer position.
+                if (next >= candidate)
+                    break;
+                candidate = next;
+            }
+        }
+
+        if (bestLen >= c_minMatchLen)
+        {
+            WriteMatch(writer, bestLen, bestDistance);
+            const int end = std::min(pos + bestLen, len - c_minMatchLen + 1);
+            for (int i = pos; i < end; i++)
+                insert(i);
+            pos += bestLen;
+        }
+        else
+        {
+            const auto& code = c_fixedLiteralCodes[data[pos]];
+            writer.Write(code.code, code.len);
+            if (pos + c_minMatchLen <= len)
+                insert(pos);
+            pos++;
+        }
+    }
+
+    const auto& endOfBlock = c_fixedLiteralCodes[256];
+    writer.Write(endOfBlock.code, endOfBlock.len);
+    // Sync flush, i.e. an empty stored block, makes the band byte-aligned.
+    writer.Write(0, 3);
+    writer.AlignToByte();
+    output.insert(output.end(), { 0x00, 0x00, 0xFF, 0xFF });
+    return;
+}
+
+static unsigned char PaethPredictor(int a, int b, int c)
+{
+    const int p = a + b - c;
+    const int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc)
+        return static_cast<unsigned char>(a);
+    return static_cast<unsigned char>(pb <= pc ? b : c);
+}
+
+// Choose the filter with minimum sum of absolute difference for every row,
+// the same heuristic as libpng and stb_image_write.
+static void FilterRow(const unsigned char* curr, const unsigned char* prev,
+    int rowSize, int bytesPerPixel, unsigned char* dst,
+    std::array<std::vector<unsigned char>, 5>& candidates)
+{
+    int bestFilter = 0;
+    long long bestSum = std::numeric_limits<long long>::max();
+    for (int filter = 0; filter < 5; filter++)
+    {
+        auto& candidate = candidates[filter];
+        long long sum = 0;
+        for (int i = 0; i < rowSize; i++)
+        {
+            const int left = i >= bytesPerPixel ? curr[i - bytesPerPixel] : 0,
+                up = prev ? prev[i] : 0,
+                upLeft = (prev && i >= bytesPerPixel) ? prev[i - bytesPerPixel] : 0;
+            unsigned char predicted = 0;
+            switch (filter)
+            {
+            case 1: predicted = static_cast<unsigned char>(left); break;
+            case 2: predicted = static_cast<unsigned char>(up); break;
+            case 3: predicted = static_cast<unsigned char>((left + up) / 2); break;
+            case 4: predicted = PaethPredictor(left, up, upLeft); break;
+            default: break;
+            }
+            candidate[i] = static_cast<unsigned char>(curr[i] - predicted);
+            sum += std::abs(static_cast<signed char>(candidate[i]));
+        }
+        if (sum < bestSum)
+            bestSum = sum, bestFilter = filter;
+    }
+    dst[0] = static_cast<unsigned char>(bestFilter);
+    std::memcpy(dst + 1, candidates[bestFilter].data(), rowSize);
+    return;
+}
+
+static void PushBigEndian32(std::vector<unsigned char>& output, std::uint32_t value)
+{
+    output.push_back(static_cast<unsigned char>(value >> 24));
+    output.push_back(static_cast<unsigned char>(value >> 16));
+    output.push_back(static_cast<unsigned char>(value >> 8));
+    output.push_back(static_cast<unsigned char>(value));
+    return;
+}
+
+// Chunk is length + type + data + CRC of type and data.
+static void WriteChunk(std::vector<unsigned char>& output, const char* type,
+    const unsigned char* data, size_t len)
+{
+    PushBigEndian32(output, static_cast<std::uint32_t>(len));
+    const size_t typePos = output.size();
+    output.insert(output.end(), type, type + 4);
+    output.insert(output.end(), data, data + len);
+    PushBigEndian32(output, GetCRC32(output.data() + typePos, len + 4));
+    return;
+}
+
+struct PNGBand
+{
+    std::vector<unsigned char> chunk;
+    std::uint32_t adler;
+    size_t filteredSize;
+};
+
+std::vector<unsigned char> EncodePNG(const ImageView& image, int threadNum)
+{
+    static constexpr std::array<unsigned char, 5> c_colorTypes{ 0, 0, 4, 2, 6 };
+    if (image.channelNum < 1 || image.channelNum > 4) [[unlikely]]
+    {
+        IOExtension::LogError("PNG only supports 1 ~ 4 channels.");
+        return {};
+    }
+
+    if (threadNum <= 0)
+        threadNum = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const int bandNum = std::clamp(image.height / c_minBandRows, 1, threadNum);
+    const int rowSize = image.width * image.channelNum;
+
+    auto encodeBand = [&image, rowSize, bandNum](int band) {
+        const int beginRow = static_cast<int>(
+            static_cast<long long>(image.height) * band / bandNum);
+        const int endRow = static_cast<int>(
+            static_cast<long long>(image.height) * (band + 1) / bandNum);
+
+        // Filters only depend on raw pixels of the previous row, so bands
+        // are independent.
+        std::vector<unsigned char> filtered(
+            static_cast<size_t>(endRow - beginRow) * (rowSize + 1));
+        std::array<std::vector<unsigned char>, 5> candidates;
+        for (auto& candidate : candidates)
+            candidate.resize(rowSize);
+        for (int row = beginRow; row < endRow; row++)
+        {
+            FilterRow(image.GetRow(row), row == 0 ? nullptr : image.GetRow(row - 1),
+                rowSize, image.channelNum,
+                filtered.data() + static_cast<size_t>(row - beginRow) * (rowSize + 1),
+                candidates);
+        }
+
+        std::vector<unsigned char> deflated;
+        deflated.reserve(filtered.size() / 2);
+        if (band == 0)
+            deflated.insert(deflated.end(), { 0x78, 0x01 }); // zlib header.
+        DeflateBand(filtered, deflated);
+
+        PNGBand result{ {}, GetAdler32(filtered.data(), filtered.size()),
+            filtered.size() };
+        WriteChunk(result.chunk, "IDAT", deflated.data(), deflated.size());
+        return result;
+    };
+
+    std::vector<std::future<PNGBand>> futures;
+    for (int band = 1; band < bandNum; band++)
+        futures.push_back(std::async(std::launch::async, encodeBand, band));
+    std::vector<PNGBand> bands;
+    bands.push_back(encodeBand(0));
+    for (auto& future : futures)
+        bands.push_back(future.get());
+
+    std::vector<unsigned char> output{ 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    std::vector<unsigned char> header;
+    PushBigEndian32(header, image.width);
+    PushBigEndian32(header, image.height);
+    header.insert(header.end(), { 8, c_colorTypes[image.channelNum], 0, 0, 0 });
+    WriteChunk(output, "IHDR", header.data(), header.size());
+
+    std::uint32_t adler = 1;
+    for (const auto& band : bands)
+    {
+        output.insert(output.end(), band.chunk.begin(), band.chunk.end());
+        adler = CombineAdler32(adler, band.adler, band.filteredSize);
+    }
+
+    // Final empty fixed Huffman block(BFINAL = 1, BTYPE = 01, end of block),
+    // then adler32 of all filtered data.
+    std::vector<unsigned char> tail{ 0x03, 0x00 };
+    PushBigEndian32(tail, adler);
+    WriteChunk(output, "IDAT", tail.data(), tail.size());
+    WriteChunk(output, "IEND", nullptr, 0);
+    return output;
+}
+
+} // namespace OpenGLFramework::ImageExtension
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "ImageEncoder.h"
+
+#include <vector>
+
+namespace OpenGLFramework::ImageExtension
+{
+
+// Rows are split into bands which are filtered and deflated concurrently.
+// Every band ends with a sync flush so that they're byte-aligned and can be
+// concatenated into one zlib stream; each band is written as its own IDAT
+// chunk. Like stb_image_write, LZ77 with fixed Huffman codes is used.
+// threadNum = 0 means using all hardware threads; callers already running on
+// worker threads should pass 1 so as not to oversubscribe CPU.
+std::vector<unsigned char> EncodePNG(const ImageView& image, int threadNum = 0);
+
+} // namespace OpenGLFramework::ImageExtension
@@ -0,0 +1,99 @@
+#include "PNGEncoder.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+
+#include <random>
+
+using namespace OpenGLFramework::ImageExtension;
+
+// Noise on the top and smooth gradient below, which is roughly like a frame
+// with a detailed model in front of a sky.
+static std::vector<unsigned char> GenerateImage(int width, int height,
+    int channelNum)
+{
+    std::vector<unsigned char> pixels(
+        static_cast<size_t>(width) * height * channelNum);
+    std::mt19937 engine{ 42 };
+    std::uniform_int_distribution<int> distribution{ 0, 255 };
+    for (int row = 0; row < height; row++)
+    {
+        for (int col = 0; col < width; col++)
+        {
+            for (int channel = 0; channel < channelNum; channel++)
+            {
+                auto& pixel = pixels[(static_cast<size_t>(row) * width + col)
+                    * channelNum + channel];
+                pixel = static_cast<unsigned char>(row < height / 3 ?
+                    distribution(engine) : (col + row * channel) / 8);
+            }
+        }
+    }
+    return pixels;
+}
+
+TEST_CASE("PNG-RoundTrip")
+{
+    for (int channelNum = 1; channelNum <= 4; channelNum++)
+    {
+        const int width = 173, height = 97;
+        auto pixels = GenerateImage(width, height, channelNum);
+        for (int threadNum : { 1, 4 })
+        {
+            for (bool flip : { false, true })
+            {
+                auto png = EncodePNG({ pixels.data(), width, height, channelNum,
+                    flip }, threadNum);
+                int decodedWidth, decodedHeight, decodedChannelNum;
+                stbi_set_flip_vertically_on_load(flip);
+                auto decoded = stbi_load_from_memory(png.data(),
+                    static_cast<int>(png.size()), &decodedWidth, &decodedHeight,
+                    &decodedChannelNum, 0);
+                stbi_set_flip_vertically_on_load(false);
+
+                REQUIRE(decoded != nullptr);
+                REQUIRE(decodedWidth == width);
+                REQUIRE(decodedHeight == height);
+                REQUIRE(decodedChannelNum == channelNum);
+                REQUIRE(std::equal(pixels.begin(), pixels.end(), decoded));
+                stbi_image_free(decoded);
+            }
+        }
+    }
+}
+
+static void WriteToVector(void* context, void* data, int size)
+{
+    auto& output = *static_cast<std::vector<unsigned char>*>(context);
+    auto bytes = static_cast<unsigned char*>(data);
+    output.insert(output.end(), bytes, bytes + size);
+}
+
+TEST_CASE("PNG-Benchmark")
+{
+    for (auto [width, height] : { std::pair{ 1920, 1080 }, std::pair{ 3840, 2160 } })
+    {
+        auto pixels = GenerateImage(width, height, 3);
+        const auto name = std::to_string(width) + "x" + std::to_string(height);
+
+        BENCHMARK("stbi_write_png " + name) {
+            std::vector<unsigned char> output;
+            stbi_write_png_to_func(WriteToVector, &output, width, height, 3,
+                pixels.data(), width * 3);
+            return output.size();
+        };
+
+        BENCHMARK("EncodePNG " + name) {
+            return EncodePNG({ pixels.data(), width, height, 3 }).size();
+        };
+
+        BENCHMARK("EncodeQOI " + name) {
+            return EncodeQOI({ pixels.data(), width, height, 3 }).size();
+        };
+    }
+}
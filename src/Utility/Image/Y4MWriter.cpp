@@ -0,0 +1,87 @@
+#include "Y4MWriter.h"
+#include "../IO/IOExtension.h"
+
+#include <algorithm>
+#include <string>
+
+namespace OpenGLFramework::ImageExtension
+{
+
+static unsigned char ClampToByte(int value)
+{
+    return static_cast<unsigned char>(std::clamp(value, 0, 255));
+}
+
+Y4MWriter::Y4MWriter(const std::filesystem::path& path, int width, int height,
+    int fps) : fout_{ path, std::ios::binary }, width_{ width }, height_{ height }
+{
+    if (!fout_.is_open()) [[unlikely]]
+    {
+        IOExtension::LogError("Fail to open video stream at path " + path.string());
+        return;
+    }
+    fout_ << "YUV4MPEG2 W" << width << " H" << height << " F" << fps
+          << ":1 Ip A1:1 C420jpeg\n";
+    return;
+}
+
+std::vector<unsigned char> Y4MWriter::ConvertFrame(const ImageView& image) const
+{
+    if (image.width != width_ || image.height != height_ ||
+        image.channelNum < 3) [[unlikely]]
+    {
+        IOExtension::LogError("Frame doesn't match the video stream.");
+        return {};
+    }
+
+    const int chromaWidth = (width_ + 1) / 2, chromaHeight = (height_ + 1) / 2;
+    const size_t lumaSize = static_cast<size_t>(width_) * height_,
+        chromaSize = static_cast<size_t>(chromaWidth) * chromaHeight;
+    std::vector<unsigned char> frame(lumaSize + chromaSize * 2);
+
+    unsigned char* lumaPlane = frame.data();
+    unsigned char* cbPlane = lumaPlane + lumaSize;
+    unsigned char* crPlane = cbPlane + chromaSize;
+
+    // Fixed point(8-bit fraction) BT.601 coefficients.
+    for (int row = 0; row < height_; row++)
+    {
+        const unsigned char* src = image.GetRow(row);
+        unsigned char* dst = lumaPlane + static_cast<size_t>(row) * width_;
+        for (int col = 0; col < width_; col++, src += image.channelNum)
+            dst[col] = ClampToByte(((66 * src[0] + 129 * src[1] + 25 * src[2]
+                + 128) >> 8) + 16);
+    }
+
+    // Chroma is averaged on every 2x2 block.
+    for (int row = 0; row < chromaHeight; row++)
+    {
+        const unsigned char* upper = image.GetRow(2 * row);
+        const unsigned char* lower = image.GetRow(std::min(2 * row + 1, height_ - 1));
+        for (int col = 0; col < chromaWidth; col++)
+        {
+            const int left = 2 * col * image.channelNum,
+                right = std::min(2 * col + 1, width_ - 1) * image.channelNum;
+            int r = 0, g = 0, b = 0;
+            for (auto pixel : { upper + left, upper + right, lower + left, lower + right })
+                r += pixel[0], g += pixel[1], b += pixel[2];
+            r = (r + 2) / 4, g = (g + 2) / 4, b = (b + 2) / 4;
+
+            const size_t idx = static_cast<size_t>(row) * chromaWidth + col;
+            cbPlane[idx] = ClampToByte(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            crPlane[idx] = ClampToByte(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+    return frame;
+}
+
+void Y4MWriter::WriteConvertedFrame(const std::vector<unsigned char>& frame)
+{
+    if (frame.empty()) [[unlikely]]
+        return;
+    fout_ << "FRAME\n";
+    fout_.write(reinterpret_cast<const char*>(frame.data()), frame.size());
+    return;
+}
+
+} // namespace OpenGLFramework::ImageExtension
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "ImageEncoder.h"
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace OpenGLFramework::ImageExtension
+{
+
+// Raw YUV4MPEG2 stream with 4:2:0 chroma, which can be read by ffmpeg and
+// most players directly. Frames are converted by BT.601 limited range.
+class Y4MWriter
+{
+public:
+    Y4MWriter(const std::filesystem::path& path, int width, int height,
+        int fps);
+    bool IsOpen() const { return fout_.is_open() && fout_.good(); }
+    int GetWidth() const { return width_; }
+    int GetHeight() const { return height_; }
+
+    // Conversion is independent of the stream, so that it can be done on
+    // multiple threads; image size should be same as the stream.
+    std::vector<unsigned char> ConvertFrame(const ImageView& image) const;
+    void WriteConvertedFrame(const std::vector<unsigned char>& frame);
+    void WriteFrame(const ImageView& image) {
+        WriteConvertedFrame(ConvertFrame(image));
+    }
+
+private:
+    std::ofstream fout_;
+    int width_;
+    int height_;
+};
+
+} // namespace OpenGLFramework::ImageExtension
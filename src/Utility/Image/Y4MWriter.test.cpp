@@ -0,0 +1,41 @@
+#include "Y4MWriter.h"
+#include "../IO/IOExtension.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+
+using namespace OpenGLFramework::ImageExtension;
+
+TEST_CASE("Y4M-Stream")
+{
+    std::filesystem::path path = "Y4MWriter.test.y4m";
+    const int width = 5, height = 3;
+    std::vector<unsigned char> white(width * height * 3, 255),
+        black(width * height * 3, 0);
+    {
+        Y4MWriter writer{ path, width, height, 30 };
+        REQUIRE(writer.IsOpen());
+        writer.WriteFrame({ white.data(), width, height, 3 });
+        writer.WriteFrame({ black.data(), width, height, 3 });
+        // Size mismatch is rejected.
+        writer.WriteFrame({ black.data(), width - 1, height, 3 });
+    }
+
+    auto content = OpenGLFramework::IOExtension::ReadAll(path);
+    std::string header = "YUV4MPEG2 W5 H3 F30:1 Ip A1:1 C420jpeg\n";
+    REQUIRE(content.starts_with(header));
+
+    const size_t lumaSize = width * height, chromaSize = 3 * 2;
+    const size_t frameSize = 6 + lumaSize + chromaSize * 2;
+    REQUIRE(content.size() == header.size() + frameSize * 2);
+
+    auto firstFrame = content.substr(header.size(), frameSize);
+    REQUIRE(firstFrame.starts_with("FRAME\n"));
+    REQUIRE(static_cast<unsigned char>(firstFrame[6]) == 235);
+    REQUIRE(static_cast<unsigned char>(firstFrame[6 + lumaSize]) == 128);
+
+    auto secondFrame = content.substr(header.size() + frameSize, frameSize);
+    REQUIRE(static_cast<unsigned char>(secondFrame[6]) == 16);
+    REQUIRE(static_cast<unsigned char>(secondFrame.back()) == 128);
+}
@@ -5,6 +5,7 @@
 #include <locale>
 #include <string>
 #include <string_view>
+#include <cstdint>
 
 namespace OpenGLFramework::StringExtension {
 
@@ -73,4 +74,16 @@ StringType Trim(const StringType& str)
     return str.substr(beginPos, endPos - beginPos);
 }
 
+// 64-bit FNV-1a, which is simple enough to be evaluated at compile time.
+constexpr std::uint64_t HashFNV1a(std::string_view str)
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char ch : str)
+    {
+        hash ^= static_cast<unsigned char>(ch);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
 } // namespace OpenGLFramework::StringExtension
@@ -81,4 +81,14 @@ TEST_CASE("Trim")
     REQUIRE(Trim(u8testStr) == u8"我不如李us、刘神和刘圣学习好 .");
     REQUIRE(TrimBegin(u8testStr) == u8"我不如李us、刘神和刘圣学习好 . \t  ");
     REQUIRE(TrimEnd(u8testStr) == u8"  \t  我不如李us、刘神和刘圣学习好 .");
-}
\ No newline at end of file
+}
+TEST_CASE("HashFNV1aTest")
+{
+    static_assert(HashFNV1a("") == 0xcbf29ce484222325ull);
+    static_assert(HashFNV1a("a") == 0xaf63dc4c8601ec8cull);
+    static_assert(HashFNV1a("foobar") == 0x85944171f73967e8ull);
+
+    std::string runtimeStr = "model";
+    REQUIRE(HashFNV1a(runtimeStr) == HashFNV1a("model"));
+    REQUIRE(HashFNV1a("view") != HashFNV1a("model"));
+}
@@ -0,0 +1,232 @@
+#include "JobSystem.h"
+
+namespace OpenGLFramework::Threading
+{
+
+struct JobSystem::Task_
+{
+    Job job;
+    // Dependencies not finished yet, plus one released after scheduling.
+    std::atomic<size_t> unresolvedNum = 1;
+    std::atomic<bool> finished = false;
+    std::mutex successorMutex;
+    std::vector<std::shared_ptr<Task_>> successors;
+};
+
+// Which job system the current thread works for and the index of its queue.
+static thread_local const JobSystem* s_currentJobSystem = nullptr;
+static thread_local size_t s_currentQueueIndex = 0;
+
+bool JobSystem::TaskHandle::IsFinished() const
+{
+    return task_ == nullptr || task_->finished.load(std::memory_order_acquire);
+}
+
+JobSystem::JobSystem(int workerNum)
+{
+    if (workerNum <= 0)
+        workerNum = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+
+    for (int i = 0; i <= workerNum; i++)
+        queues_.push_back(std::make_unique<Queue_>());
+    threads_.reserve(workerNum);
+    for (int i = 0; i < workerNum; i++)
+    {
+        threads_.emplace_back([this, i](std::stop_token token) {
+            WorkerLoop_(token, static_cast<size_t>(i));
+        });
+    }
+    return;
+}
+
+JobSystem::~JobSystem()
+{
+    for (auto& thread : threads_)
+        thread.request_stop();
+    {
+        std::scoped_lock lock{ sleepMutex_ };
+    }
+    wakeUp_.notify_all();
+    threads_.clear();
+    return;
+}
+
+JobSystem& JobSystem::GetInstance()
+{
+    static JobSystem jobSystem{};
+    return jobSystem;
+}
+
+JobSystem::TaskHandle JobSystem::Schedule(Job job,
+    std::span<const TaskHandle> dependencies)
+{
+    auto task = std::make_shared<Task_>();
+    task->job = std::move(job);
+    for (const auto& dependency : dependencies)
+    {
+        if (!dependency.IsValid())
+            continue;
+        auto& predecessor = *dependency.task_;
+        std::scoped_lock lock{ predecessor.successorMutex };
+        if (predecessor.finished.load(std::memory_order_relaxed))
+            continue;
+        task->unresolvedNum.fetch_add(1, std::memory_order_relaxed);
+        predecessor.successors.push_back(task);
+    }
+
+    if (task->unresolvedNum.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        Push_(task);
+    return TaskHandle{ std::move(task) };
+}
+
+void JobSystem::Wait(const TaskHandle& task)
+{
+    const size_t queueIndex = GetQueueIndex_();
+    while (!task.IsFinished())
+    {
+        if (!RunOne_(queueIndex))
+            std::this_thread::yield();
+    }
+    return;
+}
+
+void JobSystem::ParallelForChunks_(size_t chunkNum,
+    std::function<void(size_t)> chunkFunc)
+{
+    // Helpers may start after all chunks are done, so the state is shared.
+    struct State
+    {
+        std::function<void(size_t)> chunkFunc;
+        size_t chunkNum;
+        std::atomic<size_t> nextChunk = 0;
+        std::atomic<size_t> finishedChunkNum = 0;
+    };
+    auto state = std::make_shared<State>(std::move(chunkFunc), chunkNum);
+    auto runChunks = [](State& state) {
+        for (size_t chunk = state.nextChunk.fetch_add(1, std::memory_order_relaxed);
+            chunk < state.chunkNum;
+            chunk = state.nextChunk.fetch_add(1, std::memory_order_relaxed))
+        {
+            state.chunkFunc(chunk);
+            state.finishedChunkNum.fetch_add(1, std::memory_order_release);
+        }
+    };
+
+    const size_t helperNum = std::min(chunkNum - 1, threads_.size());
+    for (size_t i = 0; i < helperNum; i++)
+        Schedule([state, runChunks]() { runChunks(*state); });
+    runChunks(*state);
+
+    // Chunks claimed by others may still be running.
+    const size_t queueIndex = GetQueueIndex_();
+    while (state->finishedChunkNum.load(std::memory_order_acquire) != chunkNum)
+    {
+        if (!RunOne_(queueIndex))
+            std::this_thread::yield();
+    }
+    return;
+}
+
+size_t JobSystem::GetQueueIndex_() const
+{
+    return s_currentJobSystem == this ? s_currentQueueIndex : queues_.size() - 1;
+}
+
+void JobSystem::Push_(std::shared_ptr<Task_> task)
+{
+    // Counted ahead so that it never underflows when the task is stolen at
+    // once; workers seeing it early just look for tasks again.
+    queuedNum_.fetch_add(1, std::memory_order_release);
+    auto& queue = *queues_[GetQueueIndex_()];
+    {
+        std::scoped_lock lock{ queue.mutex };
+        queue.tasks.push_back(std::move(task));
+    }
+    // Sleeping workers check queuedNum_ with the mutex held, so wakeup
+    // can't be lost between their checking and waiting.
+    {
+        std::scoped_lock lock{ sleepMutex_ };
+    }
+    wakeUp_.notify_one();
+    return;
+}
+
+std::shared_ptr<JobSystem::Task_> JobSystem::Pop_(size_t queueIndex)
+{
+    // Own tasks are taken LIFO, which are more likely in cache; stolen ones
+    // are taken FIFO, which tend to be larger.
+    {
+        auto& queue = *queues_[queueIndex];
+        std::scoped_lock lock{ queue.mutex };
+        if (!queue.tasks.empty())
+        {
+            auto task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            return task;
+        }
+    }
+
+    for (size_t i = 1; i < queues_.size(); i++)
+    {
+        auto& queue = *queues_[(queueIndex + i) % queues_.size()];
+        std::scoped_lock lock{ queue.mutex };
+        if (!queue.tasks.empty())
+        {
+            auto task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+bool JobSystem::RunOne_(size_t queueIndex)
+{
+    if (queuedNum_.load(std::memory_order_acquire) == 0)
+        return false;
+    auto task = Pop_(queueIndex);
+    if (task == nullptr)
+        return false;
+    queuedNum_.fetch_sub(1, std::memory_order_relaxed);
+    Execute_(task);
+    return true;
+}
+
+void JobSystem::Execute_(const std::shared_ptr<Task_>& task)
+{
+    task->job();
+    task->job = nullptr;
+
+    std::vector<std::shared_ptr<Task_>> successors;
+    {
+        std::scoped_lock lock{ task->successorMutex };
+        task->finished.store(true, std::memory_order_release);
+        successors.swap(task->successors);
+    }
+    for (auto& successor : successors)
+    {
+        if (successor->unresolvedNum.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            Push_(std::move(successor));
+    }
+    return;
+}
+
+void JobSystem::WorkerLoop_(std::stop_token token, size_t queueIndex)
+{
+    s_currentJobSystem = this;
+    s_currentQueueIndex = queueIndex;
+    while (true)
+    {
+        if (RunOne_(queueIndex))
+            continue;
+
+        std::unique_lock lock{ sleepMutex_ };
+        // Remaining tasks are still run after stopping.
+        if (!wakeUp_.wait(lock, token, [this]() {
+            return queuedNum_.load(std::memory_order_acquire) != 0; }))
+            break;
+    }
+    return;
+}
+
+} // namespace OpenGLFramework::Threading
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace OpenGLFramework::Threading
+{
+
+// Work-stealing scheduler; every worker has its own deque, taking its newest
+// task first and stealing the oldest ones of others when it runs out. Tasks
+// scheduled by other threads are put into a shared deque.
+// Jobs shouldn't throw, and waiting threads run other tasks meanwhile, so
+// it's fine to wait in a job, e.g. for nested ParallelFor.
+class JobSystem
+{
+    struct Task_;
+public:
+    using Job = std::function<void(void)>;
+
+    class TaskHandle
+    {
+        friend class JobSystem;
+    public:
+        TaskHandle() = default;
+        bool IsValid() const { return task_ != nullptr; }
+        bool IsFinished() const;
+    private:
+        std::shared_ptr<Task_> task_;
+        explicit TaskHandle(std::shared_ptr<Task_> task) : task_{ std::move(task) } {}
+    };
+
+    // workerNum = 0 means a worker for each hardware thread except the
+    // current one, since waiting threads also run tasks.
+    explicit JobSystem(int workerNum = 0);
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    // Scheduled tasks are finished before destruction.
+    ~JobSystem();
+    static JobSystem& GetInstance();
+
+    // The job is run after all dependencies are finished.
+    TaskHandle Schedule(Job job, std::span<const TaskHandle> dependencies);
+    TaskHandle Schedule(Job job, std::initializer_list<TaskHandle> dependencies = {}) {
+        return Schedule(std::move(job), std::span{ dependencies.begin(), dependencies.size() });
+    }
+    // Run other tasks until the task is finished.
+    void Wait(const TaskHandle& task);
+
+    // func(i) is called for every i in [begin, end); the range is split into
+    // chunks of grainSize, which are claimed by the current thread and by
+    // helper tasks. grainSize = 0 means about 4 chunks per thread, while the
+    // cost of func should be considered for small ranges.
+    template<typename Func>
+    void ParallelFor(size_t begin, size_t end, Func&& func, size_t grainSize = 0)
+    {
+        if (begin >= end)
+            return;
+        const size_t size = end - begin;
+        if (grainSize == 0)
+            grainSize = std::max<size_t>(1, size / (GetThreadNum() * 4));
+        const size_t chunkNum = (size + grainSize - 1) / grainSize;
+        if (chunkNum == 1)
+        {
+            for (size_t i = begin; i < end; i++)
+                func(i);
+            return;
+        }
+        ParallelForChunks_(chunkNum, [&func, begin, end, grainSize](size_t chunk) {
+            const size_t chunkBegin = begin + chunk * grainSize;
+            const size_t chunkEnd = std::min(end, chunkBegin + grainSize);
+            for (size_t i = chunkBegin; i < chunkEnd; i++)
+                func(i);
+        });
+        return;
+    }
+
+    int GetWorkerNum() const { return static_cast<int>(threads_.size()); }
+    // Workers and the thread calling ParallelFor.
+    size_t GetThreadNum() const { return threads_.size() + 1; }
+
+private:
+    struct Queue_
+    {
+        std::mutex mutex;
+        std::deque<std::shared_ptr<Task_>> tasks;
+    };
+
+    // The last one is shared by threads other than workers.
+    std::vector<std::unique_ptr<Queue_>> queues_;
+    std::atomic<size_t> queuedNum_ = 0;
+    std::mutex sleepMutex_;
+    std::condition_variable_any wakeUp_;
+    std::vector<std::jthread> threads_;
+
+    void ParallelForChunks_(size_t chunkNum, std::function<void(size_t)> chunkFunc);
+    size_t GetQueueIndex_() const;
+    void Push_(std::shared_ptr<Task_> task);
+    std::shared_ptr<Task_> Pop_(size_t queueIndex);
+    bool RunOne_(size_t queueIndex);
+    void Execute_(const std::shared_ptr<Task_>& task);
+    void WorkerLoop_(std::stop_token token, size_t queueIndex);
+};
+
+using TaskHandle = JobSystem::TaskHandle;
+
+// ParallelFor on the default job system.
+template<typename Func>
+void ParallelFor(size_t begin, size_t end, Func&& func, size_t grainSize = 0)
+{
+    JobSystem::GetInstance().ParallelFor(begin, end, std::forward<Func>(func),
+        grainSize);
+    return;
+}
+
+} // namespace OpenGLFramework::Threading
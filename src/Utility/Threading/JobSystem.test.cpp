@@ -0,0 +1,198 @@
+#include "JobSystem.h"
+#include "../Image/PNGEncoder.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <array>
+#include <execution>
+#include <numeric>
+#include <random>
+#include <string>
+
+using namespace OpenGLFramework::Threading;
+
+TEST_CASE("Task-Dependencies")
+{
+    JobSystem jobSystem{ 3 };
+    std::mutex orderMutex;
+    std::vector<std::string> order;
+    auto record = [&](std::string name) {
+        return [&, name]() {
+            std::scoped_lock lock{ orderMutex };
+            order.push_back(name);
+        };
+    };
+
+    // Diamond: top -> left, right -> bottom.
+    auto top = jobSystem.Schedule(record("top"));
+    auto left = jobSystem.Schedule(record("left"), { top });
+    auto right = jobSystem.Schedule(record("right"), { top });
+    auto bottom = jobSystem.Schedule(record("bottom"), { left, right });
+    jobSystem.Wait(bottom);
+
+    REQUIRE(top.IsFinished());
+    REQUIRE(left.IsFinished());
+    REQUIRE(right.IsFinished());
+    REQUIRE(order.size() == 4);
+    REQUIRE(order.front() == "top");
+    REQUIRE(order.back() == "bottom");
+
+    // Finished or empty dependencies don't block.
+    auto last = jobSystem.Schedule(record("last"), { bottom, TaskHandle{} });
+    jobSystem.Wait(last);
+    REQUIRE(order.back() == "last");
+}
+
+TEST_CASE("Parallel-For")
+{
+    JobSystem jobSystem{ 3 };
+    constexpr size_t c_size = 10007;
+    for (size_t grainSize : { 0, 1, 64, 5000, 20000 })
+    {
+        std::vector<std::atomic<int>> visitNum(c_size);
+        jobSystem.ParallelFor(0, c_size, [&visitNum](size_t i) {
+            visitNum[i].fetch_add(1, std::memory_order_relaxed);
+        }, grainSize);
+        REQUIRE(std::ranges::all_of(visitNum, [](const auto& num) { return num == 1; }));
+    }
+
+    int callNum = 0;
+    jobSystem.ParallelFor(5, 5, [&callNum](size_t) { callNum++; });
+    REQUIRE(callNum == 0);
+}
+
+TEST_CASE("Wait-With-Help")
+{
+    // The only worker waits in a job, which is fine since waiting runs the
+    // tasks it waits for.
+    JobSystem jobSystem{ 1 };
+    std::atomic<size_t> sum = 0;
+    auto outer = jobSystem.Schedule([&]() {
+        jobSystem.ParallelFor(0, 64, [&](size_t i) {
+            jobSystem.ParallelFor(0, 64, [&sum, i](size_t j) { sum += i * 64 + j; }, 4);
+        }, 4);
+        auto inner = jobSystem.Schedule([&sum]() { sum += 1; });
+        jobSystem.Wait(inner);
+    });
+    jobSystem.Wait(outer);
+    REQUIRE(sum == 4096 * 4095 / 2 + 1);
+}
+
+// Bounding spheres against planes of the view frustum.
+static bool IsInFrustum(const std::array<glm::vec4, 6>& planes, const glm::vec4& sphere)
+{
+    return std::ranges::all_of(planes, [&sphere](const glm::vec4& plane) {
+        return glm::dot(glm::vec3{ plane }, glm::vec3{ sphere }) + plane.w >= -sphere.w;
+    });
+}
+
+static std::array<glm::vec4, 6> GetFrustumPlanes(const glm::mat4& viewProjection)
+{
+    std::array<glm::vec4, 6> planes;
+    for (int i = 0; i < 3; i++)
+    {
+        for (int sign = 0; sign < 2; sign++)
+        {
+            auto& plane = planes[i * 2 + sign];
+            for (int col = 0; col < 4; col++)
+            {
+                plane[col] = viewProjection[col][3] +
+                    (sign == 0 ? 1.0f : -1.0f) * viewProjection[col][i];
+            }
+        }
+    }
+    return planes;
+}
+
+TEST_CASE("Benchmark-Culling")
+{
+    constexpr size_t c_objectNum = 1 << 20;
+    std::mt19937 engine{ 42 };
+    std::uniform_real_distribution<float> position{ -200.0f, 200.0f },
+        radius{ 0.1f, 5.0f };
+    std::vector<glm::vec4> spheres(c_objectNum);
+    for (auto& sphere : spheres)
+        sphere = { position(engine), position(engine), position(engine), radius(engine) };
+
+    const auto planes = GetFrustumPlanes(
+        glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f) *
+        glm::lookAt(glm::vec3{ 0, 0, 0 }, glm::vec3{ 0, 0, -1 }, glm::vec3{ 0, 1, 0 }));
+    std::vector<char> visible(c_objectNum);
+    std::vector<size_t> indices(c_objectNum);
+    std::iota(indices.begin(), indices.end(), size_t{ 0 });
+
+    BENCHMARK("Serial")
+    {
+        for (size_t i = 0; i < c_objectNum; i++)
+            visible[i] = IsInFrustum(planes, spheres[i]);
+        return visible.back();
+    };
+
+    BENCHMARK("std::execution::par")
+    {
+        std::for_each(std::execution::par, indices.begin(), indices.end(),
+            [&](size_t i) { visible[i] = IsInFrustum(planes, spheres[i]); });
+        return visible.back();
+    };
+
+    BENCHMARK("ParallelFor")
+    {
+        ParallelFor(0, c_objectNum,
+            [&](size_t i) { visible[i] = IsInFrustum(planes, spheres[i]); });
+        return visible.back();
+    };
+}
+
+TEST_CASE("Benchmark-Texture-Decode")
+{
+    constexpr int c_textureNum = 32, c_size = 256;
+    std::mt19937 engine{ 42 };
+    std::uniform_int_distribution<int> distribution{ 0, 255 };
+    std::vector<std::vector<unsigned char>> files;
+    for (int i = 0; i < c_textureNum; i++)
+    {
+        std::vector<unsigned char> pixels(c_size * c_size * 3);
+        for (size_t j = 0; j < pixels.size(); j++)
+            pixels[j] = static_cast<unsigned char>(j % 7 == 0 ? distribution(engine) : j / 97);
+        files.push_back(OpenGLFramework::ImageExtension::EncodePNG(
+            { pixels.data(), c_size, c_size, 3 }, 1));
+    }
+
+    std::vector<size_t> decodedSizes(c_textureNum);
+    auto decode = [&](size_t i) {
+        int width, height, channelNum;
+        auto data = stbi_load_from_memory(files[i].data(),
+            static_cast<int>(files[i].size()), &width, &height, &channelNum, 0);
+        decodedSizes[i] = static_cast<size_t>(width) * height * channelNum;
+        stbi_image_free(data);
+    };
+    decode(0);
+    REQUIRE(decodedSizes[0] == c_size * c_size * 3);
+    std::vector<size_t> indices(c_textureNum);
+    std::iota(indices.begin(), indices.end(), size_t{ 0 });
+
+    BENCHMARK("Serial")
+    {
+        for (size_t i = 0; i < c_textureNum; i++)
+            decode(i);
+        return decodedSizes.back();
+    };
+
+    BENCHMARK("std::execution::par")
+    {
+        std::for_each(std::execution::par, indices.begin(), indices.end(), decode);
+        return decodedSizes.back();
+    };
+
+    BENCHMARK("ParallelFor")
+    {
+        ParallelFor(0, c_textureNum, decode, 1);
+        return decodedSizes.back();
+    };
+}
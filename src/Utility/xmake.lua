@@ -1,5 +1,6 @@
 target("OpenGLFrameworkUtility")
     set_kind("static")
-    add_deps("OpenGLFrameworkIO", "OpenGLFrameworkString", "OpenGLFrameworkGenerator")
+    add_deps("OpenGLFrameworkIO", "OpenGLFrameworkString", "OpenGLFrameworkGenerator",
+        "OpenGLFrameworkImage", "OpenGLFrameworkThreading")
 
-includes("IO", "String", "Generator", "GLHelper")
\ No newline at end of file
+includes("IO", "String", "Generator", "GLHelper", "Image", "Threading")
\ No newline at end of file